@@ -136,55 +136,75 @@ static void adjustRegionMMX(uint8_t *buf, uint8_t *end, const uint8_t *table,
 }
 #endif /* HAVE_MMX */
 
-static int adjustFilter (VideoFilter *vf, VideoFrame *frame, int field)
+/* Adjusts the rows first_row up to last_row of the luma plane, and the
+ * chroma rows that go with them. */
+static void adjustRows (ThisFilter *filter, VideoFrame *frame,
+                        int first_row, int last_row)
 {
-    (void)field;
-    ThisFilter *filter = (ThisFilter *) vf;
-    TF_VARS;
-
-    TF_START;
-    {
-        unsigned char *ybeg = frame->buf + frame->offsets[0];
-        unsigned char *yend = ybeg + (frame->pitches[0] * frame->height);
-        int cheight = (frame->codec == FMT_YV12) ?
-            (frame->height >> 1) : frame->height;
-        unsigned char *ubeg = frame->buf + frame->offsets[1];
-        unsigned char *uend = ubeg + (frame->pitches[1] * cheight);
-        unsigned char *vbeg = frame->buf + frame->offsets[2];
-        unsigned char *vend = ubeg + (frame->pitches[2] * cheight);
+    int cshift = (frame->codec == FMT_YV12) ? 1 : 0;
+    int cfirst = first_row >> cshift;
+    int clast  = last_row  >> cshift;
+    unsigned char *ybeg = frame->buf + frame->offsets[0] +
+        (frame->pitches[0] * first_row);
+    unsigned char *yend = frame->buf + frame->offsets[0] +
+        (frame->pitches[0] * last_row);
+    unsigned char *ubeg = frame->buf + frame->offsets[1] +
+        (frame->pitches[1] * cfirst);
+    unsigned char *uend = frame->buf + frame->offsets[1] +
+        (frame->pitches[1] * clast);
+    unsigned char *vbeg = frame->buf + frame->offsets[2] +
+        (frame->pitches[2] * cfirst);
+    unsigned char *vend = frame->buf + frame->offsets[2] +
+        (frame->pitches[2] * clast);
 
 #if HAVE_MMX
-        if (filter->yfilt)
-            adjustRegionMMX(ybeg, yend, filter->ytable,
-                            &(filter->yshift), &(filter->yscale),
-                            &(filter->ymin), mm_cpool + 1, mm_cpool + 2);
-        else
-            adjustRegion(ybeg, yend, filter->ytable);
-
-        if (filter->cfilt)
-        {
-            adjustRegionMMX(ubeg, uend, filter->ctable,
-                            &(filter->cshift), &(filter->cscale),
-                            &(filter->cmin), mm_cpool + 3, mm_cpool + 4);
-            adjustRegionMMX(vbeg, vend, filter->ctable,
-                            &(filter->cshift), &(filter->cscale),
-                            &(filter->cmin), mm_cpool + 3, mm_cpool + 4);
-        }
-        else
-        {
-            adjustRegion(ubeg, uend, filter->ctable);
-            adjustRegion(vbeg, vend, filter->ctable);
-        }
-
-        if (filter->yfilt || filter->cfilt)
-            emms();
-
-#else /* HAVE_MMX */
+    if (filter->yfilt)
+        adjustRegionMMX(ybeg, yend, filter->ytable,
+                        &(filter->yshift), &(filter->yscale),
+                        &(filter->ymin), mm_cpool + 1, mm_cpool + 2);
+    else
         adjustRegion(ybeg, yend, filter->ytable);
+
+    if (filter->cfilt)
+    {
+        adjustRegionMMX(ubeg, uend, filter->ctable,
+                        &(filter->cshift), &(filter->cscale),
+                        &(filter->cmin), mm_cpool + 3, mm_cpool + 4);
+        adjustRegionMMX(vbeg, vend, filter->ctable,
+                        &(filter->cshift), &(filter->cscale),
+                        &(filter->cmin), mm_cpool + 3, mm_cpool + 4);
+    }
+    else
+    {
         adjustRegion(ubeg, uend, filter->ctable);
         adjustRegion(vbeg, vend, filter->ctable);
-#endif /* HAVE_MMX */
     }
+
+    if (filter->yfilt || filter->cfilt)
+        emms();
+
+#else /* HAVE_MMX */
+    adjustRegion(ybeg, yend, filter->ytable);
+    adjustRegion(ubeg, uend, filter->ctable);
+    adjustRegion(vbeg, vend, filter->ctable);
+#endif /* HAVE_MMX */
+}
+
+static void adjustSlice (VideoFilter *vf, VideoFrame *frame, int field,
+                         int first_row, int last_row)
+{
+    (void)field;
+    adjustRows((ThisFilter *) vf, frame, first_row, last_row);
+}
+
+static int adjustFilter (VideoFilter *vf, VideoFrame *frame, int field)
+{
+    (void)field;
+    ThisFilter *filter = (ThisFilter *) vf;
+    TF_VARS;
+
+    TF_START;
+    adjustRows(filter, frame, 0, frame->height);
     TF_END(filter, "Adjust: ");
     return 0;
 }
@@ -319,7 +339,10 @@ ConstFilterInfo filter_table[] =
         name:       "adjust",
         descript:   "adjust range and gamma of video",
         formats:    FmtList,
-        libname:    NULL
+        libname:    NULL,
+        slice_begin: NULL,
+        slice:      &adjustSlice,
+        slice_overlap: 0
     },
     FILT_NULL
 };
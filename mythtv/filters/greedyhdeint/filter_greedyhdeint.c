@@ -256,7 +256,7 @@ static VideoFilter* GreedyHDeintFilter(VideoFrameType inpixfmt,
 
     init_yuv_conversion();
 #ifdef MMX
-    filter->mm_flags = av_get_cpu_flags();
+    filter->mm_flags = filter_cpu_flags();
     TF_INIT(filter);
 #else
     filter->mm_flags = 0;
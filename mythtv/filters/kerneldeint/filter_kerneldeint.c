@@ -208,6 +208,83 @@ static void line_filter_mmx(uint8_t *dst, int width, int start_width,
 }
 #endif
 
+#if HAVE_SSE2_INTRINSICS
+/* Filters 16 pixels, unlike the MMX version this gives exactly the same
+ * result as the C version, (4*src2 + 4*src4 + 2*src3 - src1 - src5) fits
+ * in a signed 16 bit word and packus does the clamping. */
+static inline __m128i sse2_kernel(__m128i s1, __m128i s2, __m128i s3,
+                                  __m128i s4, __m128i s5, __m128i *mask)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i thr  = _mm_set1_epi8(11);
+    __m128i lo, hi;
+
+    /* ABS(src3 - src2) > 11 */
+    __m128i diff = _mm_or_si128(_mm_subs_epu8(s3, s2), _mm_subs_epu8(s2, s3));
+    *mask = _mm_xor_si128(_mm_cmpeq_epi8(_mm_subs_epu8(diff, thr), zero),
+                          _mm_cmpeq_epi8(zero, zero));
+
+    lo = _mm_slli_epi16(_mm_add_epi16(_mm_unpacklo_epi8(s2, zero),
+                                      _mm_unpacklo_epi8(s4, zero)), 2);
+    hi = _mm_slli_epi16(_mm_add_epi16(_mm_unpackhi_epi8(s2, zero),
+                                      _mm_unpackhi_epi8(s4, zero)), 2);
+    lo = _mm_add_epi16(lo, _mm_slli_epi16(_mm_unpacklo_epi8(s3, zero), 1));
+    hi = _mm_add_epi16(hi, _mm_slli_epi16(_mm_unpackhi_epi8(s3, zero), 1));
+    lo = _mm_sub_epi16(lo, _mm_add_epi16(_mm_unpacklo_epi8(s1, zero),
+                                         _mm_unpacklo_epi8(s5, zero)));
+    hi = _mm_sub_epi16(hi, _mm_add_epi16(_mm_unpackhi_epi8(s1, zero),
+                                         _mm_unpackhi_epi8(s5, zero)));
+
+    return _mm_packus_epi16(_mm_srai_epi16(lo, 3), _mm_srai_epi16(hi, 3));
+}
+
+static void line_filter_sse2_fast(uint8_t *dst, int width, int start_width,
+                                  uint8_t *buf, uint8_t *src2, uint8_t *src3,
+                                  uint8_t *src4, uint8_t *src5)
+{
+    int X;
+    for (X = start_width; X < width - 15; X += 16)
+    {
+        __m128i mask;
+        __m128i s1  = _mm_loadu_si128((__m128i*)(buf  + X));
+        __m128i s3  = _mm_loadu_si128((__m128i*)(src3 + X));
+        __m128i res = sse2_kernel(s1, _mm_loadu_si128((__m128i*)(src2 + X)),
+                                  s3, _mm_loadu_si128((__m128i*)(src4 + X)),
+                                  _mm_loadu_si128((__m128i*)(src5 + X)),
+                                  &mask);
+        __m128i d   = _mm_loadu_si128((__m128i*)(dst  + X));
+        _mm_storeu_si128((__m128i*)(buf + X), s3);
+        _mm_storeu_si128((__m128i*)(dst + X),
+                         _mm_or_si128(_mm_and_si128(mask, res),
+                                      _mm_andnot_si128(mask, d)));
+    }
+
+    line_filter_c_fast(dst, width, X, buf, src2, src3, src4, src5);
+}
+
+static void line_filter_sse2(uint8_t *dst, int width, int start_width,
+                             uint8_t *src1, uint8_t *src2, uint8_t *src3,
+                             uint8_t *src4, uint8_t *src5)
+{
+    int X;
+    for (X = start_width; X < width - 15; X += 16)
+    {
+        __m128i mask;
+        __m128i s3  = _mm_loadu_si128((__m128i*)(src3 + X));
+        __m128i res = sse2_kernel(_mm_loadu_si128((__m128i*)(src1 + X)),
+                                  _mm_loadu_si128((__m128i*)(src2 + X)),
+                                  s3, _mm_loadu_si128((__m128i*)(src4 + X)),
+                                  _mm_loadu_si128((__m128i*)(src5 + X)),
+                                  &mask);
+        _mm_storeu_si128((__m128i*)(dst + X),
+                         _mm_or_si128(_mm_and_si128(mask, res),
+                                      _mm_andnot_si128(mask, s3)));
+    }
+
+    line_filter_c(dst, width, X, src1, src2, src3, src4, src5);
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
 static void store_ref(struct ThisFilter *p, uint8_t *src, int src_offsets[3],
                       int src_stride[3], int width, int height)
 {
@@ -561,13 +638,20 @@ static VideoFilter *NewKernelDeintFilter(VideoFrameType inpixfmt,
     filter->line_filter = &line_filter_c;
     filter->line_filter_fast = &line_filter_c_fast;
 #if HAVE_MMX
-    filter->mm_flags = av_get_cpu_flags();
+    filter->mm_flags = filter_cpu_flags();
     if (filter->mm_flags & FF_MM_MMX)
     {
         filter->line_filter = &line_filter_mmx;
         filter->line_filter_fast = &line_filter_mmx_fast;
     }
 #endif
+#if HAVE_SSE2_INTRINSICS
+    if (filter->mm_flags & FF_MM_SSE2)
+    {
+        filter->line_filter = &line_filter_sse2;
+        filter->line_filter_fast = &line_filter_sse2_fast;
+    }
+#endif
 
     filter->skipchroma   = 0;
     filter->width        = 0;
@@ -136,6 +136,63 @@ void linearBlend3DNow(unsigned char *src, int stride)
 
 #endif
 
+#if HAVE_SSE2_INTRINSICS
+
+/* Blends a 16 pixel wide column of 8 lines, the same way as linearBlendMMX.
+ * Like the MMX and Altivec versions both averages round up, so the result
+ * can be one more than the C version gives. */
+static inline void linearBlendSSE2(unsigned char *src, int stride)
+{
+    __m128i a, b, c;
+    int i;
+
+    b = _mm_loadu_si128((__m128i*)(src));
+    c = _mm_loadu_si128((__m128i*)(src + stride));
+
+    for (i = 2; i < 10; i++)
+    {
+        a = b;
+        b = c;
+        c = _mm_loadu_si128((__m128i*)(src + stride * i));
+        _mm_storeu_si128((__m128i*)(src + stride * (i - 2)),
+                         _mm_avg_epu8(_mm_avg_epu8(a, c), b));
+    }
+}
+
+static void linearBlendPlaneSSE2(unsigned char *plane, int stride, int ymax)
+{
+    int x, y;
+    for (y = 0; y < ymax; y += 8)
+    {
+        unsigned char *src = plane + y * stride;
+        for (x = 0; x < stride - 15; x += 16)
+            linearBlendSSE2(src + x, stride);
+        for (; x < stride; x += 8)
+            linearBlend(src + x, stride);
+    }
+}
+
+static int linearBlendFilterSSE2(VideoFilter *f, VideoFrame *frame, int field)
+{
+    (void)field;
+    (void)f;
+    TF_VARS;
+
+    TF_START;
+
+    linearBlendPlaneSSE2(frame->buf + frame->offsets[0], frame->pitches[0],
+                         frame->height - 8);
+    linearBlendPlaneSSE2(frame->buf + frame->offsets[1], frame->pitches[1],
+                         frame->height / 2 - 8);
+    linearBlendPlaneSSE2(frame->buf + frame->offsets[2], frame->pitches[2],
+                         frame->height / 2 - 8);
+
+    TF_END((LBFilter *)f, "LinearBlendSSE2: ");
+    return 0;
+}
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
 #if HAVE_ALTIVEC
 
 inline void linearBlendAltivec(unsigned char *src, int stride)
@@ -352,7 +409,12 @@ static VideoFilter *new_filter(VideoFrameType inpixfmt,
 
     filter->vf.filter = &linearBlendFilter;
     filter->subfilter = &linearBlend;    /* Default, non accellerated */
-    filter->mm_flags = av_get_cpu_flags();
+    filter->mm_flags = filter_cpu_flags();
+#if HAVE_SSE2_INTRINSICS
+    if (filter->mm_flags & FF_MM_SSE2)
+        filter->vf.filter = &linearBlendFilterSSE2;
+    else
+#endif
     if (HAVE_MMX && filter->mm_flags & FF_MM_MMXEXT)
         filter->subfilter = &linearBlendMMX;
     else if (HAVE_AMD3DNOW && filter->mm_flags & FF_MM_3DNOW)
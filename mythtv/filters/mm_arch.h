@@ -1,5 +1,11 @@
 /* mm_arch.h - Multi-media CPU acceleration for several architectures */
 
+#ifndef MM_ARCH_H
+#define MM_ARCH_H
+
+#include <stdlib.h>
+
+#include "mythconfig.h"
 #include "libavutil/mem.h"
 #include "libavcodec/dsputil.h"
 
@@ -14,3 +20,25 @@
 #else 
   #define emms()    ; 
 #endif
+
+/* SSE2 intrinsics are always available to x86-64 builds, and to x86 builds
+ * made with -msse2.  The kernels using them are still chosen at run time
+ * from filter_cpu_flags(), so the C versions can be compared against them. */
+#if HAVE_SSE && defined(__SSE2__)
+  #define HAVE_SSE2_INTRINSICS 1
+  #include <emmintrin.h>
+#else
+  #define HAVE_SSE2_INTRINSICS 0
+#endif
+
+/* CPU flags for choosing filter kernels.  Setting NO_FILTER_SIMD to a
+ * non-empty value forces the plain C kernels, for comparing outputs. */
+static inline int filter_cpu_flags(void)
+{
+    const char *nosimd = getenv("NO_FILTER_SIMD");
+    if (nosimd && *nosimd)
+        return 0;
+    return av_get_cpu_flags();
+}
+
+#endif /* MM_ARCH_H */
@@ -31,7 +31,6 @@
 
 #include <string.h>
 #include <math.h>
-#include <pthread.h>
 
 #include "filter.h"
 #include "frame.h"
@@ -52,26 +51,10 @@
 
 static void* (*fast_memcpy)(void * to, const void * from, size_t len);
 
-struct DeintThread
-{
-    int       ready;
-    pthread_t id;
-    int       exists;
-};
-
 typedef struct ThisFilter
 {
     VideoFilter vf;
 
-    struct DeintThread *threads;
-    VideoFrame *frame;
-    int         field;
-    int         ready;
-    int         kill_threads;
-    int         actual_threads;
-    int         requested_threads;
-    pthread_mutex_t mutex;
-
     long long last_framenr;
 
     uint8_t *ref[4][3];
@@ -444,23 +427,131 @@ static void filter_line_c(struct ThisFilter *p, uint8_t *dst,
     }
 }
 
-static void filter_func(struct ThisFilter *p, uint8_t *dst, int dst_offsets[3],
-                        int dst_stride[3], int width, int height, int parity,
-                        int tff, int this_slice, int total_slices)
+#if HAVE_SSE2_INTRINSICS
+
+#define LOAD8(p) _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*)(p)), zero)
+
+static inline __m128i abs_diff_epi16(__m128i a, __m128i b)
+{
+    __m128i d = _mm_sub_epi16(a, b);
+    return _mm_max_epi16(d, _mm_sub_epi16(_mm_setzero_si128(), d));
+}
+
+static inline __m128i blend_epi16(__m128i mask, __m128i a, __m128i b)
 {
-    if (total_slices < 1)
-        return;
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/* Filters 8 pixels per pass in 16 bit words, this matches the C version
+ * exactly, including only trying the second direction of a side when
+ * the first one was an improvement. */
+static void filter_line_sse2(struct ThisFilter *p, uint8_t *dst,
+                             uint8_t *prev, uint8_t *cur, uint8_t *next,
+                             int w, int refs, int parity)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one  = _mm_set1_epi16(1);
+    uint8_t *prev2 = parity ? prev : cur ;
+    uint8_t *next2 = parity ? cur  : next;
+    int x;
+
+    for (x = 0; x < w - 7; x += 8)
+    {
+        __m128i c  = LOAD8(cur - refs);
+        __m128i e  = LOAD8(cur + refs);
+        __m128i p2 = LOAD8(prev2);
+        __m128i n2 = LOAD8(next2);
+        __m128i d  = _mm_srli_epi16(_mm_add_epi16(p2, n2), 1);
+
+        __m128i td0 = _mm_srli_epi16(abs_diff_epi16(p2, n2), 1);
+        __m128i td1 = _mm_srli_epi16(
+            _mm_add_epi16(abs_diff_epi16(LOAD8(prev - refs), c),
+                          abs_diff_epi16(LOAD8(prev + refs), e)), 1);
+        __m128i td2 = _mm_srli_epi16(
+            _mm_add_epi16(abs_diff_epi16(LOAD8(next - refs), c),
+                          abs_diff_epi16(LOAD8(next + refs), e)), 1);
+        __m128i diff = _mm_max_epi16(td0, _mm_max_epi16(td1, td2));
+
+        __m128i pred  = _mm_srli_epi16(_mm_add_epi16(c, e), 1);
+        __m128i score = _mm_sub_epi16(
+            _mm_add_epi16(
+                _mm_add_epi16(abs_diff_epi16(LOAD8(cur - refs - 1),
+                                             LOAD8(cur + refs - 1)),
+                              abs_diff_epi16(c, e)),
+                abs_diff_epi16(LOAD8(cur - refs + 1),
+                               LOAD8(cur + refs + 1))), one);
+
+#undef CHECK
+#define CHECK(j, mask) \
+        { \
+            __m128i a  = LOAD8(cur - refs + (j)); \
+            __m128i b  = LOAD8(cur + refs - (j)); \
+            __m128i sc = _mm_add_epi16( \
+                _mm_add_epi16(abs_diff_epi16(LOAD8(cur - refs - 1 + (j)), \
+                                             LOAD8(cur + refs - 1 - (j))), \
+                              abs_diff_epi16(a, b)), \
+                abs_diff_epi16(LOAD8(cur - refs + 1 + (j)), \
+                               LOAD8(cur + refs + 1 - (j)))); \
+            mask  = _mm_and_si128(mask, _mm_cmpgt_epi16(score, sc)); \
+            score = blend_epi16(mask, sc, score); \
+            pred  = blend_epi16(mask, \
+                        _mm_srli_epi16(_mm_add_epi16(a, b), 1), pred); \
+        }
+
+        __m128i m = _mm_cmpeq_epi16(zero, zero);
+        CHECK(-1, m)
+        CHECK(-2, m)
+        m = _mm_cmpeq_epi16(zero, zero);
+        CHECK( 1, m)
+        CHECK( 2, m)
+#undef CHECK
 
+        {
+            __m128i b  = _mm_srli_epi16(_mm_add_epi16(LOAD8(prev2 - 2 * refs),
+                                                      LOAD8(next2 - 2 * refs)),
+                                        1);
+            __m128i f  = _mm_srli_epi16(_mm_add_epi16(LOAD8(prev2 + 2 * refs),
+                                                      LOAD8(next2 + 2 * refs)),
+                                        1);
+            __m128i de = _mm_sub_epi16(d, e);
+            __m128i dc = _mm_sub_epi16(d, c);
+            __m128i bc = _mm_sub_epi16(b, c);
+            __m128i fe = _mm_sub_epi16(f, e);
+            __m128i mx = _mm_max_epi16(_mm_max_epi16(de, dc),
+                                       _mm_min_epi16(bc, fe));
+            __m128i mn = _mm_min_epi16(_mm_min_epi16(de, dc),
+                                       _mm_max_epi16(bc, fe));
+            diff = _mm_max_epi16(_mm_max_epi16(diff, mn),
+                                 _mm_sub_epi16(zero, mx));
+        }
+
+        pred = _mm_max_epi16(pred, _mm_sub_epi16(d, diff));
+        pred = _mm_min_epi16(pred, _mm_add_epi16(d, diff));
+        _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(pred, pred));
+
+        dst   += 8;
+        cur   += 8;
+        prev  += 8;
+        next  += 8;
+        prev2 += 8;
+        next2 += 8;
+    }
+
+    if (x < w)
+        filter_line_c(p, dst, prev, cur, next, w - x, refs, parity);
+}
+#undef LOAD8
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
+static void filter_func(struct ThisFilter *p, uint8_t *dst, int dst_offsets[3],
+                        int dst_stride[3], int width, int parity, int tff,
+                        int starth, int endh)
+{
     int y, i;
     uint8_t nr_p, nr_c;
     nr_c = p->got_frames[1] ? 1: 2;
     nr_p = p->got_frames[0] ? 0: nr_c;
-    int slice_height = height / total_slices;
-    slice_height     = (slice_height >> 1) << 1;
-    int starth       = slice_height * this_slice;
-    int endh         = starth + slice_height;
-    if ((this_slice + 1) >= total_slices)
-        endh = height;
 
     for (i = 0; i < 3; i++)
     {
@@ -493,10 +584,12 @@ static void filter_func(struct ThisFilter *p, uint8_t *dst, int dst_offsets[3],
 #endif
 }
 
-static int YadifDeint (VideoFilter * f, VideoFrame * frame, int field)
+/* Saves the new frame as a reference, this is the part of the filter
+ * which can't be split into slices. */
+static int YadifDeintBegin (VideoFilter * f, VideoFrame * frame, int field)
 {
     ThisFilter *filter = (ThisFilter *) f;
-    TF_VARS;
+    (void) field;
 
     AllocFilter(filter, frame->width, frame->height);
 
@@ -508,49 +601,34 @@ static int YadifDeint (VideoFilter * f, VideoFrame * frame, int field)
                   frame->pitches, frame->width, frame->height);
     }
 
-    if (filter->actual_threads < 1)
-    {
-        filter_func(
-            filter, frame->buf, frame->offsets, frame->pitches,
-            frame->width, frame->height, field, frame->top_field_first,
-            0, 1);
-    }
-    else
-    {
-        int i;
-        for (i = 0; i < filter->actual_threads; i++)
-            filter->threads[i].ready = 1;
-        filter->field = field;
-        filter->frame = frame;
-        filter->ready = filter->actual_threads;
-        i = 0;
-        while (filter->ready > 0 && i < 1000)
-        {
-            usleep(1000);
-            i++;
-        }
-    }
-
     filter->last_framenr = frame->frameNumber;
 
     return 0;
 }
 
+/* Only reads from the saved references, so the bands are independent. */
+static void YadifDeintSlice (VideoFilter * f, VideoFrame * frame, int field,
+                             int first_row, int last_row)
+{
+    filter_func((ThisFilter *) f, frame->buf, frame->offsets, frame->pitches,
+                frame->width, field, frame->top_field_first,
+                first_row, last_row);
+}
+
+static int YadifDeint (VideoFilter * f, VideoFrame * frame, int field)
+{
+    YadifDeintBegin(f, frame, field);
+    YadifDeintSlice(f, frame, field, 0, frame->height);
+
+    return 0;
+}
+
 
 static void CleanupYadifDeintFilter (VideoFilter * filter)
 {
     int i;
     ThisFilter* f = (ThisFilter*)filter;
 
-    if (f->threads != NULL)
-    {
-        f->kill_threads = 1;
-        for (i = 0; i < f->requested_threads; i++)
-            if (f->threads[i].exists)
-                pthread_join(f->threads[i].id, NULL);
-        free(f->threads);
-    }
-
     for (i = 0; i < 3*3; i++)
     {
         uint8_t **p= &f->ref[i%3][i/3];
@@ -559,38 +637,6 @@ static void CleanupYadifDeintFilter (VideoFilter * filter)
     }
 }
 
-static void *YadifThread(void *args)
-{
-    ThisFilter *filter = (ThisFilter*)args;
-
-    pthread_mutex_lock(&(filter->mutex));
-    int num = filter->actual_threads;
-    filter->actual_threads = num + 1;
-    pthread_mutex_unlock(&(filter->mutex));
-
-    while (!filter->kill_threads)
-    {
-        usleep(1000);
-        if (filter->ready &&
-            filter->frame != NULL &&
-            filter->threads[num].ready)
-        {
-            filter_func(
-                filter, filter->frame->buf, filter->frame->offsets,
-                filter->frame->pitches, filter->frame->width,
-                filter->frame->height, filter->field,
-                filter->frame->top_field_first, num, filter->actual_threads);
-
-            pthread_mutex_lock(&(filter->mutex));
-            filter->ready = filter->ready - 1;
-            filter->threads[num].ready = 0;
-            pthread_mutex_unlock(&(filter->mutex));
-        }
-    }
-    pthread_exit(NULL);
-    return NULL;
-}
-
 static VideoFilter * YadifDeintFilter(VideoFrameType inpixfmt,
                                       VideoFrameType outpixfmt,
                                       int *width, int *height, char *options,
@@ -599,6 +645,7 @@ static VideoFilter * YadifDeintFilter(VideoFrameType inpixfmt,
     ThisFilter *filter;
     (void) height;
     (void) options;
+    (void) threads;
 
     fprintf(stderr, "YadifDeint: In-Pixformat = %d Out-Pixformat=%d\n",
             inpixfmt, outpixfmt);
@@ -617,7 +664,7 @@ static VideoFilter * YadifDeintFilter(VideoFrameType inpixfmt,
     AllocFilter(filter, *width, *height);
 
 #if HAVE_MMX
-    filter->mm_flags = av_get_cpu_flags();
+    filter->mm_flags = filter_cpu_flags();
     TF_INIT(filter);
 #else
     filter->mm_flags = 0;
@@ -629,6 +676,10 @@ static VideoFilter * YadifDeintFilter(VideoFrameType inpixfmt,
     {
         filter->filter_line = filter_line_mmx2;
     }
+#if HAVE_SSE2_INTRINSICS
+    if (filter->mm_flags & FF_MM_SSE2)
+        filter->filter_line = filter_line_sse2;
+#endif
 
     if (filter->mm_flags & FF_MM_SSE2)
         fast_memcpy=fast_memcpy_SSE;
@@ -645,71 +696,7 @@ static VideoFilter * YadifDeintFilter(VideoFrameType inpixfmt,
     filter->vf.filter = &YadifDeint;
     filter->vf.cleanup = &CleanupYadifDeintFilter;
 
-    filter->frame = NULL;
-    filter->field = 0;
-    filter->ready = 0;
-    filter->kill_threads = 0;
-    filter->actual_threads  = 0;
-    filter->requested_threads  = threads;
-    filter->threads = NULL;
-
-    if (filter->requested_threads > 1)
-    {
-        filter->threads = (struct DeintThread *) calloc(threads,
-                          sizeof(struct DeintThread));
-        if (filter->threads == NULL)
-        {
-            printf("YadifDeint: failed to allocate memory for threads - "
-                   "falling back to existing, single thread.\n");
-            filter->requested_threads = 1;
-        }
-    }
-
-    if (filter->requested_threads > 1)
-    {
-        pthread_mutex_init(&(filter->mutex), NULL);
-        int success = 0;
-        for (int i = 0; i < filter->requested_threads; i++)
-        {
-            if (pthread_create(&(filter->threads[i].id), NULL,
-                               YadifThread, (void*)filter) != 0)
-                filter->threads[i].exists = 0;
-            else
-            {
-                success++;
-                filter->threads[i].exists = 1;
-            }
-        }
-
-        if (success < filter->requested_threads)
-        {
-            printf("YadifDeint: only created %d of %d threads - "
-                   "falling back to existing, single thread.\n"
-                   , success, filter->requested_threads);
-        }
-        else
-        {
-            int timeout = 0;
-            while (filter->actual_threads != filter->requested_threads)
-            {
-                timeout++;
-                if (timeout > 5000)
-                {
-                    printf("YadifDeint: waited too long for threads to start."
-                           "- continuing.\n");
-                    break;
-                }
-                usleep(1000);
-            }
-            printf("yadifdeint: Created %d threads (%d requested)\n",
-                   filter->actual_threads, filter->requested_threads);
-        }
-    }
-
-    if (filter->actual_threads < 1 )
-    {
-        printf("YadifDeint: Using existing thread.\n");
-    }
+    filter->last_framenr = -1;
 
     return (VideoFilter *) filter;
 }
@@ -727,14 +714,20 @@ ConstFilterInfo filter_table[] =
             name:       "yadifdeint",
             descript:   "combines data from several fields to deinterlace with less motion blur",
             formats:    FmtList,
-            libname:    NULL
+            libname:    NULL,
+            slice_begin: &YadifDeintBegin,
+            slice:      &YadifDeintSlice,
+            slice_overlap: 2
     },
     {
             filter_init: &YadifDeintFilter,
             name:       "yadifdoubleprocessdeint",
             descript:   "combines data from several fields to deinterlace with less motion blur",
             formats:    FmtList,
-            libname:    NULL
+            libname:    NULL,
+            slice_begin: &YadifDeintBegin,
+            slice:      &YadifDeintSlice,
+            slice_overlap: 2
     },FILT_NULL
 };
 
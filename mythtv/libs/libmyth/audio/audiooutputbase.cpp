@@ -341,7 +341,8 @@ void AudioOutputBase::SetStretchFactorLocked(float lstretchfactor)
             processing = true;
             bytes_per_frame = source_channels *
                               AudioOutputSettings::SampleSize(FORMAT_FLT);
-            waud = raud = 0;
+            StorePos(waud, 0);
+            StorePos(raud, 0);
             reset_active.Ref();
         }
     }
@@ -587,7 +588,8 @@ void AudioOutputBase::Reconfigure(const AudioSettings &orig_settings)
     QMutexLocker lock(&audio_buflock);
     QMutexLocker lockav(&avsync_lock);
 
-    waud = raud = 0;
+    StorePos(waud, 0);
+    StorePos(raud, 0);
     reset_active.Clear();
     actually_paused = processing = false;
 
@@ -917,7 +919,7 @@ void AudioOutputBase::Reset()
     QMutexLocker lockav(&avsync_lock);
 
     audbuf_timecode = audiotime = frames_buffered = 0;
-    waud = raud;    // empty ring buffer
+    StorePos(waud, LoadPos(raud));    // empty ring buffer
     reset_active.Ref();
     current_seconds = -1;
     was_paused = !pauseaudio;
@@ -955,10 +957,13 @@ void AudioOutputBase::SetEffDsp(int dsprate)
  */
 inline int AudioOutputBase::audiolen()
 {
-    if (waud >= raud)
-        return waud - raud;
+    uint r = LoadPos(raud);
+    uint w = LoadPos(waud);
+
+    if (w >= r)
+        return w - r;
     else
-        return kAudioRingBufferSize - (raud - waud);
+        return kAudioRingBufferSize - (r - w);
 }
 
 /**
@@ -1296,7 +1301,7 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
     // Don't write new samples if we're resetting the buffer or reconfiguring
     QMutexLocker lock(&audio_buflock);
 
-    uint org_waud = waud;
+    uint org_waud = LoadPos(waud);
     int  afree    = audiofree();
     int  used     = kAudioRingBufferSize - afree;
 
@@ -1443,12 +1448,13 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
         frames = len / bpf;
         frames_final += frames;
 
-        bdiff = kAudioRingBufferSize - waud;
+        uint start_waud = LoadPos(waud);
+        bdiff = kAudioRingBufferSize - start_waud;
 
         if (pSoundStretch)
         {
             // does not change the timecode, only the number of samples
-            org_waud     = waud;
+            org_waud     = start_waud;
             int bdFrames = bdiff / bpf;
 
             if (bdiff < len)
@@ -1480,7 +1486,7 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
 
         if (internal_vol && SWVolume())
         {
-            org_waud    = waud;
+            org_waud    = start_waud;
             int num     = len;
 
             if (bdiff <= num)
@@ -1498,7 +1504,7 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
 
         if (encoder)
         {
-            org_waud            = waud;
+            org_waud            = start_waud;
             int to_get          = 0;
 
             if (bdiff < len)
@@ -1525,7 +1531,8 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
             org_waud = (org_waud + to_get) % kAudioRingBufferSize;
         }
 
-        waud = org_waud;
+        // Only now may the output thread read the new samples
+        StorePos(waud, org_waud);
     }
 
     SetAudiotime(frames_final, timecode);
@@ -1635,14 +1642,14 @@ void AudioOutputBase::OutputAudioLoop(void)
         // delay setting raud until after phys buffer is filled
         // so GetAudiotime will be accurate without locking
         reset_active.TestAndDeref();
-        volatile uint next_raud = raud;
+        uint next_raud = LoadPos(raud);
         if (GetAudioData(fragment, fragment_size, true, &next_raud))
         {
             if (!reset_active.TestAndDeref())
             {
                 WriteAudio(fragment, fragment_size);
                 if (!reset_active.TestAndDeref())
-                    raud = next_raud;
+                    StorePos(raud, next_raud);
             }
         }
 #ifdef AUDIOTSTESTING
@@ -1667,7 +1674,7 @@ void AudioOutputBase::OutputAudioLoop(void)
  * available. Returns the number of bytes copied.
  */
 int AudioOutputBase::GetAudioData(uchar *buffer, int size, bool full_buffer,
-                                  volatile uint *local_raud)
+                                  uint *local_raud)
 {
 
 #define LRPOS audiobuffer + *local_raud
@@ -1677,8 +1684,12 @@ int AudioOutputBase::GetAudioData(uchar *buffer, int size, bool full_buffer,
     int frag_size    = size;
     int written_size = size;
 
-    if (local_raud == NULL)
-        local_raud = &raud;
+    // Without a local position the read position is moved once the
+    // samples have been copied out.
+    uint read_pos = LoadPos(raud);
+    bool publish  = (local_raud == NULL);
+    if (publish)
+        local_raud = &read_pos;
 
     if (!full_buffer && (size > avail_size))
     {
@@ -1690,7 +1701,7 @@ int AudioOutputBase::GetAudioData(uchar *buffer, int size, bool full_buffer,
     if (!avail_size || (frag_size > avail_size))
         return 0;
 
-    int bdiff = kAudioRingBufferSize - raud;
+    int bdiff = kAudioRingBufferSize - *local_raud;
 
     int obytes = output_settings->SampleSize(output_format);
     bool fromFloats = processing && !enc && output_format != FORMAT_FLT;
@@ -1726,6 +1737,9 @@ int AudioOutputBase::GetAudioData(uchar *buffer, int size, bool full_buffer,
 
     *local_raud += frag_size;
 
+    if (publish)
+        StorePos(raud, read_pos);
+
     // Mute individual channels through mono->stereo duplication
     MuteState mute_state = GetMuteState();
     if (!enc && !passthru &&
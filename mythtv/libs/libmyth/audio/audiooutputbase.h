@@ -11,6 +11,7 @@ using namespace std;
 // Qt headers
 #include <QString>
 #include <QMutex>
+#include <QAtomicInt>
 #include <QWaitCondition>
 
 // MythTV headers
@@ -140,7 +141,7 @@ class AudioOutputBase : public AudioOutput, public MThread
     virtual void StopOutputThread(void);
 
     int GetAudioData(uchar *buffer, int buf_size, bool fill_buffer,
-                     volatile uint *local_raud = NULL);
+                     uint *local_raud = NULL);
 
     void OutputAudioLoop(void);
 
@@ -149,6 +150,12 @@ class AudioOutputBase : public AudioOutput, public MThread
     int CheckFreeSpace(int &frames);
 
     inline int audiolen(); // number of valid bytes in audio buffer
+    /// Reads a ring position written by the other thread.
+    static inline uint LoadPos(QAtomicInt &pos)
+        { return (uint)pos.fetchAndAddAcquire(0); }
+    /// Publishes a ring position to the other thread.
+    static inline void StorePos(QAtomicInt &pos, uint value)
+        { pos.fetchAndStoreRelease((int)value); }
     int audiofree();       // number of free bytes in audio buffer
     int audioready();      // number of bytes ready to be written
 
@@ -248,9 +255,14 @@ class AudioOutputBase : public AudioOutput, public MThread
     int64_t audiotime;
 
     /**
-     * Audio circular buffer
+     * Audio circular buffer, single producer and single consumer.
+     * Only the writer moves waud, outside of resets, and only the
+     * output thread moves raud, so the output thread never takes
+     * audio_buflock. Each side stores its position with release
+     * semantics after it is done with the bytes, and loads the other
+     * side's with acquire semantics before it touches them.
      */
-    volatile uint raud, waud;     // read and write positions
+    QAtomicInt raud, waud;        // read and write positions
     /**
      * timecode of audio most recently placed into buffer
      */
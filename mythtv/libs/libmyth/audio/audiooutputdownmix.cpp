@@ -16,11 +16,20 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 
+#include "mythconfig.h"
 #include "audiooutputbase.h"
 #include "audiooutputdownmix.h"
+#include "audiooutpututil.h"
 
 #include "string.h"
 
+#if ARCH_X86 && defined(__SSE__)
+#include <xmmintrin.h>
+#define DOWNMIX_SSE 1
+#else
+#define DOWNMIX_SSE 0
+#endif
+
 #define LOC QString("Downmixer: ")
 
 /*
@@ -164,6 +173,39 @@ static const float s51_matrix[3][8][6] =
     }
 };
 
+#if DOWNMIX_SSE
+/*
+ Downmixes four frames at a time to stereo and returns the number of frames
+ done, leaving any remainder for the C. All four input frames are read before
+ the eight output samples are stored, so dst may be the same buffer as src.
+ The sums are added up in the same order as the C does.
+ */
+static int sse_stereo_downmix(int channels_in, const float matrix[8][2],
+                              float *dst, const float *src, int frames)
+{
+    int n = 0;
+    for (; n + 4 <= frames; n += 4)
+    {
+        __m128 l = _mm_setzero_ps();
+        __m128 r = _mm_setzero_ps();
+        for (int j = 0; j < channels_in; j++)
+        {
+            __m128 s = _mm_setr_ps(src[j],
+                                   src[channels_in + j],
+                                   src[2 * channels_in + j],
+                                   src[3 * channels_in + j]);
+            l = _mm_add_ps(l, _mm_mul_ps(s, _mm_set1_ps(matrix[j][0])));
+            r = _mm_add_ps(r, _mm_mul_ps(s, _mm_set1_ps(matrix[j][1])));
+        }
+        _mm_storeu_ps(dst,     _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(dst + 4, _mm_unpackhi_ps(l, r));
+        src += 4 * channels_in;
+        dst += 8;
+    }
+    return n;
+}
+#endif
+
 int AudioOutputDownmix::DownmixFrames(int channels_in, int  channels_out,
                                       float *dst, float *src, int frames)
 {
@@ -176,7 +218,17 @@ int AudioOutputDownmix::DownmixFrames(int channels_in, int  channels_out,
     {
         float tmp;
         int index = channels_in - 1;
-        for (int n=0; n < frames; n++)
+        int n = 0;
+#if DOWNMIX_SSE
+        if (AudioOutputUtil::has_hardware_fpu())
+        {
+            n = sse_stereo_downmix(channels_in, stereo_matrix[index],
+                                   dst, src, frames);
+            src += n * channels_in;
+            dst += n * 2;
+        }
+#endif
+        for (; n < frames; n++)
         {
             for (int i=0; i < channels_out; i++)
             {
@@ -41,11 +41,18 @@ AudioOutputNULL::~AudioOutputNULL()
 
 bool AudioOutputNULL::OpenDevice()
 {
-    LOG(VB_GENERAL, LOG_INFO, "Opening NULL audio device, will fail.");
-
     fragment_size = NULLAUDIO_OUTPUT_BUFFER_SIZE / 2;
     soundcard_buffer_size = NULLAUDIO_OUTPUT_BUFFER_SIZE;
 
+    // When the output is read back with readOutputData() there is
+    // something to play to, otherwise fail so that there is no audio.
+    if (buffer_output_data_for_use)
+    {
+        LOG(VB_AUDIO, LOG_INFO, "Opening NULL audio device, buffering output.");
+        return true;
+    }
+
+    LOG(VB_GENERAL, LOG_INFO, "Opening NULL audio device, will fail.");
     return false;
 }
 
@@ -85,12 +92,19 @@ void AudioOutputNULL::WriteAudio(unsigned char* aubuf, int size)
 {
     if (buffer_output_data_for_use)
     {
-        if (size + current_buffer_size > NULLAUDIO_OUTPUT_BUFFER_SIZE)
+        if (size > NULLAUDIO_OUTPUT_BUFFER_SIZE)
         {
             LOG(VB_GENERAL, LOG_ERR, "null audio output should not have just "
                                      "had data written to it");
             return;
         }
+        // Block like a sound card would until the reader makes room
+        while (size + current_buffer_size > NULLAUDIO_OUTPUT_BUFFER_SIZE)
+        {
+            if (killaudio)
+                return;
+            usleep(1000);
+        }
         pcm_output_buffer_mutex.lock();
         memcpy(pcm_output_buffer + current_buffer_size, aubuf, size);
         current_buffer_size += size;
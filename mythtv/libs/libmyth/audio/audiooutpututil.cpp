@@ -132,7 +132,9 @@ static int toFloat8(float *out, uchar *in, int len)
 
 /*
   The SSE code processes 16 bytes at a time and leaves any remainder for the C
-  - there is no remainder in practice */
+  - there is no remainder in practice. The fromFloat variants only use
+  unaligned loads and stores, so they also take the SSE path for the second
+  half of a read that wraps around the ring buffer */
 
 static int fromFloat8(uchar *out, float *in, int len)
 {
@@ -140,7 +142,7 @@ static int fromFloat8(uchar *out, float *in, int len)
     float f = (1<<7) - 1;
 
 #if ARCH_X86
-    if (sse_check() && len >= 16 && ((unsigned long)out & 0xf) == 0)
+    if (sse_check() && len >= 16)
     {
         int loops = len >> 4;
         i = loops << 4;
@@ -245,7 +247,7 @@ static int fromFloat16(short *out, float *in, int len)
     float f = (1<<15) - 1;
 
 #if ARCH_X86
-    if (sse_check() && len >= 16 && ((unsigned long)out & 0xf) == 0)
+    if (sse_check() && len >= 16)
     {
         int loops = len >> 4;
         i = loops << 4;
@@ -352,7 +354,7 @@ static int fromFloat32(AudioFormat format, int *out, float *in, int len)
         shift = 0;
 
 #if ARCH_X86
-    if (sse_check() && len >= 16 && ((unsigned long)out & 0xf) == 0)
+    if (sse_check() && len >= 16)
     {
         float o = 1, mo = -1;
         int loops = len >> 4;
@@ -417,7 +419,7 @@ static int fromFloatFLT(float *out, float *in, int len)
     int i = 0;
 
 #if ARCH_X86
-    if (sse_check() && len >= 16 && ((unsigned long)in & 0xf) == 0)
+    if (sse_check() && len >= 16)
     {
         int loops = len >> 4;
         float o = 1, mo = -1;
@@ -39,7 +39,7 @@
 class SERVICE_PUBLIC ContentServices : public Service  //, public QScriptable ???
 {
     Q_OBJECT
-    Q_CLASSINFO( "version"    , "1.32" );
+    Q_CLASSINFO( "version"    , "1.33" );
     Q_CLASSINFO( "DownloadFile_Method",            "POST" )
 
     public:
@@ -93,6 +93,9 @@ class SERVICE_PUBLIC ContentServices : public Service  //, public QScriptable ??
         virtual QFileInfo           GetRecording        ( int              ChanId,
                                                           const QDateTime &StartTime ) = 0;
 
+        virtual QFileInfo           GetTrickplayIndex   ( int              ChanId,
+                                                          const QDateTime &StartTime ) = 0;
+
         virtual QFileInfo           GetMusic            ( int Id ) = 0;
         virtual QFileInfo           GetVideo            ( int Id ) = 0;
 
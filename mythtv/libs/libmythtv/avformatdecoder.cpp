@@ -1,6 +1,10 @@
 // C headers
 #include <cassert>
 #include <unistd.h>
+#include <sys/time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 #include <cmath>
 #include <stdint.h>
 
@@ -90,12 +94,33 @@ static const float eps = 1E-5;
 
 static const int max_video_queue_size = 180;
 
+/// How much of a LiveTV transport stream av_find_stream_info() looks at,
+/// in AV_TIME_BASE units. Transport streams come from DTVRecorder based
+/// recorders, which by default drop everything before the first keyframe,
+/// so the video stream can be probed as soon as the file has data.
+/// Program streams from ivtv cards keep the default duration.
+static const int kLiveTVAnalyzeDuration = AV_TIME_BASE / 2;
+
 static int cc608_parity(uint8_t byte);
 static int cc608_good_parity(const int *parity_table, uint16_t data);
 static void cc608_build_parity_table(int *parity_table);
 
 static bool silence_ffmpeg_logging = false;
 
+/// CPU time used by all the threads of this process, or -1 if unknown.
+static int64_t process_cpu_usecs(void)
+{
+#ifndef _WIN32
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) < 0)
+        return -1;
+    return (int64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+           ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#else
+    return -1;
+#endif
+}
+
 static QSize get_video_dim(const AVCodecContext &ctx)
 {
     return QSize(ctx.width >> ctx.lowres, ctx.height >> ctx.lowres);
@@ -286,6 +311,11 @@ AvFormatDecoder::AvFormatDecoder(MythPlayer *parent,
       playerFlags(flags),
       video_codec_id(kCodec_NONE),
       maxkeyframedist(-1),
+      m_maxThreads(1),              m_threadCount(1),
+      m_seekThreads(false),
+      m_decodeCpuStart(-1),         m_decodeFrames(0),
+      m_decodeUsecsTotal(0),
+      m_gopResyncKey(-1),           m_gopResyncFrames(0),
       // Closed Caption & Teletext decoders
       ignore_scte(false),
       invert_scte_field(0),
@@ -659,6 +689,10 @@ void AvFormatDecoder::SeekReset(long long newKey, uint skipFrames,
 
     DecoderBase::SeekReset(newKey, skipFrames, doflush, discardFrames);
 
+    // A seek served from the GOP cache which hasn't caught up yet
+    // is superseded by this one
+    m_gopResyncFrames = 0;
+
     if (doflush)
     {
         lastapts = 0;
@@ -692,7 +726,14 @@ void AvFormatDecoder::SeekReset(long long newKey, uint skipFrames,
         }
         if (private_dec)
             private_dec->Reset();
+
+        // The codec holds no frames now, so switch to slice threads
+        // until the next keyframe to get the first frame out sooner.
+        m_seekThreads = true;
+        ReopenVideoCodec();
     }
+    m_decodeCpuStart = -1;
+    m_decodeFrames   = 0;
 
     // Discard all the queued up decoded frames
     if (discardFrames)
@@ -722,24 +763,234 @@ void AvFormatDecoder::SeekReset(long long newKey, uint skipFrames,
         }
     }
 
-    // Skip all the desired number of skipFrames
+    // Frame numbers only identify decoded frames when we start
+    // decoding at the keyframe we sought to.
+    bool cache_gop = doflush && !ringBuffer->IsDVD() && !private_dec &&
+        (framesPlayed == lastKey);
+
+    // If an earlier exact seek into this GOP decoded the target frame
+    // on its way, show the cached copy now and only decode forward from
+    // the keyframe when the next frame is asked for.
+    if (cache_gop && discardFrames && skipFrames &&
+        GetCachedGOPFrame(lastKey + skipFrames))
+    {
+        m_gopResyncKey    = lastKey;
+        m_gopResyncFrames = skipFrames + 1;
+        skipFrames        = 0;
+    }
+
+    SkipGOPFrames(skipFrames, (cache_gop) ? lastKey : -1);
+
+    if (doflush)
+    {
+        firstvpts = 0;
+        firstvptsinuse = true;
+    }
+}
+
+/** \fn AvFormatDecoder::GetCachedGOPFrame(long long)
+ *  \brief Releases the GOP cache's copy of frame frameNumber of the
+ *         GOP starting at lastKey for display, as if it was decoded.
+ *  \return false if the frame isn't cached.
+ */
+bool AvFormatDecoder::GetCachedGOPFrame(long long frameNumber)
+{
+    VideoFrame *frame = m_parent->GetNextVideoFrame();
+    if (!frame)
+        return false;
+
+    if (!m_parent->GetGOPFrame(lastKey, frameNumber, frame))
+    {
+        m_parent->DiscardVideoFrame(frame);
+        return false;
+    }
+
+    m_parent->ReleaseNextVideoFrame(frame, frame->timecode, false);
+    m_parent->DeLimboFrame(frame);
+
+    LOG(VB_PLAYBACK, LOG_INFO, LOC +
+        QString("SeekReset() frame %1 from the GOP cache").arg(frameNumber));
+
+    decoded_video_frame = frame;
+    gotVideoFrame = true;
+    framesPlayed = frameNumber + 1;
+    lastvpts = frame->timecode;
+    return true;
+}
+
+/** \fn AvFormatDecoder::SkipGOPFrames(uint, long long)
+ *  \brief Decodes and discards skipFrames frames, keeping copies of
+ *         them in the GOP cache under keyframe gopKey unless it is -1.
+ */
+void AvFormatDecoder::SkipGOPFrames(uint skipFrames, long long gopKey)
+{
     for (;skipFrames > 0 && !ateof; skipFrames--)
     {
         GetFrame(kDecodeVideo);
         if (decoded_video_frame)
         {
+            if (gopKey >= 0)
+                m_parent->CacheGOPFrame(gopKey, decoded_video_frame);
             m_parent->DiscardVideoFrame(decoded_video_frame);
             decoded_video_frame = NULL;
         }
     }
+}
 
-    if (doflush)
+/** \fn AvFormatDecoder::SetVideoThreads(AVCodecContext*,const AVCodec*)
+ *  \brief Sets the threading of the video codec before it is opened.
+ *
+ *   Frame threads give the best throughput in steady playback, but each
+ *   thread delays the first decoded frame by one frame, which makes
+ *   keyframe only trick play and seeking sluggish. So trick play, and
+ *   the first GOP after a seek, use slice threads, which add no delay.
+ *   Steady playback uses m_threadCount frame threads, which
+ *   TuneVideoThreads() picks from the measured decode cost. Codecs which
+ *   only support slice threads always get the profile's maximum.
+ */
+void AvFormatDecoder::SetVideoThreads(AVCodecContext *enc,
+                                      const AVCodec *codec)
+{
+    if (!HAVE_THREADS)
+        return;
+
+    GetVideoThreads(codec, enc->thread_count, enc->thread_type);
+}
+
+void AvFormatDecoder::GetVideoThreads(const AVCodec *codec,
+                                      int &count, int &type) const
+{
+    bool frame_threads =
+        !codec || (codec->capabilities & CODEC_CAP_FRAME_THREADS);
+
+    if ((trickplay || m_seekThreads) && frame_threads)
     {
-        firstvpts = 0;
-        firstvptsinuse = true;
+        count = m_maxThreads;
+        type  = FF_THREAD_SLICE;
+    }
+    else
+    {
+        count = (frame_threads) ? m_threadCount : m_maxThreads;
+        type  = FF_THREAD_FRAME | FF_THREAD_SLICE;
     }
 }
 
+/** \fn AvFormatDecoder::VideoThreadsChanged(void)
+ *  \brief Returns true if SetVideoThreads() would now pick different
+ *         threading than the video codec is open with.
+ */
+bool AvFormatDecoder::VideoThreadsChanged(void)
+{
+    int idx = selectedTrack[kTrackTypeVideo].av_stream_index;
+    if (!ic || idx < 0 || (uint)idx >= ic->nb_streams || private_dec ||
+        m_maxThreads <= 1)
+    {
+        return false;
+    }
+
+    AVCodecContext *enc = ic->streams[idx]->codec;
+    if (!enc->codec)
+        return false;
+
+    int count, type;
+    GetVideoThreads(enc->codec, count, type);
+    return (count != enc->thread_count || type != enc->thread_type);
+}
+
+/** \fn AvFormatDecoder::ReopenVideoCodec(void)
+ *  \brief Reopens the video codec if SetVideoThreads() would now pick
+ *         different threading than it is open with.
+ *
+ *   The thread settings only take effect when the codec is opened, so
+ *   this must only be called when the codec holds no frames and the
+ *   next packet decoded is a keyframe: after it has been flushed for a
+ *   seek, or drained by ProcessVideoPacket() at a keyframe.
+ */
+void AvFormatDecoder::ReopenVideoCodec(void)
+{
+    if (!VideoThreadsChanged())
+        return;
+
+    AVCodecContext *enc =
+        ic->streams[selectedTrack[kTrackTypeVideo].av_stream_index]->codec;
+    AVCodec *codec = enc->codec;
+
+    // avcodec_close() needs the thread count the codec was opened with
+    int new_count, new_type;
+    GetVideoThreads(codec, new_count, new_type);
+
+    LOG(VB_PLAYBACK, LOG_INFO, LOC +
+        QString("Reopening video codec with %1 %2 threads")
+            .arg(new_count)
+            .arg((new_type & FF_THREAD_FRAME) ? "frame" : "slice"));
+
+    QMutexLocker locker(avcodeclock);
+    avcodec_close(enc);
+    enc->thread_count = new_count;
+    enc->thread_type  = new_type;
+    if (avcodec_open(enc, codec) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            "Could not reopen video codec, trying single threaded");
+        enc->thread_count = 1;
+        if (avcodec_open(enc, codec) < 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "Could not reopen video codec");
+            errored = true;
+        }
+    }
+}
+
+/** \fn AvFormatDecoder::TuneVideoThreads(void)
+ *  \brief Picks the number of frame threads for steady playback from the
+ *         CPU time each frame costs compared to the frame interval.
+ *
+ *   The cost is the process CPU time over 250 decoded frames, so it does
+ *   not depend on how the work is split between threads, unlike the time
+ *   spent waiting in avcodec_decode_video2(). It includes the other
+ *   player threads, so it errs towards more threads. Enough threads are
+ *   used to keep each one busy for at most half the frame interval, since
+ *   fewer frame threads mean less latency and fewer frames held by the
+ *   decoder. A new count is applied at the next keyframe.
+ */
+void AvFormatDecoder::TuneVideoThreads(void)
+{
+    if (m_decodeCpuStart < 0)
+    {
+        m_decodeCpuStart = process_cpu_usecs();
+        return;
+    }
+
+    if (m_decodeFrames < 250)
+        return;
+
+    int64_t cpu_end = process_cpu_usecs();
+    if (cpu_end < m_decodeCpuStart)
+        return;
+
+    float interval = (fps > 0.0f) ? 1000000.0f / fps : 40000.0f;
+    float cost = (float)(cpu_end - m_decodeCpuStart) / m_decodeFrames;
+    uint count = (uint) ceilf(cost / (interval * 0.5f));
+    count = max(min(count, m_maxThreads), 1U);
+
+    LOG(VB_PLAYBACK, LOG_DEBUG, LOC +
+        QString("Decoding cost %1 us of CPU per frame, %2% of the frame "
+                "interval, with %3 threads")
+            .arg((int)cost).arg((int)(cost * 100 / interval))
+            .arg(m_threadCount));
+
+    if (count != m_threadCount)
+    {
+        LOG(VB_PLAYBACK, LOG_INFO, LOC +
+            QString("Will use %1 decoder threads instead of %2 from the "
+                    "next keyframe").arg(count).arg(m_threadCount));
+        m_threadCount = count;
+    }
+
+    m_decodeCpuStart = cpu_end;
+    m_decodeFrames   = 0;
+}
+
 void AvFormatDecoder::SetEof(bool eof)
 {
     if (!eof && ic && ic->pb)
@@ -764,6 +1015,12 @@ void AvFormatDecoder::Reset(bool reset_video_data, bool seek_reset,
 
     DecoderBase::Reset(reset_video_data, false, reset_file);
 
+    if (reset_video_data || reset_file)
+    {
+        m_gopResyncFrames = 0;
+        m_parent->ClearGOPCache();
+    }
+
     if (reset_video_data)
     {
         seen_gop = false;
@@ -944,6 +1201,10 @@ int AvFormatDecoder::OpenFile(RingBuffer *rbuffer, bool novideo,
         return -1;
     }
 
+    // Don't hold up a LiveTV channel change analysing the new file
+    if (livetv && !strcmp(fmt->name, "mpegts"))
+        ic->max_analyze_duration = kLiveTVAnalyzeDuration;
+
     int ret = FindStreamInfo();
 
     // Reset DVD/bluray ringbuffers
@@ -1921,8 +2182,9 @@ int AvFormatDecoder::ScanStreams(bool novideo)
                     QString("Using %1 CPUs for decoding")
                         .arg(HAVE_THREADS ? thread_count : 1));
 
-                if (HAVE_THREADS)
-                    enc->thread_count = thread_count;
+                m_maxThreads  = (HAVE_THREADS) ? thread_count : 1;
+                m_threadCount = m_maxThreads;
+                SetVideoThreads(enc);
 
                 InitVideoCodec(ic->streams[i], enc,
                     selectedTrack[kTrackTypeVideo].av_stream_index == (int) i);
@@ -3038,6 +3300,33 @@ bool AvFormatDecoder::ProcessVideoPacket(AVStream *curstream, AVPacket *pkt)
     if (pkt->pts != (int64_t)AV_NOPTS_VALUE)
         pts_detected = true;
 
+    // Switch threading at a keyframe, once the frames the codec still
+    // holds have been drained, so that no references are lost.
+    if (pkt->data && (pkt->flags & PKT_FLAG_KEY) && !private_dec &&
+        !ringBuffer->IsDisc())
+    {
+        if (m_seekThreads && m_decodeFrames)
+            m_seekThreads = false;
+
+        if (VideoThreadsChanged())
+        {
+            AVPacket drain;
+            av_init_packet(&drain);
+            drain.data = NULL;
+            drain.size = 0;
+            for (uint i = 0; i <= m_maxThreads + 16; i++)
+            {
+                uint frames = m_decodeFrames;
+                if (!ProcessVideoPacket(curstream, &drain) ||
+                    frames == m_decodeFrames)
+                {
+                    break;
+                }
+            }
+            ReopenVideoCodec();
+        }
+    }
+
     avcodeclock->lock();
     if (private_dec)
     {
@@ -3050,14 +3339,29 @@ bool AvFormatDecoder::ProcessVideoPacket(AVStream *curstream, AVPacket *pkt)
     }
     else
     {
+        struct timeval start, end;
+        gettimeofday(&start, NULL);
+
         context->reordered_opaque = pkt->pts;
         ret = avcodec_decode_video2(context, &mpa_pic, &gotpicture, pkt);
         // Reparse it to not drop the DVD still frame
         if (ringBuffer->IsDVD() && ringBuffer->DVD()->NeedsStillFrame())
             ret = avcodec_decode_video2(context, &mpa_pic, &gotpicture, pkt);
+
+        gettimeofday(&end, NULL);
+        m_decodeUsecsTotal += (end.tv_sec - start.tv_sec) * 1000000LL +
+                              (end.tv_usec - start.tv_usec);
+        if (gotpicture)
+            m_decodeFrames++;
     }
     avcodeclock->unlock();
 
+    if (!trickplay && !private_dec && m_maxThreads > 1 && context->codec &&
+        (context->codec->capabilities & CODEC_CAP_FRAME_THREADS))
+    {
+        TuneVideoThreads();
+    }
+
     if (ret < 0)
     {
         LOG(VB_GENERAL, LOG_ERR, LOC + "Unknown decoding error");
@@ -4210,6 +4514,17 @@ bool AvFormatDecoder::GetFrame(DecodeType decodetype)
     AVPacket *pkt = NULL;
     bool have_err = false;
 
+    if (m_gopResyncFrames)
+    {
+        // The last seek was served from the GOP cache while the stream
+        // was left at its keyframe, catch up to the frame shown.
+        uint skipFrames = m_gopResyncFrames;
+        m_gopResyncFrames = 0;
+        framesPlayed = m_gopResyncKey;
+        lastvpts = 0;
+        SkipGOPFrames(skipFrames, m_gopResyncKey);
+    }
+
     gotVideoFrame = false;
 
     frame_decoded = 0;
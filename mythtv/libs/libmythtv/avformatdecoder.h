@@ -141,6 +141,7 @@ class AvFormatDecoder : public DecoderBase
     long UpdateStoredFrameNum(long frame) { (void)frame; return 0;}
 
     QString      GetCodecDecoderName(void) const;
+    uint64_t     GetVideoDecodeTime(void) const { return m_decodeUsecsTotal; }
     QString      GetRawEncodingType(void);
     MythCodecID  GetVideoCodecID(void) const { return video_codec_id; }
     void        *GetVideoCodecPrivate(void);
@@ -233,6 +234,14 @@ class AvFormatDecoder : public DecoderBase
                         int width, int height);
 
     void SeekReset(long long, uint skipFrames, bool doFlush, bool discardFrames);
+    bool GetCachedGOPFrame(long long frameNumber);
+    void SkipGOPFrames(uint skipFrames, long long gopKey);
+
+    void SetVideoThreads(AVCodecContext *enc, const AVCodec *codec = NULL);
+    void GetVideoThreads(const AVCodec *codec, int &count, int &type) const;
+    bool VideoThreadsChanged(void);
+    void ReopenVideoCodec(void);
+    void TuneVideoThreads(void);
 
     inline bool DecoderWillDownmix(const AVCodecContext *ctx);
     bool DoPassThrough(const AVCodecContext *ctx, bool withProfile=true);
@@ -313,6 +322,18 @@ class AvFormatDecoder : public DecoderBase
 
     int maxkeyframedist;
 
+    // Video decoder threading, see SetVideoThreads()
+    uint      m_maxThreads;      ///< upper limit, from the display profile
+    uint      m_threadCount;     ///< tuned number of frame threads
+    bool      m_seekThreads;     ///< slice threads until the next keyframe
+    int64_t   m_decodeCpuStart;  ///< process CPU time at start of window
+    uint      m_decodeFrames;    ///< frames decoded this window
+    uint64_t  m_decodeUsecsTotal;  ///< time spent in the decoder overall
+
+    // Exact seek served from the GOP cache, see SeekReset()
+    long long m_gopResyncKey;    ///< keyframe to decode forward from
+    uint      m_gopResyncFrames; ///< frames to decode and discard
+
     // Caption/Subtitle/Teletext decoders
     bool             ignore_scte;
     uint             invert_scte_field;
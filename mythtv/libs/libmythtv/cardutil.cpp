@@ -992,6 +992,165 @@ vector<uint> CardUtil::GetCloneCardIDs(uint cardid)
     return list;
 }
 
+/** \fn CardUtil::SetCloneCount(uint, uint)
+ *  \brief Adds or deletes clones of a tuner sharing capable card until
+ *         its device has count cards, and copies the configuration of
+ *         cardid to all of them.
+ */
+bool CardUtil::SetCloneCount(uint cardid, uint count)
+{
+    QString type = CardUtil::GetRawCardType(cardid);
+    if (!IsTunerSharingCapable(type))
+        return false;
+
+    QString dev = CardUtil::GetVideoDevice(cardid);
+    if (dev.isEmpty())
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            QString("Cannot clone card #%1 with empty videodevice")
+                .arg(cardid));
+        return false;
+    }
+
+    QString host = get_on_cardid("hostname", cardid);
+    vector<uint> cardids = CardUtil::GetCardIDs(dev, type, host);
+    uint cloneCount = max(count, 1U) - 1;
+
+    // Delete old clone cards as required.
+    for (uint i = cardids.size() - 1; (i > cloneCount) && cardids.size(); i--)
+    {
+        CardUtil::DeleteCard(cardids.back());
+        cardids.pop_back();
+    }
+
+    // Make sure clones & original all share an input group
+    if (cloneCount && !CardUtil::CreateInputGroupIfNeeded(cardid))
+        return false;
+
+    bool ok = true;
+
+    // Clone this config to existing clone cards.
+    for (uint i = 0; i < cardids.size(); i++)
+    {
+        if (cardids[i] != cardid)
+            ok &= CardUtil::CloneCard(cardid, cardids[i]);
+    }
+
+    // Create new clone cards as required.
+    for (uint i = cardids.size(); i < cloneCount + 1; i++)
+        ok &= CardUtil::CloneCard(cardid, 0);
+
+    return ok;
+}
+
+/** \fn CardUtil::GetMultiplexCapacity(uint)
+ *  \brief Returns the most visible channels carried on any one multiplex
+ *         of the video sources connected to the card.
+ *
+ *   This is how many recordings the card could make at once from one
+ *   tuned multiplex, capped at kMaxMultirecCount. It is at least 1.
+ */
+uint CardUtil::GetMultiplexCapacity(uint cardid)
+{
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare(
+        "SELECT COUNT(DISTINCT channel.chanid) AS cnt "
+        "FROM channel, cardinput "
+        "WHERE cardinput.cardid   = :CARDID            AND "
+        "      channel.sourceid   = cardinput.sourceid AND "
+        "      channel.mplexid    > 0                  AND "
+        "      channel.visible    = 1 "
+        "GROUP BY channel.mplexid "
+        "ORDER BY cnt DESC "
+        "LIMIT 1");
+    query.bindValue(":CARDID", cardid);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("CardUtil::GetMultiplexCapacity()", query);
+        return 1;
+    }
+
+    if (!query.next())
+        return 1;
+
+    uint cnt = query.value(0).toUInt();
+    return max(1U, min(cnt, kMaxMultirecCount));
+}
+
+static QString multirec_auto_key(uint cardid)
+{
+    return QString("MultirecAuto_%1_%2")
+        .arg(CardUtil::GetRawCardType(cardid))
+        .arg(CardUtil::GetVideoDevice(cardid));
+}
+
+/** \fn CardUtil::IsMultirecAuto(uint)
+ *  \brief Returns true if the number of clones of this card should follow
+ *         the channels per multiplex, see GetMultiplexCapacity().
+ */
+bool CardUtil::IsMultirecAuto(uint cardid)
+{
+    if (!IsTunerSharingCapable(GetRawCardType(cardid)))
+        return false;
+
+    QString host = get_on_cardid("hostname", cardid);
+    return gCoreContext->GetNumSettingOnHost(
+        multirec_auto_key(cardid), host, 0);
+}
+
+void CardUtil::SetMultirecAuto(uint cardid, bool is_auto)
+{
+    QString host = get_on_cardid("hostname", cardid);
+    gCoreContext->SaveSettingOnHost(
+        multirec_auto_key(cardid), (is_auto) ? "1" : "0", host);
+}
+
+/** \fn CardUtil::UpdateAutoMultirecCounts(const QString&)
+ *  \brief Resizes the clones of every automatic multirec card on the host
+ *         to the current capacity of its multiplexes.
+ *
+ *   Channel scans change how many channels each multiplex carries, so
+ *   each backend calls this for its own cards before creating its TVRecs.
+ *   Cards of other hosts are left alone, their backend may be using them.
+ */
+void CardUtil::UpdateAutoMultirecCounts(const QString &hostname)
+{
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare(
+        "SELECT MIN(cardid), COUNT(*) "
+        "FROM capturecard "
+        "WHERE hostname = :HOSTNAME "
+        "GROUP BY cardtype, videodevice");
+    query.bindValue(":HOSTNAME", hostname);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("CardUtil::UpdateAutoMultirecCounts()", query);
+        return;
+    }
+
+    while (query.next())
+    {
+        uint cardid = query.value(0).toUInt();
+        uint count  = query.value(1).toUInt();
+
+        if (!IsMultirecAuto(cardid))
+            continue;
+
+        uint capacity = GetMultiplexCapacity(cardid);
+        if (capacity == count)
+            continue;
+
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Card %1 has up to %2 channels per multiplex, "
+                    "changing it from %3 to %4 recorders")
+                .arg(cardid).arg(capacity).arg(count).arg(capacity));
+
+        SetCloneCount(cardid, capacity);
+    }
+}
+
 QString CardUtil::GetFirewireChangerNode(uint inputid)
 {
     QString fwnode;
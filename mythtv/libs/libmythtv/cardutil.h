@@ -21,6 +21,9 @@ class InputInfo;
 class CardInput;
 typedef QMap<int,QString> InputNames;
 
+/// Most recordings one tuner sharing capable device is set up to make.
+static const uint kMaxMultirecCount = 5;
+
 MTV_PUBLIC QString get_on_cardid(const QString&, uint);
 
 MTV_PUBLIC bool set_on_source(const QString&, uint, uint, const QString);
@@ -339,6 +342,11 @@ class MTV_PUBLIC CardUtil
     // Other
     static bool         CloneCard(uint src_cardid, uint dst_cardid);
     static vector<uint> GetCloneCardIDs(uint cardid);
+    static bool         SetCloneCount(uint cardid, uint count);
+    static uint         GetMultiplexCapacity(uint cardid);
+    static bool         IsMultirecAuto(uint cardid);
+    static void         SetMultirecAuto(uint cardid, bool is_auto);
+    static void         UpdateAutoMultirecCounts(const QString &hostname);
     static QString      GetFirewireChangerNode(uint inputid);
     static QString      GetFirewireChangerModel(uint inputid);
 
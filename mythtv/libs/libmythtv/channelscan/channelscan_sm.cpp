@@ -111,6 +111,83 @@ class ScannedChannelInfo
     sdt_map_t         sdts;
 };
 
+void ChannelScanQueue::AddScanner(const ChannelScanSM *scanner)
+{
+    QMutexLocker locker(&lock);
+    scanners.insert(scanner);
+}
+
+/** \fn ChannelScanQueue::AddTransport(uint32_t, const TransportScanItem&)
+ *  \brief Adds a transport to scan, unless the transport with this id
+ *         has already been added or scanned. An id of 0 is always added.
+ */
+bool ChannelScanQueue::AddTransport(uint32_t id, const TransportScanItem &item)
+{
+    QMutexLocker locker(&lock);
+
+    if (id)
+    {
+        if (seen.contains(id))
+            return false;
+        seen.insert(id);
+    }
+
+    pending.push_back(item);
+    total++;
+
+    return true;
+}
+
+void ChannelScanQueue::SetScanned(uint32_t id)
+{
+    QMutexLocker locker(&lock);
+    seen.insert(id);
+}
+
+/** \fn ChannelScanQueue::TakeTransport(const ChannelScanSM*, TransportScanItem&)
+ *  \brief Takes the next transport to scan, returns false and marks the
+ *         scanner as idle when there is none.
+ */
+bool ChannelScanQueue::TakeTransport(const ChannelScanSM *scanner,
+                                     TransportScanItem &item)
+{
+    QMutexLocker locker(&lock);
+
+    if (pending.empty())
+    {
+        busy.remove(scanner);
+        return false;
+    }
+
+    item = pending.takeFirst();
+    busy.insert(scanner);
+    taken++;
+
+    return true;
+}
+
+/// Returns true once no transports are left and every scanner is idle,
+/// so none of them can find any more in a NIT.
+bool ChannelScanQueue::IsDone(void) const
+{
+    QMutexLocker locker(&lock);
+    return pending.empty() && busy.empty();
+}
+
+/// Returns true for the last scanner to finish.
+bool ChannelScanQueue::FinishScanner(const ChannelScanSM *scanner)
+{
+    QMutexLocker locker(&lock);
+    finished.insert(scanner);
+    return finished.size() == scanners.size();
+}
+
+int ChannelScanQueue::PercentComplete(void) const
+{
+    QMutexLocker locker(&lock);
+    return ((taken - busy.size()) * 100) / max(total, 1U);
+}
+
 /** \class ChannelScanSM
  *  \brief Scanning class for cards that support a SignalMonitor class.
  *
@@ -161,6 +238,7 @@ ChannelScanSM::ChannelScanSM(
       // Transports List
       transportsScanned(0),
       currentTestingDecryption(false),
+      scanQueue(NULL),
       // Misc
       channelsFound(999),
       currentInfo(NULL),
@@ -419,6 +497,8 @@ void ChannelScanSM::HandleSDT(uint tsid, const ServiceDescriptionTable *sdt)
 
     uint id = sdt->OriginalNetworkID() << 16 | sdt->TSID();
     ts_scanned.insert(id);
+    if (scanQueue)
+        scanQueue->SetScanned(id);
 
     for (uint i = 0; !currentTestingDecryption && i < sdt->ServiceCount(); i++)
     {
@@ -1539,7 +1619,10 @@ void ChannelScanSM::HandleActiveScan(void)
     if (!HasTimedOut())
         return;
 
-    if (0 == nextIt.offset() && nextIt != scanTransports.begin())
+    // A queued scan idles with current at the end, its last transport
+    // has already been handled then.
+    if (0 == nextIt.offset() && nextIt != scanTransports.begin() &&
+        current != scanTransports.end())
     {
         // Add channel to scanned list and potentially check decryption
         if (do_post_insertion && !UpdateChannelInfo(false))
@@ -1565,6 +1648,10 @@ void ChannelScanSM::HandleActiveScan(void)
         nextIt = current;
         ++nextIt;
     }
+    else if (scanQueue)
+    {
+        HandleQueuedScan();
+    }
     else if (!extend_transports.isEmpty())
     {
         --current;
@@ -1594,6 +1681,65 @@ void ChannelScanSM::HandleActiveScan(void)
     }
 }
 
+/** \fn ChannelScanSM::HandleQueuedScan(void)
+ *  \brief Hands the transports found in the NIT to the other tuners and
+ *         takes the next transport from the queue shared with them.
+ *
+ *   When the queue is empty this waits for the other tuners, as they may
+ *   still add transports from a NIT, and the last tuner to finish reports
+ *   the scan as complete.
+ */
+void ChannelScanSM::HandleQueuedScan(void)
+{
+    QMap<uint32_t,DTVMultiplex>::iterator it = extend_transports.begin();
+    for (; it != extend_transports.end(); ++it)
+    {
+        QString name = QString("TransportID %1").arg(it.key() & 0xffff);
+        TransportScanItem item(sourceID, name, *it, signalTimeout);
+        if (scanQueue->AddTransport(it.key(), item))
+        {
+            LOG(VB_CHANSCAN, LOG_INFO, LOC + "Adding " + name + " - " +
+                item.tuning.toString());
+        }
+    }
+    extend_transports.clear();
+
+    TransportScanItem item;
+    if (scanQueue->TakeTransport(this, item))
+    {
+        LOG(VB_CHANSCAN, LOG_INFO, LOC + "Taking " + item.FriendlyName);
+
+        if (scanTransports.empty())
+        {
+            scanTransports.push_back(item);
+            nextIt = scanTransports.begin();
+        }
+        else
+        {
+            --current;
+            scanTransports.push_back(item);
+            nextIt = current;
+            ++nextIt;
+        }
+        return;
+    }
+
+    // The tables of the last transport are no longer waited for
+    waitingForTables = false;
+
+    if (!scanQueue->IsDone())
+        return; // another tuner may still add transports
+
+    scanning = false;
+    current = nextIt = scanTransports.end();
+
+    if (scanQueue->FinishScanner(this))
+    {
+        scan_monitor->ScanPercentComplete(100);
+        scan_monitor->ScanComplete();
+    }
+}
+
 bool ChannelScanSM::Tune(const transport_scan_items_it_t transport)
 {
     const TransportScanItem &item = *transport;
@@ -1644,7 +1790,17 @@ void ChannelScanSM::ScanTransport(const transport_scan_items_it_t transport)
         scan_monitor->ScanUpdateStatusTitleText(progress);
     }
 
-    scan_monitor->ScanUpdateStatusText(cur_chan);
+    if (scanQueue)
+    {
+        scan_monitor->ScanUpdateTunerStatus(
+            channel->GetCardID(), QObject::tr("%1, %n done", "",
+                                              transportsScanned)
+                                      .arg(cur_chan));
+    }
+    else
+    {
+        scan_monitor->ScanUpdateStatusText(cur_chan);
+    }
     LOG(VB_CHANSCAN, LOG_INFO, LOC + tune_msg_str);
 
     if (!Tune(transport))
@@ -1671,6 +1827,30 @@ void ChannelScanSM::ScanTransport(const transport_scan_items_it_t transport)
     waitingForTables = (item.tuning.sistandard != "analog");
 }
 
+/** \fn ChannelScanSM::SetScanQueue(ChannelScanQueue*, bool)
+ *  \brief Moves the transports to scan into a queue shared with other
+ *         tuners, and from then on takes the transports from the queue.
+ *
+ *   This must be called before StartScanner().
+ */
+void ChannelScanSM::SetScanQueue(ChannelScanQueue *queue, bool follow_nit)
+{
+    scanQueue = queue;
+    scanQueue->AddScanner(this);
+
+    transport_scan_items_t::const_iterator it = scanTransports.begin();
+    for (; it != scanTransports.end(); ++it)
+        scanQueue->AddTransport(0, *it);
+
+    scanTransports.clear();
+    current = nextIt = scanTransports.end();
+
+    extend_scan_list  = follow_nit;
+    waitingForTables  = false;
+    transportsScanned = 0;
+    scanning          = true;
+}
+
 /** \fn ChannelScanSM::StopScanner(void)
  *  \brief Stops the ChannelScanSM event loop and the signal monitor,
  *         blocking until both exit.
@@ -33,6 +33,7 @@
 // Qt includes
 #include <QRunnable>
 #include <QString>
+#include <QMutex>
 #include <QList>
 #include <QPair>
 #include <QMap>
@@ -65,6 +66,40 @@ typedef QPair<transport_scan_items_it_t, ScannedChannelInfo*> ChannelListItem;
 typedef QList<ChannelListItem> ChannelList;
 
 class ChannelScanSM;
+
+/** \class ChannelScanQueue
+ *  \brief Transports shared by the ChannelScanSMs of a scan that uses
+ *         several tuners on the same video source at once.
+ *
+ *   Each scanner takes the next transport when it is done with the last
+ *   one, so a slow transport only holds up its own tuner. Transports seen
+ *   in a NIT are added once, keyed on original network id and transport
+ *   id, and not at all when another tuner has already scanned them.
+ */
+class ChannelScanQueue
+{
+  public:
+    ChannelScanQueue() : taken(0), total(0) { }
+
+    void AddScanner(const ChannelScanSM *scanner);
+    bool AddTransport(uint32_t id, const TransportScanItem &item);
+    void SetScanned(uint32_t id);
+    bool TakeTransport(const ChannelScanSM *scanner, TransportScanItem &item);
+    bool IsDone(void) const;
+    bool FinishScanner(const ChannelScanSM *scanner);
+    int  PercentComplete(void) const;
+
+  private:
+    mutable QMutex              lock;
+    QList<TransportScanItem>    pending;
+    QSet<uint32_t>              seen;     ///< (netid << 16) | tsid
+    QSet<const ChannelScanSM*>  scanners;
+    QSet<const ChannelScanSM*>  busy;     ///< scanning a taken transport
+    QSet<const ChannelScanSM*>  finished;
+    uint                        taken;
+    uint                        total;
+};
+
 class AnalogSignalHandler : public SignalMonitorListener
 {
   public:
@@ -113,6 +148,8 @@ class ChannelScanSM : public MPEGStreamListener,
 
     bool ScanExistingTransports(uint sourceid, bool follow_nit);
 
+    void SetScanQueue(ChannelScanQueue *queue, bool follow_nit);
+
     void SetAnalog(bool is_analog);
     void SetSourceID(int _SourceID)   { sourceID                = _SourceID; }
     void SetSignalTimeout(uint val)    { signalTimeout = val; }
@@ -121,6 +158,8 @@ class ChannelScanSM : public MPEGStreamListener,
 
     uint GetSignalTimeout(void)  const { return signalTimeout; }
     uint GetChannelTimeout(void) const { return channelTimeout; }
+    DTVTunerType GetScanDTVTunerType(void) const { return scanDTVTunerType; }
+    bool IsFollowingNIT(void)    const { return extend_scan_list; }
 
     SignalMonitor    *GetSignalMonitor(void) { return signalMonitor; }
     DTVSignalMonitor *GetDTVSignalMonitor(void);
@@ -166,6 +205,7 @@ class ChannelScanSM : public MPEGStreamListener,
 
     bool HasTimedOut(void);
     void HandleActiveScan(void);
+    void HandleQueuedScan(void);
     bool Tune(const transport_scan_items_it_t transport);
     uint InsertMultiplex(const transport_scan_items_it_t transport);
     void ScanTransport(const transport_scan_items_it_t transport);
@@ -234,6 +274,8 @@ class ChannelScanSM : public MPEGStreamListener,
     QMap<uint, uint>            currentEncryptionStatus;
     QMap<uint, bool>            currentEncryptionStatusChecked;
     QMap<uint64_t, QString>     defAuthorities;
+    /// Transports shared with the other tuners, or NULL
+    ChannelScanQueue           *scanQueue;
 
     /// Found Channel Info
     ChannelList       channelList;
@@ -249,6 +291,12 @@ class ChannelScanSM : public MPEGStreamListener,
 
 inline void ChannelScanSM::UpdateScanPercentCompleted(void)
 {
+    if (scanQueue)
+    {
+        scan_monitor->ScanPercentComplete(scanQueue->PercentComplete());
+        return;
+    }
+
     int tmp = (transportsScanned * 100) /
               (scanTransports.size() + extend_transports.size());
     scan_monitor->ScanPercentComplete(tmp);
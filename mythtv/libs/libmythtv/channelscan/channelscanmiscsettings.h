@@ -120,6 +120,22 @@ class FreeToAirOnly : public CheckBoxSetting, public TransientStorage
     };
 };
 
+class UseAllInputs : public CheckBoxSetting, public TransientStorage
+{
+  public:
+    UseAllInputs() : CheckBoxSetting(this)
+    {
+        setValue(false);
+        setLabel(QObject::tr("Use All Tuners"));
+        setHelpText(
+            QObject::tr(
+                "If set, a full scan is shared out between all the tuners "
+                "connected to this video source which are not in use. "
+                "Whether a tuner is in use can only be checked while the "
+                "master backend is running."));
+    };
+};
+
 class TrustEncSISetting : public CheckBoxSetting, public TransientStorage
 {
   public:
@@ -42,12 +42,15 @@ using namespace std;
 #include "dvbchannel.h"
 #include "v4lchannel.h"
 #include "cardutil.h"
+#include "tvremoteutil.h"
+#include "inputinfo.h"
+#include "mythcorecontext.h"
 
 #define LOC QString("ChScan: ")
 
 ChannelScanner::ChannelScanner() :
     scanMonitor(NULL), channel(NULL), sigmonScanner(NULL), freeboxScanner(NULL),
-    freeToAirOnly(false), serviceRequirements(kRequireAV)
+    scanQueue(NULL), freeToAirOnly(false), serviceRequirements(kRequireAV)
 {
 }
 
@@ -64,6 +67,14 @@ ChannelScanner::~ChannelScanner()
 
 void ChannelScanner::Teardown(void)
 {
+    for (uint i = 0; i < parallelScanners.size(); i++)
+        delete parallelScanners[i];
+    parallelScanners.clear();
+
+    for (uint i = 0; i < parallelChannels.size(); i++)
+        delete parallelChannels[i];
+    parallelChannels.clear();
+
     if (sigmonScanner)
     {
         delete sigmonScanner;
@@ -76,6 +87,12 @@ void ChannelScanner::Teardown(void)
         channel = NULL;
     }
 
+    if (scanQueue)
+    {
+        delete scanQueue;
+        scanQueue = NULL;
+    }
+
 #ifdef USING_IPTV
     if (freeboxScanner)
     {
@@ -103,6 +120,7 @@ void ChannelScanner::Scan(
     bool           do_follow_nit,
     bool           do_test_decryption,
     bool           do_fta_only,
+    bool           do_use_all_inputs,
     ServiceRequirements service_requirements,
     // stuff needed for particular scans
     uint           mplexid /* TransportScan */,
@@ -127,7 +145,17 @@ void ChannelScanner::Scan(
         return;
     }
 
-    sigmonScanner->StartScanner();
+    // The transports of a full scan can be shared out between all the
+    // tuners on this video source, the parallel scanners are started once
+    // the transports to scan are known.
+    bool parallel = do_use_all_inputs &&
+        ((ScanTypeSetting::FullScan_ATSC     == scantype) ||
+         (ScanTypeSetting::FullScan_DVBC     == scantype) ||
+         (ScanTypeSetting::FullScan_DVBT     == scantype) ||
+         (ScanTypeSetting::FullTransportScan == scantype));
+
+    if (!parallel)
+        sigmonScanner->StartScanner();
     scanMonitor->ScanUpdateStatusText("");
 
     bool ok = false;
@@ -227,6 +255,9 @@ void ChannelScanner::Scan(
         ok = sigmonScanner->ScanCurrentTransport(sistandard);
     }
 
+    if (ok && parallel && sigmonScanner)
+        StartParallelScan(cardid, sourceid, do_test_decryption);
+
     if (!ok)
     {
         LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to handle tune complete.");
@@ -298,6 +329,38 @@ bool ChannelScanner::ImportM3U(
     return ok;
 }
 
+static ChannelBase *create_channel(const QString &card_type,
+                                   const QString &device)
+{
+    ChannelBase *channel = NULL;
+
+#ifdef USING_DVB
+    if ("DVB" == card_type)
+        channel = new DVBChannel(device);
+#endif
+
+#ifdef USING_V4L2
+    if (("V4L" == card_type) || ("MPEG" == card_type))
+        channel = new V4LChannel(NULL, device);
+#endif
+
+#ifdef USING_HDHOMERUN
+    if ("HDHOMERUN" == card_type)
+    {
+        channel = new HDHRChannel(NULL, device);
+    }
+#endif // USING_HDHOMERUN
+
+#ifdef USING_ASI
+    if ("ASI" == card_type)
+    {
+        channel = new ASIChannel(NULL, device);
+    }
+#endif // USING_ASI
+
+    return channel;
+}
+
 void ChannelScanner::PreScanCommon(
     int scantype,
     uint cardid,
@@ -347,29 +410,7 @@ void ChannelScanner::PreScanCommon(
         channel_timeout = max(channel_timeout, need_nit * 7 * 1000U);
     }
 
-#ifdef USING_DVB
-    if ("DVB" == card_type)
-        channel = new DVBChannel(device);
-#endif
-
-#ifdef USING_V4L2
-    if (("V4L" == card_type) || ("MPEG" == card_type))
-        channel = new V4LChannel(NULL, device);
-#endif
-
-#ifdef USING_HDHOMERUN
-    if ("HDHOMERUN" == card_type)
-    {
-        channel = new HDHRChannel(NULL, device);
-    }
-#endif // USING_HDHOMERUN
-
-#ifdef USING_ASI
-    if ("ASI" == card_type)
-    {
-        channel = new ASIChannel(NULL, device);
-    }
-#endif // USING_ASI
+    channel = create_channel(card_type, device);
 
     if (!channel)
     {
@@ -442,3 +483,119 @@ void ChannelScanner::PreScanCommon(
 
     MonitorProgress(mon, mon, dvbm, using_rotor);
 }
+
+/** \fn ChannelScanner::StartParallelScan(uint, uint, bool)
+ *  \brief Shares the transports of the scan out between all the tuners
+ *         connected to the video source that can tune on their own.
+ *
+ *   Tuners which share a physical tuner with one already in use, and
+ *   tuners the backend reports as busy, are skipped. Without a connection
+ *   to the master backend only the tuners that can not be opened are
+ *   skipped, so an HDHomeRun tuner in use by a backend may still be used.
+ *   With no other usable tuner the scan just carries on alone.
+ */
+void ChannelScanner::StartParallelScan(
+    uint cardid, uint sourceid, bool do_test_decryption)
+{
+    QString card_type = CardUtil::GetRawCardType(cardid);
+
+    vector<uint> used;
+    used.push_back(cardid);
+
+    vector<uint> cardids = CardUtil::GetCardIDs(sourceid);
+    for (uint i = 0; i < cardids.size(); i++)
+    {
+        uint other = cardids[i];
+        if (find(used.begin(), used.end(), other) != used.end() ||
+            CardUtil::GetRawCardType(other) != card_type)
+        {
+            continue;
+        }
+
+        bool shared = false;
+        for (uint j = 0; j < used.size() && !shared; j++)
+            shared = CardUtil::IsTunerShared(used[j], other);
+        if (shared)
+            continue;
+
+        TunedInputInfo busy_input;
+        if (gCoreContext->IsConnectedToMaster() &&
+            RemoteIsBusy(other, busy_input))
+        {
+            LOG(VB_CHANSCAN, LOG_INFO, LOC +
+                QString("Card %1 is busy, not using it").arg(other));
+            continue;
+        }
+
+        QString device = CardUtil::GetVideoDevice(other);
+        ChannelBase *chan = create_channel(card_type, device);
+        if (!chan)
+            continue;
+
+        chan->SetCardID(other);
+        if (!chan->Open())
+        {
+            LOG(VB_CHANSCAN, LOG_WARNING, LOC +
+                QString("Card %1 could not be opened, not using it")
+                    .arg(other));
+            delete chan;
+            continue;
+        }
+
+        QString inputname =
+            CardUtil::GetInputName(CardUtil::GetInputID(other, sourceid));
+
+        ChannelScanSM *scanner = new ChannelScanSM(
+            scanMonitor, card_type, chan, sourceid,
+            sigmonScanner->GetSignalTimeout(),
+            sigmonScanner->GetChannelTimeout(), inputname,
+            do_test_decryption);
+        scanner->SetScanDTVTunerType(sigmonScanner->GetScanDTVTunerType());
+
+        used.push_back(other);
+        parallelChannels.push_back(chan);
+        parallelScanners.push_back(scanner);
+    }
+
+    if (!parallelScanners.empty())
+    {
+        LOG(VB_CHANSCAN, LOG_INFO, LOC + QString("Scanning with %1 tuners")
+                .arg(parallelScanners.size() + 1));
+
+        bool follow_nit = sigmonScanner->IsFollowingNIT();
+        scanQueue = new ChannelScanQueue();
+        sigmonScanner->SetScanQueue(scanQueue, follow_nit);
+        for (uint i = 0; i < parallelScanners.size(); i++)
+            parallelScanners[i]->SetScanQueue(scanQueue, follow_nit);
+    }
+
+    sigmonScanner->StartScanner();
+    for (uint i = 0; i < parallelScanners.size(); i++)
+        parallelScanners[i]->StartScanner();
+}
+
+/** \fn ChannelScanner::StopScanning(void)
+ *  \brief Stops all the scanners and returns the transports they found.
+ *
+ *   A transport found by more than one tuner is listed once per tuner,
+ *   ChannelImporter merges these like any other duplicate transport.
+ */
+ScanDTVTransportList ChannelScanner::StopScanning(void)
+{
+    ScanDTVTransportList transports;
+    if (!sigmonScanner)
+        return transports;
+
+    sigmonScanner->StopScanner();
+    for (uint i = 0; i < parallelScanners.size(); i++)
+        parallelScanners[i]->StopScanner();
+
+    transports = sigmonScanner->GetChannelList();
+    for (uint i = 0; i < parallelScanners.size(); i++)
+    {
+        ScanDTVTransportList more = parallelScanners[i]->GetChannelList();
+        transports.insert(transports.end(), more.begin(), more.end());
+    }
+
+    return transports;
+}
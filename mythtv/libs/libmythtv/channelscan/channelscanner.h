@@ -36,6 +36,11 @@
 #include "scanmonitor.h"
 #include "channelscantypes.h"
 
+// C++ headers
+#include <vector>
+using namespace std;
+
+class ChannelScanQueue;
 class ScanMonitor;
 class IPTVChannelFetcher;
 class ChannelScanSM;
@@ -61,6 +66,7 @@ class MTV_PUBLIC ChannelScanner
               bool           do_follow_nit,
               bool           do_test_decryption,
               bool           do_fta_only,
+              bool           do_use_all_inputs,
               ServiceRequirements service_requirements,
               // stuff needed for particular scans
               uint           mplexid,
@@ -86,6 +92,10 @@ class MTV_PUBLIC ChannelScanner
         uint sourceid, bool do_ignore_signal_timeout,
         bool do_test_decryption);
 
+    void StartParallelScan(uint cardid, uint sourceid,
+                           bool do_test_decryption);
+    ScanDTVTransportList StopScanning(void);
+
     virtual void MonitorProgress(
         bool /*lock*/, bool /*strength*/, bool /*snr*/, bool /*rotor*/) { }
 
@@ -100,6 +110,11 @@ class MTV_PUBLIC ChannelScanner
     ChannelScanSM      *sigmonScanner;
     IPTVChannelFetcher *freeboxScanner;
 
+    /// Scanners on the other inputs of the video source, if any
+    vector<ChannelScanSM*> parallelScanners;
+    vector<ChannelBase*>   parallelChannels;
+    ChannelScanQueue      *scanQueue;
+
     /// imported channels
     DTVChannelList      channels;
 
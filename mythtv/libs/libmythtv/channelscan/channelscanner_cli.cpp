@@ -59,12 +59,7 @@ void ChannelScannerCLI::HandleEvent(const ScannerEvent *scanEvent)
         else
             cerr<<"HandleEvent(void) -- scan complete"<<endl;
 
-        ScanDTVTransportList transports;
-        if (sigmonScanner)
-        {
-            sigmonScanner->StopScanner();
-            transports = sigmonScanner->GetChannelList();
-        }
+        ScanDTVTransportList transports = StopScanning();
 
         Teardown();
 
@@ -105,12 +105,7 @@ void ChannelScannerGUI::HandleEvent(const ScannerEvent *scanEvent)
             raise(scanEvent->ConfigurableValue());
         }
 
-        ScanDTVTransportList transports;
-        if (sigmonScanner)
-        {
-            sigmonScanner->StopScanner();
-            transports = sigmonScanner->GetChannelList();
-        }
+        ScanDTVTransportList transports = StopScanning();
 
         Teardown();
 
@@ -34,6 +34,7 @@
 
 // Qt headers
 #include <QCoreApplication>
+#include <QStringList>
 
 QEvent::Type ScannerEvent::ScanComplete =
     (QEvent::Type) QEvent::registerEventType();
@@ -119,6 +120,22 @@ void ScanMonitor::ScanUpdateStatusText(const QString &str)
     post_event(this, ScannerEvent::SetStatusText, msg);
 }
 
+/// Updates the status text with the transport each tuner is scanning.
+void ScanMonitor::ScanUpdateTunerStatus(uint cardid, const QString &str)
+{
+    QMutexLocker locker(&tunerStatusLock);
+
+    tunerStatus[cardid] = str;
+
+    QStringList list;
+    QMap<uint, QString>::const_iterator it = tunerStatus.begin();
+    for (; it != tunerStatus.end(); ++it)
+        list.push_back(tr("Tuner %1: %2").arg(it.key()).arg(*it));
+
+    post_event(this, ScannerEvent::SetStatusText,
+               QString("%1 %2").arg(tr("Scanning")).arg(list.join("; ")));
+}
+
 void ScanMonitor::ScanUpdateStatusTitleText(const QString &str)
 {
     post_event(this, ScannerEvent::SetStatusTitleText, str);
@@ -33,6 +33,8 @@
 // Qt headers
 #include <QObject>
 #include <QEvent>
+#include <QMutex>
+#include <QMap>
 
 // MythTV headers
 #include "signalmonitorlistener.h"
@@ -58,6 +60,7 @@ class ScanMonitor :
     // Values from 1-100 of scan completion
     void ScanPercentComplete(int pct);
     void ScanUpdateStatusText(const QString &status);
+    void ScanUpdateTunerStatus(uint cardid, const QString &status);
     void ScanUpdateStatusTitleText(const QString &status);
     void ScanAppendTextToLog(const QString &status);
     void ScanComplete(void);
@@ -78,6 +81,10 @@ class ScanMonitor :
     ~ScanMonitor() { }
 
     ChannelScanner *channelScanner;
+
+    /// Status of each tuner when scanning with several at once
+    QMutex              tunerStatusLock;
+    QMap<uint, QString> tunerStatus;
 };
 
 class Configurable;
@@ -31,7 +31,8 @@ ScanWizardConfig::ScanWizardConfig(
     scanConfig(new ScanOptionalConfig(scanType)),
     services(new DesiredServices()),
     ftaOnly(new FreeToAirOnly()),
-    trustEncSI(new TrustEncSISetting())
+    trustEncSI(new TrustEncSISetting()),
+    allInputs(new UseAllInputs())
 {
     setLabel(tr("Scan Configuration"));
 
@@ -40,6 +41,7 @@ ScanWizardConfig::ScanWizardConfig(
     cfg->addChild(services);
     cfg->addChild(ftaOnly);
     cfg->addChild(trustEncSI);
+    cfg->addChild(allInputs);
 
     addChild(videoSource);
     addChild(input);
@@ -75,6 +77,11 @@ bool ScanWizardConfig::DoFreeToAirOnly(void) const
     return ftaOnly->getValue().toInt();
 }
 
+bool ScanWizardConfig::DoUseAllInputs(void) const
+{
+    return allInputs->getValue().toInt();
+}
+
 bool ScanWizardConfig::DoTestDecryption(void) const
 {
     return trustEncSI->getValue().toInt();
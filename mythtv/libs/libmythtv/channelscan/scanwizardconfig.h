@@ -43,6 +43,7 @@ class ScanNetwork;
 class IgnoreSignalTimeout;
 class DesiredServices;
 class FreeToAirOnly;
+class UseAllInputs;
 class TrustEncSISetting;
 
 class PaneAll;
@@ -170,6 +171,7 @@ class ScanWizardConfig: public VerticalConfigurationGroup
         { return scanConfig->DoFollowNIT(); }
     bool    DoFreeToAirOnly(void)  const;
     bool    DoTestDecryption(void) const;
+    bool    DoUseAllInputs(void)   const;
 
   protected:
     VideoSourceSelector *videoSource;
@@ -179,6 +181,7 @@ class ScanWizardConfig: public VerticalConfigurationGroup
     DesiredServices     *services;
     FreeToAirOnly       *ftaOnly;
     TrustEncSISetting   *trustEncSI;
+    UseAllInputs        *allInputs;
 };
 
 #endif // _SCAN_WIZARD_CONFIG_H_
@@ -38,7 +38,8 @@ DecoderBase::DecoderBase(MythPlayer *parent, const ProgramInfo &pginfo)
       m_positionMapLock(QMutex::Recursive),
       dontSyncPositionMap(false),
 
-      exactseeks(false), livetv(false), watchingrecording(false),
+      exactseeks(false), trickplay(false),
+      livetv(false), watchingrecording(false),
 
       hasKeyFrameAdjustTable(false), lowbuffers(false),
       getrawframes(false), getrawvideo(false),
@@ -479,14 +480,15 @@ uint64_t DecoderBase::SavePositionMapDelta(uint64_t first, uint64_t last)
 
     ctm.start();
     frm_pos_map_t posMap;
-    for (uint i = 0; i < m_positionMap.size(); i++)
+    vector<PosMapEntry>::const_iterator it =
+        lower_bound(m_positionMap.begin(), m_positionMap.end(),
+                    (long long)first, IndexLess);
+    for (; it != m_positionMap.end(); ++it)
     {
-        if ((uint64_t)m_positionMap[i].index < first)
-            continue;
-        if ((uint64_t)m_positionMap[i].index > last)
+        if ((uint64_t)(*it).index > last)
             break;
 
-        posMap[m_positionMap[i].index] = m_positionMap[i].pos;
+        posMap[(*it).index] = (*it).pos;
         saved++;
     }
 
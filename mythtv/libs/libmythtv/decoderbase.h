@@ -102,6 +102,9 @@ class DecoderBase
 
     void setExactSeeks(bool exact) { exactseeks = exact; }
     bool getExactSeeks(void) const { return exactseeks;  }
+    /// Tells the decoder it is only decoding keyframes for fast forward
+    /// or rewind, so that low latency matters more than throughput.
+    void setTrickPlay(bool trick)  { trickplay = trick;  }
     void setLiveTVMode(bool live)  { livetv = live;      }
 
     // Must be done while player is paused.
@@ -151,6 +154,8 @@ class DecoderBase
     virtual QString GetRawEncodingType(void) { return QString(); }
     virtual MythCodecID GetVideoCodecID(void) const = 0;
     virtual void *GetVideoCodecPrivate(void) { return NULL; }
+    /// Returns the time spent in the video codec so far, in microseconds.
+    virtual uint64_t GetVideoDecodeTime(void) const { return 0; }
 
     virtual void ResetPosMap(void);
     virtual bool SyncPositionMap(void);
@@ -225,6 +230,8 @@ class DecoderBase
         long long pos;      // position in stream
     } PosMapEntry;
     long long GetKey(const PosMapEntry &entry) const;
+    static bool IndexLess(const PosMapEntry &entry, long long index)
+        { return entry.index < index; }
 
     MythPlayer *m_parent;
     ProgramInfo *m_playbackinfo;
@@ -258,6 +265,7 @@ class DecoderBase
     bool dontSyncPositionMap;
 
     bool exactseeks;
+    bool trickplay;
     bool livetv;
     bool watchingrecording;
 
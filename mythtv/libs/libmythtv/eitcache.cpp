@@ -5,7 +5,13 @@
  * License: GPL v2
  */
 
+#include <string.h>
+
+#include <algorithm>
+using namespace std;
+
 #include <QDateTime>
+#include <QStringList>
 
 #include "eitcache.h"
 #include "mythcontext.h"
@@ -17,17 +23,34 @@
 // Highest version number. version is 5bits
 const uint EITCache::kVersionMax = 31;
 
+/// Initial number of hash table slots, must be a power of two.
+static const uint kInitialSlots = 1 << 14;
+/// Slots checked for expired entries per IsNewEIT() call.
+static const uint kPruneStep = 64;
+/// Most rows written to eit_cache by one statement.
+static const uint kMaxBulkRows = 200;
+
+/// Marks a slot whose entry was removed, chanid 0xffffffff is never used.
+static const uint64_t kDeletedKey = ~(uint64_t)0;
+
 EITCache::EITCache()
-    : accessCnt(0), hitCnt(0),   tblChgCnt(0),   verChgCnt(0),
+    : keys(NULL), sigs(NULL), capacity(0), used(0), count(0), pruneNext(0),
+      accessCnt(0), hitCnt(0),   tblChgCnt(0),   verChgCnt(0),
       entryCnt(0), pruneCnt(0), prunedHitCnt(0), wrongChannelHitCnt(0)
 {
     // 24 hours ago
     lastPruneTime = QDateTime::currentDateTime().toUTC().toTime_t() - 86400;
+
+    Rehash(kInitialSlots);
+    pruneNext = capacity;
 }
 
 EITCache::~EITCache()
 {
     WriteToDB();
+
+    delete[] keys;
+    delete[] sigs;
 }
 
 void EITCache::ResetStatistics(void)
@@ -49,11 +72,26 @@ QString EITCache::GetStatistics(void) const
         "EITCache::statistics: Accesses: %1, Hits: %2, "
         "Table Upgrades %3, New Versions: %4, Entries: %5 "
         "Pruned entries: %6, pruned Hits: %7 Discard channel Hit %8 "
-        "Hit Ratio %9.")
+        "Hit Ratio %9, ")
         .arg(accessCnt).arg(hitCnt).arg(tblChgCnt).arg(verChgCnt)
         .arg(entryCnt).arg(pruneCnt).arg(prunedHitCnt)
         .arg(wrongChannelHitCnt)
-        .arg((hitCnt+prunedHitCnt+wrongChannelHitCnt)/(double)accessCnt);
+        .arg((hitCnt+prunedHitCnt+wrongChannelHitCnt)/(double)accessCnt) +
+        QString("Cached: %1 in %2 kB.")
+        .arg(count).arg((capacity * 2 * sizeof(uint64_t)) >> 10);
+}
+
+EITCacheStats EITCache::GetCacheStats(void) const
+{
+    QMutexLocker locker(&eventMapLock);
+
+    EITCacheStats stats;
+    stats.accesses = accessCnt;
+    stats.hits     = hitCnt + prunedHitCnt + wrongChannelHitCnt;
+    stats.entries  = count;
+    stats.bytes    = (uint64_t) capacity * 2 * sizeof(uint64_t) +
+                     (uint64_t) dirty.capacity() * sizeof(uint64_t);
+    return stats;
 }
 
 static inline uint64_t construct_sig(uint tableid, uint version,
@@ -83,27 +121,49 @@ static inline bool modified(uint64_t sig)
     return sig >> 63;
 }
 
-static void replace_in_db(int chanid, uint eventid, uint64_t sig)
+static inline uint64_t construct_key(uint chanid, uint eventid)
 {
+    return ((uint64_t) chanid << 32) | eventid;
+}
 
-    MSqlQuery query(MSqlQuery::InitCon());
+static inline uint extract_chanid(uint64_t key)
+{
+    return key >> 32;
+}
 
-    QString qstr =
-        "REPLACE INTO eit_cache "
-        "       ( chanid,  eventid,  tableid,  version,  endtime) "
-        "VALUES (:CHANID, :EVENTID, :TABLEID, :VERSION, :ENDTIME)";
+static inline uint extract_eventid(uint64_t key)
+{
+    return key & 0xffffffff;
+}
 
-    query.prepare(qstr);
-    query.bindValue(":CHANID",   chanid);
-    query.bindValue(":EVENTID",  eventid);
-    query.bindValue(":TABLEID",  extract_table_id(sig));
-    query.bindValue(":VERSION",  extract_version(sig));
-    query.bindValue(":ENDTIME",  extract_endtime(sig));
+/// 64 bit finalizer from MurmurHash3, spreads chanid over the low bits.
+static inline uint64_t hash_key(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/// Writes the collected rows with one REPLACE, then empties rows and bindings.
+static void replace_in_db(MSqlQuery &query, QStringList &rows,
+                          MSqlBindings &bindings)
+{
+    if (rows.empty())
+        return;
+
+    query.prepare(
+        "REPLACE INTO eit_cache "
+        "       ( chanid, eventid, tableid, version, endtime) "
+        "VALUES " + rows.join(", "));
+    query.bindValues(bindings);
+    rows.clear();
+    bindings.clear();
 
     if (!query.exec())
         MythDB::DBError("Error updating eitcache", query);
-
-    return;
 }
 
 static void delete_in_db(uint endtime)
@@ -182,43 +242,58 @@ static bool lock_channel(int chanid, uint lastPruneTime)
     return true;
 }
 
-static void unlock_channel(int chanid, uint updated)
+/** \brief Releases the channel locks and stores how many entries were
+ *         written for each channel.
+ */
+static void unlock_channels(const QMap<uint, uint> &updated)
 {
     MSqlQuery query(MSqlQuery::InitCon());
+    uint now = QDateTime::currentDateTime().toTime_t();
 
-    QString qstr =
-        "DELETE FROM eit_cache "
-        "WHERE chanid  = :CHANID   AND "
-        "      status  = :STATUS";
+    QMap<uint, uint>::const_iterator it = updated.begin();
+    while (it != updated.end())
+    {
+        QStringList  chanids, rows;
+        MSqlBindings bindings;
 
-    query.prepare(qstr);
-    query.bindValue(":CHANID",  chanid);
-    query.bindValue(":STATUS",  CHANNEL_LOCK);
+        for (; it != updated.end() && (uint)rows.size() < kMaxBulkRows; ++it)
+        {
+            const QString prefix = QString(":C%1").arg(rows.size());
+            chanids << QString::number(it.key());
+            rows << QString("(%1CHANID, %1EVENTID, %1ENDTIME, %1STATUS)")
+                .arg(prefix);
+            bindings[prefix + "CHANID"]  = it.key();
+            bindings[prefix + "EVENTID"] = *it;
+            bindings[prefix + "ENDTIME"] = now;
+            bindings[prefix + "STATUS"]  = STATISTIC;
+        }
 
-    if (!query.exec())
-        MythDB::DBError("Error deleting channel lock", query);
+        query.prepare(
+            QString("DELETE FROM eit_cache "
+                    "WHERE status  = :STATUS AND "
+                    "      chanid IN (%1)").arg(chanids.join(",")));
+        query.bindValue(":STATUS", CHANNEL_LOCK);
 
-    // inserting statistics
-    uint now = QDateTime::currentDateTime().toTime_t();
-    qstr = "REPLACE INTO eit_cache "
-           "       ( chanid,  eventid,  endtime,  status) "
-           "VALUES (:CHANID, :EVENTID, :ENDTIME, :STATUS)";
+        if (!query.exec())
+            MythDB::DBError("Error deleting channel lock", query);
 
-    query.prepare(qstr);
-    query.bindValue(":CHANID",   chanid);
-    query.bindValue(":EVENTID",  updated);
-    query.bindValue(":ENDTIME",  now);
-    query.bindValue(":STATUS",   STATISTIC);
+        // inserting statistics
+        query.prepare(
+            "REPLACE INTO eit_cache "
+            "       ( chanid,  eventid,  endtime,  status) "
+            "VALUES " + rows.join(", "));
+        query.bindValues(bindings);
 
-    if (!query.exec())
-        MythDB::DBError("Error inserting eit statistics", query);
+        if (!query.exec())
+            MythDB::DBError("Error inserting eit statistics", query);
+    }
 }
 
 
-event_map_t * EITCache::LoadChannel(uint chanid)
+bool EITCache::LoadChannel(uint chanid)
 {
     if (!lock_channel(chanid, lastPruneTime))
-        return NULL;
+        return false;
 
     MSqlQuery query(MSqlQuery::InitCon());
 
@@ -238,11 +313,10 @@ event_map_t * EITCache::LoadChannel(uint chanid)
     if (!query.exec() || !query.isActive())
     {
         MythDB::DBError("Error loading eitcache", query);
-        return NULL;
+        return false;
     }
 
-    event_map_t * eventMap = new event_map_t();
-
+    uint loaded = 0;
     while (query.next())
     {
         uint eventid = query.value(0).toUInt();
@@ -250,59 +324,184 @@ event_map_t * EITCache::LoadChannel(uint chanid)
         uint version = query.value(2).toUInt();
         uint endtime = query.value(3).toUInt();
 
-        (*eventMap)[eventid] = construct_sig(tableid, version, endtime, false);
+        Insert(construct_key(chanid, eventid),
+               construct_sig(tableid, version, endtime, false));
+        loaded++;
     }
 
-    if (eventMap->size())
+    if (loaded)
         LOG(VB_EIT, LOG_INFO, LOC + QString("Loaded %1 entries for channel %2")
-                .arg(eventMap->size()).arg(chanid));
+                .arg(loaded).arg(chanid));
 
-    entryCnt += eventMap->size();
-    return eventMap;
+    entryCnt += loaded;
+    return true;
 }
 
-void EITCache::WriteChannelToDB(uint chanid)
+/** \brief Returns the slot holding key, or the slot it should go in.
+ *
+ *  An empty slot ends the probe. A deleted slot is returned only if the
+ *  key is not found further along, so that it gets reused.
+ */
+uint EITCache::FindSlot(uint64_t key) const
 {
-    event_map_t * eventMap = channelMap[chanid];
+    uint mask    = capacity - 1;
+    uint slot    = hash_key(key) & mask;
+    uint deleted = capacity;
 
-    if (!eventMap)
+    while (true)
     {
-        channelMap.remove(chanid);
-        return;
+        if (keys[slot] == key)
+            return slot;
+        if (!keys[slot])
+            return (deleted < capacity) ? deleted : slot;
+        if (keys[slot] == kDeletedKey && deleted == capacity)
+            deleted = slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+void EITCache::Insert(uint64_t key, uint64_t sig)
+{
+    // keep at least a quarter of the slots empty so probes stay short
+    if ((used + 1) * 4 > capacity * 3)
+        Rehash((count * 2 > capacity / 2) ? capacity * 2 : capacity);
+
+    uint slot = FindSlot(key);
+    if (keys[slot] != key)
+    {
+        if (!keys[slot])
+            used++;
+        count++;
+        keys[slot] = key;
+        sigs[slot] = 0;
     }
 
-    uint size    = eventMap->size();
-    uint updated = 0;
+    if (modified(sig) && !modified(sigs[slot]))
+        dirty.push_back(key);
 
-    event_map_t::iterator it = eventMap->begin();
-    while (it != eventMap->end())
+    sigs[slot] = sig;
+}
+
+/// Moves all live entries into a new table, dropping the deleted slots.
+void EITCache::Rehash(uint new_capacity)
+{
+    uint64_t *old_keys = keys;
+    uint64_t *old_sigs = sigs;
+    uint      old_capacity = capacity;
+
+    keys     = new uint64_t[new_capacity];
+    sigs     = new uint64_t[new_capacity];
+    capacity = new_capacity;
+    used     = 0;
+    count    = 0;
+    memset(keys, 0, capacity * sizeof(uint64_t));
+
+    for (uint i = 0; i < old_capacity; i++)
+    {
+        if (!old_keys[i] || old_keys[i] == kDeletedKey)
+            continue;
+        uint slot = FindSlot(old_keys[i]);
+        keys[slot] = old_keys[i];
+        sigs[slot] = old_sigs[i];
+        used++;
+        count++;
+    }
+
+    if (old_capacity)
     {
-        if (modified(*it) && extract_endtime(*it) > lastPruneTime)
+        LOG(VB_EIT, LOG_DEBUG, LOC + QString("Rehashed %1 entries into %2 "
+                                             "slots").arg(count).arg(capacity));
+    }
+
+    // a prune in progress has to start over on the new layout
+    if (pruneNext < old_capacity)
+        pruneNext = 0;
+
+    delete[] old_keys;
+    delete[] old_sigs;
+}
+
+/// Removes the expired entries from the next few slots.
+void EITCache::PruneSome(uint slots)
+{
+    uint end = min(pruneNext + slots, capacity);
+    for (; pruneNext < end; pruneNext++)
+    {
+        if (!keys[pruneNext] || keys[pruneNext] == kDeletedKey)
+            continue;
+
+        if (extract_endtime(sigs[pruneNext]) < lastPruneTime)
         {
-            replace_in_db(chanid, it.key(), *it);
-            updated++;
-            *it &= ~(uint64_t)0 >> 1; // mark as synced
+            keys[pruneNext] = kDeletedKey;
+            count--;
+            pruneCnt++;
         }
-        ++it;
     }
-    unlock_channel(chanid, updated);
-
-    if (updated)
-        LOG(VB_EIT, LOG_INFO, LOC + QString("Wrote %1 modified entries of %2 "
-                                      "for channel %3 to database.")
-                .arg(updated).arg(size).arg(chanid));
 }
 
 void EITCache::WriteToDB(void)
 {
     QMutexLocker locker(&eventMapLock);
 
-    key_map_t::iterator it = channelMap.begin();
-    while (it != channelMap.end())
+    MSqlQuery        query(MSqlQuery::InitCon());
+    QStringList      rows;
+    MSqlBindings     bindings;
+    QMap<uint, uint> updated;
+
+    // every loaded channel gets unlocked, as before, and the channels
+    // that could not be locked are forgotten so they are tried again
+    QMap<uint, bool>::iterator cit = channelMap.begin();
+    while (cit != channelMap.end())
+    {
+        if (*cit)
+        {
+            updated[cit.key()] = 0;
+            ++cit;
+        }
+        else
+        {
+            cit = channelMap.erase(cit);
+        }
+    }
+
+    for (int i = 0; i < dirty.size(); i++)
     {
-        WriteChannelToDB(it.key());
-        ++it;
+        uint slot = FindSlot(dirty[i]);
+        if (keys[slot] != dirty[i] || !modified(sigs[slot]))
+            continue;
+
+        uint64_t sig = sigs[slot];
+        sigs[slot] &= ~(uint64_t)0 >> 1; // mark as synced
+
+        if (extract_endtime(sig) <= lastPruneTime)
+            continue;
+
+        const QString prefix = QString(":E%1").arg(rows.size());
+        rows << QString("(%1CHANID, %1EVENTID, %1TABLEID, %1VERSION, "
+                        "%1ENDTIME)").arg(prefix);
+        bindings[prefix + "CHANID"]  = extract_chanid(dirty[i]);
+        bindings[prefix + "EVENTID"] = extract_eventid(dirty[i]);
+        bindings[prefix + "TABLEID"] = extract_table_id(sig);
+        bindings[prefix + "VERSION"] = extract_version(sig);
+        bindings[prefix + "ENDTIME"] = extract_endtime(sig);
+        updated[extract_chanid(dirty[i])]++;
+
+        if ((uint)rows.size() >= kMaxBulkRows)
+            replace_in_db(query, rows, bindings);
     }
+    replace_in_db(query, rows, bindings);
+
+    if (!dirty.empty())
+    {
+        LOG(VB_EIT, LOG_INFO, LOC + QString("Wrote %1 modified entries "
+                                            "for %2 channels to database.")
+                .arg(dirty.size()).arg(updated.size()));
+    }
+
+    // QVector::clear() frees the memory, resize keeps it for the next round
+    dirty.resize(0);
+
+    unlock_channels(updated);
 }
 
 
@@ -329,29 +528,33 @@ bool EITCache::IsNewEIT(uint chanid,  uint tableid,   uint version,
         return false;
 
     QMutexLocker locker(&eventMapLock);
-    if (!channelMap.contains(chanid))
-    {
-        channelMap[chanid] = LoadChannel(chanid);
-    }
 
-    if (!channelMap[chanid])
+    if (pruneNext < capacity)
+        PruneSome(kPruneStep);
+
+    QMap<uint, bool>::iterator cit = channelMap.find(chanid);
+    if (cit == channelMap.end())
+        cit = channelMap.insert(chanid, LoadChannel(chanid));
+
+    if (!*cit)
     {
         wrongChannelHitCnt++;
         return false;
     }
 
-    event_map_t * eventMap = channelMap[chanid];
-    event_map_t::iterator it = eventMap->find(eventid);
-    if (it != eventMap->end())
+    uint64_t key  = construct_key(chanid, eventid);
+    uint     slot = FindSlot(key);
+    if (keys[slot] == key)
     {
-        if (extract_table_id(*it) > tableid)
+        uint64_t sig = sigs[slot];
+        if (extract_table_id(sig) > tableid)
         {
             // EIT from lower (ie. better) table number
             tblChgCnt++;
         }
-        else if ((extract_table_id(*it) == tableid) &&
-                 ((extract_version(*it) < version) ||
-                  ((extract_version(*it) == kVersionMax) &&
+        else if ((extract_table_id(sig) == tableid) &&
+                 ((extract_version(sig) < version) ||
+                  ((extract_version(sig) == kVersionMax) &&
                    version < kVersionMax)))
         {
             // EIT updated version on current table
@@ -365,7 +568,7 @@ bool EITCache::IsNewEIT(uint chanid,  uint tableid,   uint version,
         }
     }
 
-    eventMap->insert(eventid, construct_sig(tableid, version, endtime, true));
+    Insert(key, construct_sig(tableid, version, endtime, true));
     entryCnt++;
 
     return true;
@@ -388,12 +591,17 @@ uint EITCache::PruneOldEntries(uint timestamp)
 
     lastPruneTime  = timestamp;
 
-    // Write all modified entries to DB and start with a clean cache
+    // Write all modified entries to DB
     WriteToDB();
 
     // Prune old entries in the DB
     delete_in_db(timestamp);
 
+    // The cached entries are pruned a few at a time by IsNewEIT(), a full
+    // pass here would stall the EIT thread on a large cache.
+    QMutexLocker locker(&eventMapLock);
+    pruneNext = 0;
+
     return 0;
 }
 
@@ -10,15 +10,37 @@
 
 // Qt headers
 #include <QString>
+#include <QVector>
 #include <QMutex>
 #include <QMap>
 
 // MythTV headers
 #include "mythtvexp.h"
 
-typedef QMap<uint, uint64_t> event_map_t;
-typedef QMap<uint, event_map_t*> key_map_t;
+/// Counters of the EIT cache, as shown on the backend status page.
+class MTV_PUBLIC EITCacheStats
+{
+  public:
+    EITCacheStats() : accesses(0), hits(0), entries(0), bytes(0) { }
 
+    double HitRatio(void) const
+        { return (accesses) ? (double) hits / accesses : 0.0; }
+
+    uint     accesses;  ///< events looked up since the last reset
+    uint     hits;      ///< events that were already known
+    uint     entries;   ///< events currently cached
+    uint64_t bytes;     ///< memory used by the hash table
+};
+
+/** \class EITCache
+ *  \brief Remembers which EIT events have already been seen.
+ *
+ *  The events are kept in one open addressing hash table keyed by chanid
+ *  and event id. Each slot packs the table id, version and end time into
+ *  64 bits. Changed entries are remembered in a dirty list, so writing
+ *  them to the eit_cache table does not have to walk the whole cache.
+ *  Expired entries are pruned a few slots at a time as events come in.
+ */
 class EITCache
 {
   public:
@@ -33,13 +55,27 @@ class EITCache
 
     void ResetStatistics(void);
     QString GetStatistics(void) const;
+    EITCacheStats GetCacheStats(void) const;
 
   private:
-    event_map_t * LoadChannel(uint chanid);
-    void WriteChannelToDB(uint chanid);
-
-    // event key cache
-    key_map_t   channelMap;
+    bool LoadChannel(uint chanid);
+
+    uint FindSlot(uint64_t key) const;
+    void Insert(uint64_t key, uint64_t sig);
+    void Rehash(uint capacity);
+    void PruneSome(uint slots);
+
+    // per channel state, false if another backend holds the channel lock
+    QMap<uint, bool> channelMap;
+
+    // event hash table, keys[i] of 0 is an empty slot
+    uint64_t   *keys;
+    uint64_t   *sigs;
+    uint        capacity;   ///< number of slots, always a power of two
+    uint        used;       ///< live entries plus deleted slots
+    uint        count;      ///< live entries
+    uint        pruneNext;  ///< next slot to check for expired entries
+    QVector<uint64_t> dirty; ///< keys of entries not yet in the database
 
     mutable QMutex eventMapLock;
     uint            lastPruneTime;
@@ -9,6 +9,45 @@
 #include "programinfo.h" // for subtitle types and audio and video properties
 #include "dishdescriptors.h" // for dish_theme_type_to_string
 
+// Qt headers
+#include <QDataStream>
+
+/** \brief Returns the position of \a exp in \a str, or -1 without running
+ *         the expression when \a str lacks \a literal.
+ *
+ *  \a literal must be a part of every string \a exp can match.
+ */
+static inline int index_of(const QString &str, const QRegExp &exp,
+                           const QString &literal,
+                           Qt::CaseSensitivity cs = Qt::CaseSensitive)
+{
+    return str.contains(literal, cs) ? str.indexOf(exp) : -1;
+}
+
+/// Same as index_of(), but leaves the captures in \a exp.
+static inline int index_in(const QString &str, QRegExp &exp,
+                           const QString &literal,
+                           Qt::CaseSensitivity cs = Qt::CaseSensitive)
+{
+    return str.contains(literal, cs) ? exp.indexIn(str) : -1;
+}
+
+/// m_ukSeries matches "n of m" or "n/m", in any case.
+static inline int uk_index_of_series(const QString &str, QRegExp &exp)
+{
+    if (!str.contains('/') && !str.contains("of", Qt::CaseInsensitive))
+        return -1;
+    return exp.indexIn(str);
+}
+
+/// Returns a non-greedy copy of \a pattern, set once rather than per event.
+static QRegExp minimal_regexp(const QString &pattern)
+{
+    QRegExp exp(pattern);
+    exp.setMinimal(true);
+    return exp;
+}
+
 /*------------------------------------------------------------------------
  * Event Fix Up Scripts - Turned on by entry in dtv_privatetype table
  *------------------------------------------------------------------------*/
@@ -31,7 +70,7 @@ EITFixUp::EITFixUp()
       m_dishDescriptionFinale2("\\s*Finale\\.\\s*"),
       m_dishDescriptionPremiere("\\s*(Series|Season)\\s(Premier|Premiere)\\.\\s*"),
       m_dishDescriptionPremiere2("\\s*(Premier|Premiere)\\.\\s*"),
-      m_dishPPVCode("\\s*\\(([A-Z]|[0-9]){5}\\)\\s*$"),
+      m_dishPPVCode("\\s*\\(([A-Z]|[0-9]){5}\\)\\s*$", Qt::CaseInsensitive),
       m_ukThen("\\s*(Then|Followed by) 60 Seconds\\.", Qt::CaseInsensitive),
       m_ukNew("(New\\.|\\s*(Brand New|New)\\s*(Series|Episode)\\s*[:\\.\\-])",Qt::CaseInsensitive),
       m_ukCEPQ("[:\\!\\.\\?]"),
@@ -88,11 +127,12 @@ EITFixUp::EITFixUp()
       m_mcaDD(",?\\sDD\\.?"),
       m_RTLrepeat("(\\(|\\s)?Wiederholung.+vo[m|n].+((?:\\d{2}\\.\\d{2}\\.\\d{4})|(?:\\d{2}[:\\.]\\d{2}\\sUhr))\\)?"),
       m_RTLSubtitle("^([^\\.]{3,})\\.\\s+(.+)"),
-      m_RTLSubtitle1("^Folge\\s(\\d{1,4})\\s*:\\s+'(.*)'(?:\\.\\s*|$)"),
+      m_RTLSubtitle1(minimal_regexp(
+                         "^Folge\\s(\\d{1,4})\\s*:\\s+'(.*)'(?:\\.\\s*|$)")),
       m_RTLSubtitle2("^Folge\\s(\\d{1,4})\\s+(.{,5}[^\\.]{,120})[\\?!\\.]\\s*"),
       m_RTLSubtitle3("^(?:Folge\\s)?(\\d{1,4}(?:\\/[IVX]+)?)\\s+(.{,5}[^\\.]{,120})[\\?!\\.]\\s*"),
       m_RTLSubtitle4("^Thema.{0,5}:\\s([^\\.]+)\\.\\s*"),
-      m_RTLSubtitle5("^'(.+)'\\.\\s*"),
+      m_RTLSubtitle5(minimal_regexp("^'(.+)'\\.\\s*")),
       m_RTLEpisodeNo1("^(Folge\\s\\d{1,4})\\.*\\s*"),
       m_RTLEpisodeNo2("^(\\d{1,2}\\/[IVX]+)\\.*\\s*"),
       m_fiRerun("\\ ?Uusinta[a-zA-Z\\ ]*\\.?"),
@@ -213,6 +253,47 @@ void EITFixUp::Fix(DBEventEIT &event) const
     }
 }
 
+/** \brief Writes out the fields an event is created with, so that it can
+ *         be read back with ReadEvent() and fixed up again.
+ *
+ *  Call this before Fix(), the stream version should be set by the caller.
+ */
+void EITFixUp::DumpEvent(QDataStream &out, const DBEventEIT &event)
+{
+    out << (quint32) event.chanid << (quint32) event.fixup
+        << event.title << event.subtitle << event.description
+        << event.category << (quint8) event.categoryType
+        << event.starttime << event.endtime
+        << (quint8) event.subtitleType << (quint8) event.audioProps
+        << (quint8) event.videoProps << event.stars
+        << event.seriesId << event.programId;
+}
+
+/** \brief Reads an event written by DumpEvent().
+ *  \return new event, or NULL at the end of the stream or on an error.
+ */
+DBEventEIT *EITFixUp::ReadEvent(QDataStream &in)
+{
+    quint32   chanid, fixup;
+    QString   title, subtitle, description, category, seriesId, programId;
+    quint8    categoryType, subtitleType, audioProps, videoProps;
+    QDateTime starttime, endtime;
+    float     stars;
+
+    in >> chanid >> fixup >> title >> subtitle >> description
+       >> category >> categoryType >> starttime >> endtime
+       >> subtitleType >> audioProps >> videoProps >> stars
+       >> seriesId >> programId;
+
+    if (in.status() != QDataStream::Ok)
+        return NULL;
+
+    return new DBEventEIT(chanid, title, subtitle, description,
+                          category, categoryType, starttime, endtime,
+                          fixup, subtitleType, audioProps, videoProps,
+                          stars, seriesId, programId);
+}
+
 /**
  *  This adds a DVB EIT default authority to series id or program id if
  *  one exists in the DB for that channel, otherwise it returns a blank
@@ -333,7 +414,7 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // See if a year is present as (xxxx)
-    position = event.description.indexOf(m_bellYear);
+    position = index_of(event.description, m_bellYear, "(");
     if (position != -1 && !event.category.isEmpty())
     {
         tmp = "";
@@ -372,7 +453,7 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Check for (Stereo) in the decription and set the <audio> tags
-    position = event.description.indexOf(m_Stereo);
+    position = index_of(event.description, m_Stereo, "tereo");
     if (position != -1)
     {
         event.audioProps |= AUD_STEREO;
@@ -380,7 +461,7 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Check for "title (All Day, HD)" in the title
-    position = event.title.indexOf(m_bellPPVTitleAllDayHD);
+    position = index_of(event.title, m_bellPPVTitleAllDayHD, "(All Day");
     if (position != -1)
     {
         event.title = event.title.replace(m_bellPPVTitleAllDayHD, "");
@@ -388,14 +469,14 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
      }
 
     // Check for "title (All Day)" in the title
-    position = event.title.indexOf(m_bellPPVTitleAllDay);
+    position = index_of(event.title, m_bellPPVTitleAllDay, "(All Day");
     if (position != -1)
     {
         event.title = event.title.replace(m_bellPPVTitleAllDay, "");
     }
 
     // Check for "HD - title" in the title
-    position = event.title.indexOf(m_bellPPVTitleHD);
+    position = index_of(event.title, m_bellPPVTitleHD, "HD");
     if (position != -1)
     {
         event.title = event.title.replace(m_bellPPVTitleHD, "");
@@ -419,7 +500,7 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Check for HD at the end of the title
-    position = event.title.indexOf(m_dishPPVTitleHD);
+    position = index_of(event.title, m_dishPPVTitleHD, "HD");
     if (position != -1)
     {
         event.title = event.title.replace(m_dishPPVTitleHD, "");
@@ -444,14 +525,14 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Remove any trailing colon in title
-    position = event.title.indexOf(m_dishPPVTitleColon);
+    position = index_of(event.title, m_dishPPVTitleColon, ":");
     if (position != -1)
     {
         event.title = event.title.replace(m_dishPPVTitleColon, "");
     }
 
     // Remove New at the end of the description
-    position = event.description.indexOf(m_dishDescriptionNew);
+    position = index_of(event.description, m_dishDescriptionNew, "New.");
     if (position != -1)
     {
         event.previouslyshown = false;
@@ -459,7 +540,8 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Remove Series Finale at the end of the desciption
-    position = event.description.indexOf(m_dishDescriptionFinale);
+    position = index_of(event.description, m_dishDescriptionFinale,
+                        "Finale.");
     if (position != -1)
     {
         event.previouslyshown = false;
@@ -467,7 +549,8 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Remove Series Finale at the end of the desciption
-    position = event.description.indexOf(m_dishDescriptionFinale2);
+    position = index_of(event.description, m_dishDescriptionFinale2,
+                        "Finale.");
     if (position != -1)
     {
         event.previouslyshown = false;
@@ -475,7 +558,8 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Remove Series Premiere at the end of the description
-    position = event.description.indexOf(m_dishDescriptionPremiere);
+    position = index_of(event.description, m_dishDescriptionPremiere,
+                        "Premier");
     if (position != -1)
     {
         event.previouslyshown = false;
@@ -483,7 +567,8 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Remove Series Premiere at the end of the description
-    position = event.description.indexOf(m_dishDescriptionPremiere2);
+    position = index_of(event.description, m_dishDescriptionPremiere2,
+                        "Premier");
     if (position != -1)
     {
         event.previouslyshown = false;
@@ -491,44 +576,44 @@ void EITFixUp::FixBellExpressVu(DBEventEIT &event) const
     }
 
     // Remove Dish's PPV code at the end of the description
-    QRegExp ppvcode = m_dishPPVCode;
-    ppvcode.setCaseSensitivity(Qt::CaseInsensitive);
-    position = event.description.indexOf(ppvcode);
+    position = index_of(event.description, m_dishPPVCode, "(");
     if (position != -1)
     {
-        event.description = event.description.replace(ppvcode, "");
+        event.description = event.description.replace(m_dishPPVCode, "");
     }
 
     // Remove trailing garbage
-    position = event.description.indexOf(m_dishPPVSpacePerenEnd);
+    position = index_of(event.description, m_dishPPVSpacePerenEnd, ")");
     if (position != -1)
     {
         event.description = event.description.replace(m_dishPPVSpacePerenEnd, "");
     }
 
     // Check for subtitle "All Day (... Eastern)" in the subtitle
-    position = event.subtitle.indexOf(m_bellPPVSubtitleAllDay);
+    position = index_of(event.subtitle, m_bellPPVSubtitleAllDay, "All Day");
     if (position != -1)
     {
         event.subtitle = event.subtitle.replace(m_bellPPVSubtitleAllDay, "");
     }
 
     // Check for description "(... Eastern)" in the description
-    position = event.description.indexOf(m_bellPPVDescriptionAllDay);
+    position = index_of(event.description, m_bellPPVDescriptionAllDay,
+                        "Eastern)");
     if (position != -1)
     {
         event.description = event.description.replace(m_bellPPVDescriptionAllDay, "");
     }
 
     // Check for description "(... ET)" in the description
-    position = event.description.indexOf(m_bellPPVDescriptionAllDay2);
+    position = index_of(event.description, m_bellPPVDescriptionAllDay2,
+                        "ET)");
     if (position != -1)
     {
         event.description = event.description.replace(m_bellPPVDescriptionAllDay2, "");
     }
 
     // Check for description "(nnnnn)" in the description
-    position = event.description.indexOf(m_bellPPVDescriptionEventId);
+    position = index_of(event.description, m_bellPPVDescriptionEventId, "(");
     if (position != -1)
     {
         event.description = event.description.replace(m_bellPPVDescriptionEventId, "");
@@ -607,7 +692,7 @@ void EITFixUp::SetUKSubtitle(DBEventEIT &event) const
          }
     }
     QRegExp tmpQuotedSubtitle = m_ukQuotedSubtitle;
-    if (tmpQuotedSubtitle.indexIn(event.description) != -1)
+    if (index_in(event.description, tmpQuotedSubtitle, "'") != -1)
     {
         event.subtitle = tmpQuotedSubtitle.cap(1);
         event.description.remove(m_ukQuotedSubtitle);
@@ -676,25 +761,34 @@ void EITFixUp::FixUK(DBEventEIT &event) const
 
     bool isMovie = event.category.startsWith("Movie",Qt::CaseInsensitive);
     // BBC three case (could add another record here ?)
-    event.description = event.description.remove(m_ukThen);
-    event.description = event.description.remove(m_ukNew);
+    if (event.description.contains("60 Seconds", Qt::CaseInsensitive))
+        event.description = event.description.remove(m_ukThen);
+    if (event.description.contains("New", Qt::CaseInsensitive))
+        event.description = event.description.remove(m_ukNew);
 
     // Removal of Class TV, CBBC and CBeebies etc..
-    event.title = event.title.remove(m_ukTitleRemove);
-    event.description = event.description.remove(m_ukDescriptionRemove);
+    if (event.title.contains(':'))
+        event.title = event.title.remove(m_ukTitleRemove);
+    if (event.description.startsWith("CB") ||
+        event.description.startsWith("Class TV") ||
+        event.description.startsWith("BBC Switch"))
+        event.description = event.description.remove(m_ukDescriptionRemove);
 
     // Removal of BBC FOUR and BBC THREE
-    event.description = event.description.remove(m_ukBBC34);
+    if (event.description.contains(" on BBC ", Qt::CaseInsensitive))
+        event.description = event.description.remove(m_ukBBC34);
 
     // BBC 7 [Rpt of ...] case.
-    event.description = event.description.remove(m_ukBBC7rpt);
+    if (event.description.contains("[Rpt"))
+        event.description = event.description.remove(m_ukBBC7rpt);
 
     // "All New To 4Music!
-    event.description = event.description.remove(m_ukAllNew);
+    if (event.description.contains("4Music!"))
+        event.description = event.description.remove(m_ukAllNew);
 
     // Remove [AD,S] etc.
     QRegExp tmpCC = m_ukCC;
-    if ((position1 = tmpCC.indexIn(event.description)) != -1)
+    if ((position1 = index_in(event.description, tmpCC, "[")) != -1)
     {
         QStringList tmpCCitems = tmpCC.cap(0).remove("[").remove("]").split(",");
         if (tmpCCitems.contains("AD"))
@@ -711,10 +805,10 @@ void EITFixUp::FixUK(DBEventEIT &event) const
     event.title       = event.title.trimmed();
     event.description = event.description.trimmed();
 
-    // Work out the episode numbers (if any)
+    // Work out the episode numbers (if any), these need an "of" or a '/'
     bool    series  = false;
     QRegExp tmpExp1 = m_ukSeries;
-    if ((position1 = tmpExp1.indexIn(event.title)) != -1)
+    if ((position1 = uk_index_of_series(event.title, tmpExp1)) != -1)
     {
         if ((tmpExp1.cap(1).toUInt() <= tmpExp1.cap(2).toUInt())
             && tmpExp1.cap(2).toUInt()<=50)
@@ -727,7 +821,8 @@ void EITFixUp::FixUK(DBEventEIT &event) const
             series = true;
         }
     }
-    else if ((position1 = tmpExp1.indexIn(event.description)) != -1)
+    else if ((position1 = uk_index_of_series(event.description,
+                                             tmpExp1)) != -1)
     {
         if ((tmpExp1.cap(1).toUInt() <= tmpExp1.cap(2).toUInt())
             && tmpExp1.cap(2).toUInt()<=50)
@@ -744,7 +839,7 @@ void EITFixUp::FixUK(DBEventEIT &event) const
         event.categoryType = kCategorySeries;
 
     QRegExp tmpStarring = m_ukStarring;
-    if (tmpStarring.indexIn(event.description) != -1)
+    if (index_in(event.description, tmpStarring, "tarring ") != -1)
     {
         // if we match this we've captured 2 actors and an (optional) airdate
         event.AddPerson(DBPerson::kActor, tmpStarring.cap(1));
@@ -764,8 +859,9 @@ void EITFixUp::FixUK(DBEventEIT &event) const
     QRegExp tmp24ep = m_uk24ep;
     if (!event.title.startsWith("CSI:") && !event.title.startsWith("CD:"))
     {
-        if (((position1=event.title.indexOf(m_ukDoubleDotEnd)) != -1) &&
-            ((position2=event.description.indexOf(m_ukDoubleDotStart)) != -1))
+        if (((position1=index_of(event.title, m_ukDoubleDotEnd, "..")) != -1) &&
+            ((position2=index_of(event.description,
+                                 m_ukDoubleDotStart, "..")) != -1))
         {
             QString strPart=event.title.remove(m_ukDoubleDotEnd)+" ";
             strFull = strPart + event.description.remove(m_ukDoubleDotStart);
@@ -797,7 +893,8 @@ void EITFixUp::FixUK(DBEventEIT &event) const
                 }
             }
         }
-        else if ((position1 = tmp24ep.indexIn(event.description)) != -1)
+        else if ((position1 = index_in(event.description,
+                                       tmp24ep, ":00")) != -1)
         {
             // Special case for episodes of 24.
             // -2 from the length cause we don't want ": " on the end
@@ -807,7 +904,8 @@ void EITFixUp::FixUK(DBEventEIT &event) const
         }
         else if ((position1 = event.description.indexOf(m_ukTime)) == -1)
         {
-            if (!isMovie && (event.title.indexOf(m_ukYearColon) < 0))
+            if (!isMovie &&
+                (index_of(event.title, m_ukYearColon, ":") < 0))
             {
                 if (((position1 = event.title.indexOf(":")) != -1) &&
                     (event.description.indexOf(":") < 0 ))
@@ -916,7 +1014,7 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
     int pos;
     QRegExp tmpSeries1 = m_comHemSeries1;
     QRegExp tmpSeries2 = m_comHemSeries2;
-    if ((pos = tmpSeries2.indexIn(event.title)) != -1)
+    if ((pos = index_in(event.title, tmpSeries2, "el")) != -1)
     {
         QStringList list = tmpSeries2.capturedTexts();
         event.partnumber = list[2].toUInt();
@@ -954,7 +1052,7 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
 
     // Move subtitle info from title to subtitle
     QRegExp tmpTSub = m_comHemTSub;
-    if (tmpTSub.indexIn(event.title) != -1)
+    if (index_in(event.title, tmpTSub, "-") != -1)
     {
         event.subtitle = tmpTSub.cap(1);
         event.title = event.title.replace(tmpTSub.cap(0),"");
@@ -1033,7 +1131,7 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
 
     // Look for additional persons in the description
     QRegExp tmpPersons = m_comHemPersons;
-    while(pos = tmpPersons.indexIn(event.description),pos!=-1)
+    while(pos = index_in(event.description, tmpPersons, ":"),pos!=-1)
     {
         DBPerson::Role role;
         QStringList list = tmpPersons.capturedTexts();
@@ -1086,7 +1184,7 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
     }
 
     // Teletext subtitles?
-    int position = event.description.indexOf(m_comHemTT);
+    int position = index_of(event.description, m_comHemTT, "ext-");
     if (position != -1)
     {
         event.subtitleType |= SUB_NORMAL;
@@ -1094,7 +1192,7 @@ void EITFixUp::FixComHem(DBEventEIT &event, bool process_subtitle) const
 
     // Try to findout if this is a rerun and if so the date.
     QRegExp tmpRerun1 = m_comHemRerun1;
-    if (tmpRerun1.indexIn(event.description) == -1)
+    if (index_in(event.description, tmpRerun1, "epris") == -1)
         return;
 
     // Rerun from today
@@ -1173,7 +1271,7 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
 
     // Replace incomplete title if the full one is in the description
     tmpExp1 = m_mcaIncompleteTitle;
-    if (tmpExp1.indexIn(event.title) != -1)
+    if (index_in(event.title, tmpExp1, "...") != -1)
     {
         tmpExp1 = QRegExp( QString(m_mcaCompleteTitlea.pattern() + tmpExp1.cap(1) +
                                    m_mcaCompleteTitleb.pattern()));
@@ -1188,7 +1286,7 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
 
     // Try to find subtitle in description
     tmpExp1 = m_mcaSubtitle;
-    if ((position = tmpExp1.indexIn(event.description)) != -1)
+    if ((position = index_in(event.description, tmpExp1, "'")) != -1)
     {
         uint tmpExp1Len = tmpExp1.cap(1).length();
         uint evDescLen = max(event.description.length(), 1);
@@ -1203,7 +1301,7 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
 
     // Try to find episode numbers in subtitle
     tmpExp1 = m_mcaSeries;
-    if ((position = tmpExp1.indexIn(event.subtitle)) != -1)
+    if ((position = index_in(event.subtitle, tmpExp1, "/")) != -1)
     {
         uint season    = tmpExp1.cap(1).toUInt();
         uint episode   = tmpExp1.cap(2).toUInt();
@@ -1214,7 +1312,7 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
     }
 
     // Close captioned?
-    position = event.description.indexOf(m_mcaCC);
+    position = index_of(event.description, m_mcaCC, " Subtitles");
     if (position > 0)
     {
         event.subtitleType |= SUB_HARDHEAR;
@@ -1222,7 +1320,7 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
     }
 
     // Dolby Digital 5.1?
-    position = event.description.indexOf(m_mcaDD);
+    position = index_of(event.description, m_mcaDD, "DD");
     if ((position > 0) && (position > (int) (event.description.length() - 7)))
     {
         event.audioProps |= AUD_DOLBY;
@@ -1230,12 +1328,13 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
     }
 
     // Remove bouquet tags
-    event.description.replace(m_mcaAvail, "");
+    if (event.description.contains(" available "))
+        event.description.replace(m_mcaAvail, "");
 
     // Try to find year and director from the end of the description
     bool isMovie = false;
     tmpExp1  = m_mcaCredits;
-    position = tmpExp1.indexIn(event.description);
+    position = index_in(event.description, tmpExp1, "(");
     if (position != -1)
     {
         isMovie = true;
@@ -1250,7 +1349,7 @@ void EITFixUp::FixMCA(DBEventEIT &event) const
     {
         // Try to find year only from the end of the description
         tmpExp1  = m_mcaYear;
-        position = tmpExp1.indexIn(event.description);
+        position = index_in(event.description, tmpExp1, "(");
         if (position != -1)
         {
             isMovie = true;
@@ -1293,7 +1392,8 @@ void EITFixUp::FixRTL(DBEventEIT &event) const
 
     // Repeat
     QRegExp tmpExpRepeat = m_RTLrepeat;
-    if ((pos = tmpExpRepeat.indexIn(event.description)) != -1)
+    if ((pos = index_in(event.description, tmpExpRepeat,
+                        "Wiederholung")) != -1)
     {
         // remove '.' if it matches at the beginning of the description
         int length = tmpExpRepeat.cap(0).length() + (pos ? 0 : 1);
@@ -1303,12 +1403,10 @@ void EITFixUp::FixRTL(DBEventEIT &event) const
 
     QRegExp tmpExp1 = m_RTLSubtitle;
     QRegExp tmpExpSubtitle1 = m_RTLSubtitle1;
-    tmpExpSubtitle1.setMinimal(true);
     QRegExp tmpExpSubtitle2 = m_RTLSubtitle2;
     QRegExp tmpExpSubtitle3 = m_RTLSubtitle3;
     QRegExp tmpExpSubtitle4 = m_RTLSubtitle4;
     QRegExp tmpExpSubtitle5 = m_RTLSubtitle5;
-    tmpExpSubtitle5.setMinimal(true);
     QRegExp tmpExpEpisodeNo1 = m_RTLEpisodeNo1;
     QRegExp tmpExpEpisodeNo2 = m_RTLEpisodeNo2;
 
@@ -1390,14 +1488,14 @@ void EITFixUp::FixRTL(DBEventEIT &event) const
  */
 void EITFixUp::FixFI(DBEventEIT &event) const
 {
-    int position = event.description.indexOf(m_fiRerun);
+    int position = index_of(event.description, m_fiRerun, "Uusinta");
     if (position != -1)
     {
         event.previouslyshown = true;
         event.description = event.description.replace(m_fiRerun, "");
     }
 
-    position = event.description.indexOf(m_fiRerun2);
+    position = index_of(event.description, m_fiRerun2, "(");
     if (position != -1)
     {
         event.previouslyshown = true;
@@ -1405,7 +1503,7 @@ void EITFixUp::FixFI(DBEventEIT &event) const
     }
 
     // Check for (Stereo) in the decription and set the <audio> tags
-    position = event.description.indexOf(m_Stereo);
+    position = index_of(event.description, m_Stereo, "tereo");
     if (position != -1)
     {
         event.audioProps |= AUD_STEREO;
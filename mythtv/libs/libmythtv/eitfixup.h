@@ -8,11 +8,22 @@
 #include <QRegExp>
 
 #include "programdata.h"
+#include "mythtvexp.h"
+
+class QDataStream;
 
 typedef QMap<uint,uint> QMap_uint_t;
 
-/// EIT Fix Up Functions
-class EITFixUp
+/** \class EITFixUp
+ *  \brief EIT Fix Up Functions
+ *
+ *  The fixups are costly regular expression chains, so each expression
+ *  is only run after a cheap literal test shows it could match. Events
+ *  can be written out with DumpEvent() before they are fixed up, and
+ *  "mythutil --eitfixupbench" replays such a dump through Fix() to time
+ *  the fixups and to check that a change does not alter their output.
+ */
+class MTV_PUBLIC EITFixUp
 {
   protected:
      // max length of subtitle field in db.
@@ -61,6 +72,9 @@ class EITFixUp
 
     void Fix(DBEventEIT &event) const;
 
+    static void DumpEvent(QDataStream &out, const DBEventEIT &event);
+    static DBEventEIT *ReadEvent(QDataStream &in);
+
     /** Corrects starttime to the multiple of a minute. 
      *  Used for providers who fail to handle leap seconds timely. Changes the
      *  starttime not more than 3 seconds. Sshould only be used if the
@@ -1,17 +1,23 @@
 // -*- Mode: c++ -*-
 
 // Std C headers
+#include <stdlib.h>
 #include <time.h>
 
 // Std C++ headers
 #include <algorithm>
 using namespace std;
 
+// Qt headers
+#include <QDataStream>
+#include <QFile>
+
 // MythTV includes
 #include "eithelper.h"
 #include "eitfixup.h"
 #include "eitcache.h"
 #include "mythdb.h"
+#include "mythtimer.h"
 #include "atsctables.h"
 #include "dvbtables.h"
 #include "premieretables.h"
@@ -22,7 +28,10 @@ using namespace std;
 #include "programinfo.h" // for subtitle types and audio and video properties
 #include "compat.h" // for gmtime_r on windows.
 
-const uint EITHelper::kChunkSize = 20;
+const uint EITHelper::kChunkSize = 250;
+
+/// Longest span of a channel's events that share one program query.
+static const int kMaxWindowSecs = 6 * 60 * 60;
 EITCache *EITHelper::eitcache = new EITCache();
 
 static uint get_chan_id_from_db(uint sourceid,
@@ -31,6 +40,19 @@ static uint get_chan_id_from_db(uint sourceid,  uint serviceid,
                                 uint networkid, uint transportid);
 static void init_fixup(QMap<uint64_t,uint> &fix);
 static int calc_eit_utc_offset(void);
+static void open_eit_dump(void);
+static void dump_eit_event(const DBEventEIT &event);
+static uint write_events(MSqlQuery &query, const QList<DBEventEIT*> &events);
+
+/// Set once the MYTHTV_EIT_DUMP file is open, see open_eit_dump().
+static bool         eit_dump_enabled = false;
+static QMutex       eit_dump_lock;
+static QFile       *eit_dump_file    = NULL;
+static QDataStream *eit_dump_stream  = NULL;
+
+static QMutex                      writer_stats_lock;
+static EITWriterStats              writer_stats;
+static QMap<const EITHelper*,uint> writer_queued;
 
 #define LOC QString("EITHelper: ")
 
@@ -41,6 +63,9 @@ EITHelper::EITHelper() :
 {
     init_fixup(fixup);
 
+    if (getenv("MYTHTV_EIT_DUMP"))
+        open_eit_dump();
+
     utc_offset = calc_eit_utc_offset();
 
     int sign    = utc_offset < 0 ? -1 : +1;
@@ -61,44 +86,84 @@ EITHelper::~EITHelper()
         delete db_events.dequeue();
 
     delete eitfixup;
+
+    QMutexLocker stats_locker(&writer_stats_lock);
+    writer_queued.remove(this);
 }
 
 uint EITHelper::GetListSize(void) const
 {
     QMutexLocker locker(&eitList_lock);
-    return db_events.size();
+    uint size = db_events.size();
+    locker.unlock();
+
+    QMutexLocker stats_locker(&writer_stats_lock);
+    writer_queued[this] = size;
+
+    return size;
 }
 
 /** \fn EITHelper::ProcessEvents(void)
  *  \brief Inserts events in EIT list.
  *
+ *   Up to kChunkSize events are taken off the list at a time, so the
+ *   tables can keep being parsed while they are written. The events are
+ *   grouped by channel and each group is written by write_events().
+ *
  *  \return Returns number of events inserted into DB.
  */
 uint EITHelper::ProcessEvents(void)
 {
     QMutexLocker locker(&eitList_lock);
-    uint insertCount = 0;
 
     if (!db_events.size())
         return 0;
 
-    MSqlQuery query(MSqlQuery::InitCon());
-    for (uint i = 0; (i < kChunkSize) && (i < db_events.size()); i++)
-    {
-        DBEventEIT *event = db_events.dequeue();
-        eitList_lock.unlock();
+    QList<DBEventEIT*> batch;
+    while (db_events.size() && ((uint)batch.size() < kChunkSize))
+        batch.push_back(db_events.dequeue());
+    uint queued = db_events.size();
+    locker.unlock();
 
-        eitfixup->Fix(*event);
+    MythTimer t;
+    t.start();
 
-        insertCount += event->UpdateDB(query, 1000);
+    QMap<uint, QList<DBEventEIT*> > channels;
+    for (int i = 0; i < batch.size(); i++)
+    {
+        if (eit_dump_enabled)
+            dump_eit_event(*batch[i]);
+
+        eitfixup->Fix(*batch[i]);
 
-        delete event;
-        eitList_lock.lock();
+        channels[batch[i]->chanid].push_back(batch[i]);
     }
 
+    MSqlQuery query(MSqlQuery::InitCon());
+    uint insertCount = 0;
+    QMap<uint, QList<DBEventEIT*> >::const_iterator it = channels.begin();
+    for (; it != channels.end(); ++it)
+        insertCount += write_events(query, *it);
+
+    qDeleteAll(batch);
+
+    int msecs = t.elapsed();
+    LOG(VB_EIT, LOG_DEBUG, LOC +
+        QString("Wrote %1 events of %2 channels in %3 ms, %4 queued")
+            .arg(batch.size()).arg(channels.size()).arg(msecs).arg(queued));
+
+    writer_stats_lock.lock();
+    writer_queued[this]   = queued;
+    writer_stats.written += batch.size();
+    writer_stats.batches++;
+    writer_stats.msecs   += msecs;
+    writer_stats_lock.unlock();
+
     if (!insertCount)
         return 0;
 
+    locker.relock();
+
     if (incomplete_events.size() || unmatched_etts.size())
     {
         LOG(VB_EIT, LOG_INFO,
@@ -611,6 +676,23 @@ void EITHelper::WriteEITCache(void)
     eitcache->WriteToDB();
 }
 
+EITCacheStats EITHelper::GetCacheStats(void)
+{
+    return eitcache->GetCacheStats();
+}
+
+EITWriterStats EITHelper::GetWriterStats(void)
+{
+    QMutexLocker locker(&writer_stats_lock);
+
+    EITWriterStats stats = writer_stats;
+    QMap<const EITHelper*,uint>::const_iterator it = writer_queued.begin();
+    for (; it != writer_queued.end(); ++it)
+        stats.queued += *it;
+
+    return stats;
+}
+
 //////////////////////////////////////////////////////////////////////
 // private methods and functions below this line                    //
 //////////////////////////////////////////////////////////////////////
@@ -988,6 +1070,79 @@ static void init_fixup(QMap<uint64_t,uint> &fix)
         EITFixUp::kEFixForceISO8859_15;
 }
 
+/** \brief Writes the events of one channel, in the order they came in.
+ *
+ *  The stored programs are loaded once for each run of events spanning
+ *  at most kMaxWindowSecs, and the events are matched against them in
+ *  memory, rather than each event querying the programs it overlaps.
+ *  \return number of events written
+ */
+static uint write_events(MSqlQuery &query, const QList<DBEventEIT*> &events)
+{
+    uint count = 0;
+    int  first = 0;
+
+    while (first < events.size())
+    {
+        QDateTime from = events[first]->starttime;
+        QDateTime to   = events[first]->endtime;
+        int last = first + 1;
+        for (; last < events.size(); last++)
+        {
+            QDateTime start = min(from, events[last]->starttime);
+            QDateTime end   = max(to,   events[last]->endtime);
+            if (start.secsTo(end) > kMaxWindowSecs)
+                break;
+            from = start;
+            to   = end;
+        }
+
+        vector<DBEvent> window;
+        DBEvent::LoadOverlappingPrograms(
+            query, events[first]->chanid, from, to, window);
+
+        for (; first < last; first++)
+            count += events[first]->UpdateDB(query, 1000, window);
+    }
+
+    return count;
+}
+
+/** \brief Opens the file named by MYTHTV_EIT_DUMP, all the EITHelpers
+ *         then append their events to it before they are fixed up.
+ *
+ *  The dump can be replayed with "mythutil --eitfixupbench --infile".
+ */
+static void open_eit_dump(void)
+{
+    QMutexLocker locker(&eit_dump_lock);
+    if (eit_dump_file)
+        return;
+
+    eit_dump_file = new QFile(QString::fromLocal8Bit(getenv("MYTHTV_EIT_DUMP")));
+    if (!eit_dump_file->open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Could not open EIT dump file '%1'")
+                .arg(eit_dump_file->fileName()));
+        return;
+    }
+
+    eit_dump_stream = new QDataStream(eit_dump_file);
+    eit_dump_stream->setVersion(QDataStream::Qt_4_6);
+    eit_dump_enabled = true;
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Dumping EIT events to '%1'")
+            .arg(eit_dump_file->fileName()));
+}
+
+static void dump_eit_event(const DBEventEIT &event)
+{
+    QMutexLocker locker(&eit_dump_lock);
+    EITFixUp::DumpEvent(*eit_dump_stream, event);
+    eit_dump_file->flush();
+}
+
 static int calc_eit_utc_offset(void)
 {
     QString config_offset = gCoreContext->GetSetting("EITTimeOffset", "Auto");
@@ -13,6 +13,7 @@
 
 // MythTV includes
 #include "mythdeque.h"
+#include "mythtvexp.h"
 
 class MSqlQuery;
 
@@ -49,6 +50,22 @@ typedef QMap<unsigned long long,int>       ServiceToChanID;
 class DBEventEIT;
 class EITFixUp;
 class EITCache;
+class EITCacheStats;
+
+/// Totals of the EIT writers of all the EITHelpers.
+class MTV_PUBLIC EITWriterStats
+{
+  public:
+    EITWriterStats() : queued(0), written(0), batches(0), msecs(0) { }
+
+    double EventsPerSecond(void) const
+        { return (msecs) ? written * 1000.0 / msecs : 0.0; }
+
+    uint     queued;    ///< events waiting to be written
+    uint64_t written;   ///< events written since the backend started
+    uint     batches;   ///< batches the events were written in
+    uint64_t msecs;     ///< time spent fixing up and writing them
+};
 
 class EventInformationTable;
 class ExtendedTextTable;
@@ -88,6 +105,9 @@ class EITHelper
     // EIT cache handling
     void PruneEITCache(uint timestamp);
     void WriteEITCache(void);
+    static MTV_PUBLIC EITCacheStats GetCacheStats(void);
+
+    static MTV_PUBLIC EITWriterStats GetWriterStats(void);
 
   private:
     uint GetChanID(uint atsc_major, uint atsc_minor);
@@ -115,7 +135,7 @@ class EITHelper
 
     QMap<uint,uint>         languagePreferences;
 
-    /// Maximum number of DB inserts per ProcessEvents call.
+    /// Maximum number of events written per ProcessEvents call.
     static const uint kChunkSize;
 };
 
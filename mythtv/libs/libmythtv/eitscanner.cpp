@@ -31,13 +31,100 @@
 QMutex     EITScanner::resched_lock;
 QDateTime  EITScanner::resched_next_time      = QDateTime::currentDateTime();
 const uint EITScanner::kMinRescheduleInterval = 150;
+const int  EITScanner::kMinScanTime           = 60;
+
+QMutex     EITScanCoordinator::lock;
+QMap<uint, EITScanCoordinator::ScanMux> EITScanCoordinator::muxes;
+const int  EITScanCoordinator::kCompleteRescanInterval = 4 * 60 * 60;
+
+void EITScanCoordinator::AddMultiplex(uint mplexid, const QString &channum)
+{
+    QMutexLocker locker(&lock);
+
+    QMap<uint, ScanMux>::iterator it = muxes.find(mplexid);
+    if (it == muxes.end())
+    {
+        ScanMux mux;
+        mux.cardnum = 0;
+        it = muxes.insert(mplexid, mux);
+    }
+    (*it).channum = channum;
+}
+
+/** \fn EITScanCoordinator::Acquire(uint, const QList<uint>&)
+ *  \brief Returns the multiplex the tuner should scan next, or 0 if all
+ *         the multiplexes it can tune are being scanned by other tuners.
+ */
+uint EITScanCoordinator::Acquire(uint cardnum, const QList<uint> &mplexids)
+{
+    QMutexLocker locker(&lock);
+
+    QDateTime recent = QDateTime::currentDateTime()
+        .addSecs(-kCompleteRescanInterval);
+
+    uint      best = 0;
+    bool      best_recent = false;
+    QDateTime best_scan;
+
+    QList<uint>::const_iterator it = mplexids.begin();
+    for (; it != mplexids.end(); ++it)
+    {
+        QMap<uint, ScanMux>::const_iterator mux = muxes.find(*it);
+        if (mux == muxes.end() || (*mux).cardnum)
+            continue;
+
+        bool is_recent = (*mux).lastComplete.isValid() &&
+            ((*mux).lastComplete > recent);
+
+        if (best && (is_recent != best_recent) && is_recent)
+            continue;
+        if (best && (is_recent == best_recent) &&
+            (!best_scan.isValid() ||
+             ((*mux).lastScan.isValid() && (*mux).lastScan >= best_scan)))
+        {
+            continue;
+        }
+
+        best        = *it;
+        best_recent = is_recent;
+        best_scan   = (*mux).lastScan;
+    }
+
+    if (best)
+        muxes[best].cardnum = cardnum;
+
+    return best;
+}
+
+void EITScanCoordinator::Release(uint cardnum, uint mplexid, bool complete)
+{
+    QMutexLocker locker(&lock);
+
+    QMap<uint, ScanMux>::iterator it = muxes.find(mplexid);
+    if (it == muxes.end() || (*it).cardnum != cardnum)
+        return;
+
+    (*it).cardnum  = 0;
+    (*it).lastScan = QDateTime::currentDateTime();
+    if (complete)
+        (*it).lastComplete = (*it).lastScan;
+}
+
+QString EITScanCoordinator::GetChannum(uint mplexid)
+{
+    QMutexLocker locker(&lock);
+
+    QMap<uint, ScanMux>::const_iterator it = muxes.find(mplexid);
+    return (it == muxes.end()) ? QString() : (*it).channum;
+}
 
 EITScanner::EITScanner(uint _cardnum)
     : channel(NULL),              eitSource(NULL),
       eitHelper(new EITHelper()), eventThread(new MThread("EIT", this)),
       exitThread(false),
       rec(NULL),                  activeScan(false),
-      activeScanTrigTime(0),      cardnum(_cardnum)
+      activeScanTrigTime(0),      activeScanMplexid(0),
+      cardnum(_cardnum)
 {
     QStringList langPref = iso639_get_language_list();
     eitHelper->SetLanguagePreferences(langPref);
@@ -116,7 +203,20 @@ void EITScanner::run(void)
             RescheduleRecordings();
         }
 
-        if (activeScan && (QDateTime::currentDateTime() > activeScanNextTrig))
+        // Move on once the whole EIT schedule of the multiplex has been
+        // seen, or when the time for it is up.
+        bool complete = false;
+        if (activeScan && activeScanMplexid &&
+            (activeScanStart.secsTo(QDateTime::currentDateTime()) >=
+             kMinScanTime))
+        {
+            lock.lock();
+            complete = eitSource && eitSource->HasCompleteEIT();
+            lock.unlock();
+        }
+
+        if (activeScan && (complete ||
+                           QDateTime::currentDateTime() > activeScanNextTrig))
         {
             // if there have been any new events, tell scheduler to run.
             if (eitCount)
@@ -127,29 +227,50 @@ void EITScanner::run(void)
                 RescheduleRecordings();
             }
 
-            if (activeScanNextChan == activeScanChannels.end())
-                activeScanNextChan = activeScanChannels.begin();
+            if (complete)
+            {
+                LOG(VB_EIT, LOG_INFO, LOC_ID +
+                    QString("EIT schedule complete on multiplex %1 "
+                            "after %2 seconds")
+                        .arg(activeScanMplexid)
+                        .arg(activeScanStart.secsTo(
+                                 QDateTime::currentDateTime())));
+            }
 
-            if (!(*activeScanNextChan).isEmpty())
+            lock.lock();
+            uint last_mplexid = activeScanMplexid;
+            if (activeScanMplexid)
+                EITScanCoordinator::Release(cardnum, activeScanMplexid,
+                                            complete);
+            activeScanMplexid = (activeScan) ?
+                EITScanCoordinator::Acquire(cardnum, activeScanMuxes) : 0;
+            uint mplexid = activeScanMplexid;
+            lock.unlock();
+
+            QString channum = EITScanCoordinator::GetChannum(mplexid);
+            if (mplexid != last_mplexid && !channum.isEmpty())
             {
                 eitHelper->WriteEITCache();
-                rec->SetChannel(*activeScanNextChan, TVRec::kFlagEITScan);
+                rec->SetChannel(channum, TVRec::kFlagEITScan);
                 LOG(VB_EIT, LOG_INFO,
                     LOC_ID + QString("Now looking for EIT data on "
                                      "multiplex of channel %1")
-                        .arg(*activeScanNextChan));
+                        .arg(channum));
             }
 
-            activeScanNextTrig = QDateTime::currentDateTime()
-                .addSecs(activeScanTrigTime);
-            ++activeScanNextChan;
+            activeScanStart    = QDateTime::currentDateTime();
+            activeScanNextTrig = activeScanStart.addSecs(activeScanTrigTime);
 
             // 24 hours ago
             eitHelper->PruneEITCache(activeScanNextTrig.toTime_t() - 86400);
         }
 
+        // Keep writing while events are queued, when the writer falls
+        // behind the EIT rate above slows the tables coming in instead.
+        bool pending = eitHelper->GetListSize();
+
         lock.lock();
-        if (!exitThread)
+        if (!exitThread && !pending)
             exitThreadCond.wait(&lock, 400); // sleep up to 400 ms.
     }
     lock.unlock();
@@ -222,12 +343,12 @@ void EITScanner::StartActiveScan(TVRec *_rec, uint max_seconds_per_source)
 {
     rec = _rec;
 
-    if (!activeScanChannels.size())
+    if (!activeScanMuxes.size())
     {
         // TODO get input name and use it in crawl.
         MSqlQuery query(MSqlQuery::InitCon());
         query.prepare(
-            "SELECT channum, MIN(chanid) "
+            "SELECT channum, MIN(chanid), mplexid "
             "FROM channel, cardinput, capturecard, videosource "
             "WHERE cardinput.sourceid   = channel.sourceid AND "
             "      videosource.sourceid = channel.sourceid AND "
@@ -249,23 +370,22 @@ void EITScanner::StartActiveScan(TVRec *_rec, uint max_seconds_per_source)
         }
 
         while (query.next())
-            activeScanChannels.push_back(query.value(0).toString());
-
-        activeScanNextChan = activeScanChannels.begin();
+        {
+            uint mplexid = query.value(2).toUInt();
+            EITScanCoordinator::AddMultiplex(
+                mplexid, query.value(0).toString());
+            activeScanMuxes.push_back(mplexid);
+        }
     }
 
     LOG(VB_EIT, LOG_INFO, LOC_ID +
         QString("StartActiveScan called with %1 multiplexes")
-            .arg(activeScanChannels.size()));
+            .arg(activeScanMuxes.size()));
 
-    // Start at a random channel. This is so that multiple cards with
-    // the same source don't all scan the same channels in the same
-    // order when the backend is first started up.
-    if (activeScanChannels.size())
+    // The multiplexes are handed out by EITScanCoordinator, so that the
+    // tuners sharing a source each scan a different one.
+    if (activeScanMuxes.size())
     {
-        uint randomStart = random() % activeScanChannels.size();
-        activeScanNextChan = activeScanChannels.begin()+randomStart;
-
         activeScanNextTrig = QDateTime::currentDateTime();
         activeScanTrigTime = max_seconds_per_source;
         // Add a little randomness to trigger time so multiple
@@ -277,7 +397,15 @@ void EITScanner::StartActiveScan(TVRec *_rec, uint max_seconds_per_source)
 
 void EITScanner::StopActiveScan()
 {
+    lock.lock();
     activeScan = false;
+    if (activeScanMplexid)
+    {
+        EITScanCoordinator::Release(cardnum, activeScanMplexid, false);
+        activeScanMplexid = 0;
+    }
+    lock.unlock();
+
     rec = NULL;
     StopPassiveScan();
 }
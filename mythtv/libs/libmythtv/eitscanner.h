@@ -7,6 +7,8 @@
 #include <QStringList>
 #include <QDateTime>
 #include <QRunnable>
+#include <QList>
+#include <QMap>
 #include <QMutex>
 
 class TVRec;
@@ -23,9 +25,41 @@ class EITSource
   public:
     virtual void SetEITHelper(EITHelper*) = 0;
     virtual void SetEITRate(float rate) = 0;
+    /// True once all the EIT schedule tables of the multiplex have been seen
+    virtual bool HasCompleteEIT(void) const = 0;
 };
 
-class EITScanner;
+/** \class EITScanCoordinator
+ *  \brief Hands out the multiplexes to the tuners doing an active EIT scan,
+ *         so that no two tuners scan the same multiplex at once.
+ *
+ *   The multiplex that went longest without a scan is handed out first,
+ *   but those seen with a complete EIT schedule in the last
+ *   kCompleteRescanInterval seconds only once the others are all taken.
+ */
+class EITScanCoordinator
+{
+  public:
+    static void    AddMultiplex(uint mplexid, const QString &channum);
+    static uint    Acquire(uint cardnum, const QList<uint> &mplexids);
+    static void    Release(uint cardnum, uint mplexid, bool complete);
+    static QString GetChannum(uint mplexid);
+
+  private:
+    typedef struct
+    {
+        QString   channum;
+        QDateTime lastScan;
+        QDateTime lastComplete;
+        uint      cardnum;      ///< tuner scanning it, or 0
+    } ScanMux;
+
+    static QMutex               lock;
+    static QMap<uint, ScanMux>  muxes; // mplexid -> ScanMux
+
+    /// Seconds after a complete scan before a multiplex is preferred again.
+    static const int kCompleteRescanInterval;
+};
 
 class EITScanner : public QRunnable
 {
@@ -60,9 +94,10 @@ class EITScanner : public QRunnable
     TVRec           *rec;
     bool             activeScan;
     QDateTime        activeScanNextTrig;
+    QDateTime        activeScanStart;
     uint             activeScanTrigTime;
-    QStringList      activeScanChannels;
-    QStringList::iterator activeScanNextChan;
+    QList<uint>      activeScanMuxes;
+    uint             activeScanMplexid;
 
     uint             cardnum;
 
@@ -71,6 +106,8 @@ class EITScanner : public QRunnable
 
     /// Minumum number of seconds between reschedules.
     static const uint kMinRescheduleInterval;
+    /// Minimum number of seconds on a multiplex before its EIT is complete.
+    static const int  kMinScanTime;
 };
 
 #endif // EITSCANNER_H
@@ -23,6 +23,14 @@ typedef struct VideoFilter_ VideoFilter;
 
 typedef VideoFilter*(*init_filter)(int, int, int *, int *, char *, int);
 
+/* Optional slice threading entry points, see filters/README.
+ * slice_begin does the per frame work which can't be split, such as
+ * saving reference frames, and returns 0 if the slices should be run.
+ * slice_filter then runs once per band and may only write the rows
+ * first_row up to but not including last_row. */
+typedef int  (*slice_begin_filter)(VideoFilter *, VideoFrame *, int);
+typedef void (*slice_filter)(VideoFilter *, VideoFrame *, int, int, int);
+
 typedef struct FilterInfo_
 {
     init_filter filter_init;
@@ -30,6 +38,9 @@ typedef struct FilterInfo_
     char *descript;
     FmtConv *formats;
     char *libname;
+    slice_begin_filter slice_begin;
+    slice_filter slice;
+    int slice_overlap;
 } FilterInfo;
 
 typedef struct ConstFilterInfo_
@@ -39,6 +50,9 @@ typedef struct ConstFilterInfo_
     const char *descript;
     const FmtConv *formats;
     const char *libname;
+    const slice_begin_filter slice_begin;
+    const slice_filter slice;
+    const int slice_overlap;
 } ConstFilterInfo;
 
 struct VideoFilter_
@@ -53,7 +67,7 @@ struct VideoFilter_
     FilterInfo *info;
 };
 
-#define FILT_NULL {NULL,NULL,NULL,NULL,NULL}
+#define FILT_NULL {NULL,NULL,NULL,NULL,NULL,NULL,NULL,0}
 
 #ifdef TIME_FILTER
 
@@ -9,15 +9,61 @@
 
 // Qt headers
 #include <QDir>
+#include <QRunnable>
+#include <QSemaphore>
 #include <QStringList>
 
 // MythTV headers
 #include "mythcontext.h"
 #include "filtermanager.h"
+#include "mthreadpool.h"
 #include "mythdirs.h"
 
 #define LOC QString("FilterManager: ")
 
+/// Bands are a multiple of this many rows, so that both fields and
+/// 4:2:0 chroma rows are split evenly between threads.
+static const int kSliceAlign     = 4;
+/// Don't split frames into bands smaller than this.
+static const int kSliceMinHeight = 16;
+
+class FilterSliceRunnable : public QRunnable
+{
+  public:
+    FilterSliceRunnable(QSemaphore *done) :
+        m_filter(NULL), m_slice(NULL), m_frame(NULL),
+        m_field(0), m_firstRow(0), m_lastRow(0), m_done(done)
+    {
+        setAutoDelete(false);
+    }
+
+    void Set(VideoFilter *filter, slice_filter slice, VideoFrame *frame,
+             int field, int first_row, int last_row)
+    {
+        m_filter   = filter;
+        m_slice    = slice;
+        m_frame    = frame;
+        m_field    = field;
+        m_firstRow = first_row;
+        m_lastRow  = last_row;
+    }
+
+    void run(void)
+    {
+        m_slice(m_filter, m_frame, m_field, m_firstRow, m_lastRow);
+        m_done->release();
+    }
+
+  private:
+    VideoFilter  *m_filter;
+    slice_filter  m_slice;
+    VideoFrame   *m_frame;
+    int           m_field;
+    int           m_firstRow;
+    int           m_lastRow;
+    QSemaphore   *m_done;
+};
+
 static const char *FmtToString(VideoFrameType ft)
 {
     switch(ft)
@@ -37,8 +83,24 @@ static const char *FmtToString(VideoFrameType ft)
     }
 }
 
+FilterChain::FilterChain(int max_threads) :
+    m_maxThreads(max(max_threads, 1)), m_pool(NULL), m_sliceDone(NULL)
+{
+}
+
 FilterChain::~FilterChain()
 {
+    if (m_pool)
+    {
+        m_pool->waitForDone();
+        delete m_pool;
+    }
+    vector<FilterSliceRunnable*>::iterator rit = m_runnables.begin();
+    for (; rit != m_runnables.end(); ++rit)
+        delete *rit;
+    m_runnables.clear();
+    delete m_sliceDone;
+
     vector<VideoFilter*>::iterator it = filters.begin();
     for (; it != filters.end(); ++it)
     {
@@ -58,9 +120,76 @@ void FilterChain::ProcessFrame(VideoFrame *frame, FrameScanType scan)
     if (!frame)
         return;
 
-    vector<VideoFilter*>::iterator it = filters.begin();
-    for (; it != filters.end(); ++it)
-        (*it)->filter(*it, frame, kScan_Intr2ndField == scan);
+    int field = (kScan_Intr2ndField == scan);
+
+    for (uint i = 0; i < filters.size(); i++)
+    {
+        if (m_pool && slicing[i].slice)
+            ProcessSlices(filters[i], slicing[i], frame, field);
+        else
+            filters[i]->filter(filters[i], frame, field);
+    }
+}
+
+void FilterChain::Append(VideoFilter *f, const FilterInfo *info)
+{
+    FilterSlicing fs;
+    fs.begin   = (info) ? info->slice_begin   : NULL;
+    fs.slice   = (info) ? info->slice         : NULL;
+    fs.overlap = (info) ? info->slice_overlap : 0;
+
+    filters.push_back(f);
+    slicing.push_back(fs);
+
+    if (!fs.slice || (m_maxThreads < 2) || m_pool)
+        return;
+
+    // The calling thread runs the first band itself.
+    m_pool = new MThreadPool("FilterSlices");
+    m_pool->setMaxThreadCount(m_maxThreads - 1);
+    m_sliceDone = new QSemaphore();
+    for (int i = 1; i < m_maxThreads; i++)
+        m_runnables.push_back(new FilterSliceRunnable(m_sliceDone));
+
+    LOG(VB_PLAYBACK, LOG_INFO, LOC +
+        QString("Running sliced filters on %1 threads").arg(m_maxThreads));
+}
+
+/** \fn FilterChain::ProcessSlices(VideoFilter*,const FilterSlicing&,VideoFrame*,int)
+ *  \brief Runs a sliced filter over horizontal bands of the frame in
+ *         parallel, and returns once every band is done.
+ */
+void FilterChain::ProcessSlices(VideoFilter *filter,
+                                const FilterSlicing &fs,
+                                VideoFrame *frame, int field)
+{
+    if (fs.begin && fs.begin(filter, frame, field))
+        return;
+
+    // A band must be tall enough that the rows a filter reads around
+    // it don't reach past the next band.
+    int min_height = max(kSliceMinHeight, 2 * fs.overlap);
+    int bands = min(m_maxThreads, max(frame->height / min_height, 1));
+    int band_height = (frame->height + bands - 1) / bands;
+    band_height = (band_height + kSliceAlign - 1) & ~(kSliceAlign - 1);
+
+    int queued = 0;
+    for (int b = 1; b < bands; b++)
+    {
+        int first_row = b * band_height;
+        int last_row  = min(first_row + band_height, frame->height);
+        if (first_row >= last_row)
+            break;
+
+        FilterSliceRunnable *runnable = m_runnables[queued++];
+        runnable->Set(filter, fs.slice, frame, field,
+                      first_row, last_row);
+        m_pool->start(runnable, "FilterSlice");
+    }
+
+    fs.slice(filter, frame, field, 0, min(band_height, frame->height));
+
+    m_sliceDone->acquire(queued);
 }
 
 FilterManager::FilterManager()
@@ -172,6 +301,9 @@ bool FilterManager::LoadFilterLib(const QString &path)
 
         QByteArray libname = path.toAscii();
         newFilter->libname = strdup(libname.constData());
+        newFilter->slice_begin   = filtInfo->slice_begin;
+        newFilter->slice         = filtInfo->slice;
+        newFilter->slice_overlap = filtInfo->slice_overlap;
         filters[newFilter->name] = newFilter;
         LOG(VB_PLAYBACK, LOG_DEBUG, LOC + QString("filters[%1] = 0x%2")
                 .arg(newFilter->name).arg((uint64_t)newFilter,0,16));
@@ -202,7 +334,7 @@ FilterChain *FilterManager::LoadFilters(QString Filters,
         return NULL;
 
     vector<const FilterInfo*> FiltInfoChain;
-    FilterChain *FiltChain = new FilterChain;
+    FilterChain *FiltChain = new FilterChain(max_threads);
     vector<FmtConv*> FmtList;
     const FilterInfo *FI;
     const FilterInfo *FI2;
@@ -402,7 +534,7 @@ FilterChain *FilterManager::LoadFilters(QString Filters,
 
         if (NewFilt->filter && FiltChain)
         {
-            FiltChain->Append(NewFilt);
+            FiltChain->Append(NewFilt, FiltInfoChain[i]);
         }
         else
         {
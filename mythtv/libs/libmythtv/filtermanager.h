@@ -19,18 +19,38 @@ typedef map<QString,FilterInfo*> filter_map_t;
 
 #include "videoouttypes.h"
 
+class FilterSliceRunnable;
+class MThreadPool;
+class QSemaphore;
+
+/// Slice threading entry points of a filter in a FilterChain.
+typedef struct filterslicing
+{
+    slice_begin_filter begin;
+    slice_filter       slice;
+    int                overlap;
+} FilterSlicing;
+
 class FilterChain
 {
   public:
-    FilterChain() { }
+    FilterChain(int max_threads = 1);
     virtual ~FilterChain();
 
     void ProcessFrame(VideoFrame *Frame, FrameScanType scan = kScan_Ignore);
 
-    void Append(VideoFilter *f) { filters.push_back(f); }
+    void Append(VideoFilter *f, const FilterInfo *info = NULL);
 
   private:
-    vector<VideoFilter*> filters;
+    void ProcessSlices(VideoFilter *filter, const FilterSlicing &slicing,
+                       VideoFrame *frame, int field);
+
+    vector<VideoFilter*>         filters;
+    vector<FilterSlicing>        slicing;
+    int                          m_maxThreads;
+    MThreadPool                 *m_pool;
+    QSemaphore                  *m_sliceDone;
+    vector<FilterSliceRunnable*> m_runnables;
 };
 
 class FilterManager
@@ -22,6 +22,7 @@ using namespace std;
 #include "mythcorecontext.h"
 #include "util.h"
 #include "previewgenerator.h"
+#include "trickplaygenerator.h"
 #include "compat.h"
 #include "recordingprofile.h"
 #include "recordinginfo.h"
@@ -644,6 +645,9 @@ bool JobQueue::QueueJobs(int jobTypes, uint chanid, const QDateTime &recstartts,
         }
     }
 
+    if (jobTypes & JOB_TRICKPLAY)
+        QueueJob(JOB_TRICKPLAY, chanid, recstartts, args, comment, host);
+
     if (jobTypes & JOB_USERJOB1)
         QueueJob(JOB_USERJOB1, chanid, recstartts, args, comment, host);
     if (jobTypes & JOB_USERJOB2)
@@ -1107,6 +1111,7 @@ QString JobQueue::JobText(int jobType)
         case JOB_TRANSCODE:  return tr("Transcode");
         case JOB_COMMFLAG:   return tr("Flag Commercials");
         case JOB_METADATA:   return tr("Look up Metadata");
+        case JOB_TRICKPLAY:  return tr("Build Trickplay Index");
     }
 
     if (jobType & JOB_USERJOB)
@@ -1436,6 +1441,8 @@ bool JobQueue::AllowedToRun(JobQueueEntry job)
                                  break;
             case JOB_METADATA:   allowSetting = "JobAllowMetadata";
                                  break;
+            case JOB_TRICKPLAY:  allowSetting = "JobAllowTrickplay";
+                                 break;
             default:             return false;
         }
     }
@@ -1717,6 +1724,10 @@ void JobQueue::ProcessJob(JobQueueEntry job)
     {
         StartChildJob(MetadataLookupThread, jobID);
     }
+    else if (job.type == JOB_TRICKPLAY)
+    {
+        StartChildJob(TrickplayThread, jobID);
+    }
     else if (job.type & JOB_USERJOB)
     {
         StartChildJob(UserJobThread, jobID);
@@ -1751,6 +1762,8 @@ QString JobQueue::GetJobDescription(int jobType)
         return "Transcode";
     else if (jobType == JOB_COMMFLAG)
         return "Commercial Detection";
+    else if (jobType == JOB_TRICKPLAY)
+        return "Trickplay Index";
     else if (!(jobType & JOB_USERJOB))
         return "Unknown Job";
 
@@ -2361,6 +2374,124 @@ void JobQueue::DoFlagCommercialsThread(int jobID)
     runningJobsLock->unlock();
 }
 
+void *JobQueue::TrickplayThread(void *param)
+{
+    JobThreadStruct *jts = (JobThreadStruct *)param;
+    JobQueue *jq = jts->jq;
+
+    threadRegister(QString("Trickplay_%1").arg(jts->jobID));
+    jq->DoTrickplayThread(jts->jobID);
+    threadDeregister();
+
+    delete jts;
+
+    return NULL;
+}
+
+/** \brief Builds the trickplay index of a recording.
+ *
+ *   Unlike the other system jobs this runs in the backend rather than in
+ *   a helper program, the images are grabbed the same way as previews.
+ */
+void JobQueue::DoTrickplayThread(int jobID)
+{
+    runningJobsLock->lock();
+    if (!runningJobs[jobID].pginfo)
+    {
+        LOG(VB_JOBQUEUE, LOG_ERR, LOC +
+            "The JobQueue cannot currently build trickplay indexes for "
+            "files that do not have a chanid/starttime in the recorded "
+            "table.");
+        ChangeJobStatus(jobID, JOB_ERRORED, "ProgramInfo data not found");
+        RemoveRunningJob(jobID);
+        runningJobsLock->unlock();
+        return;
+    }
+
+    ProgramInfo *program_info = runningJobs[jobID].pginfo;
+    runningJobsLock->unlock();
+
+    QString detailstr = QString("%1 recorded from channel %3")
+        .arg(program_info->toString(ProgramInfo::kTitleSubtitle))
+        .arg(program_info->toString(ProgramInfo::kRecordingKey));
+    QByteArray details = detailstr.toLocal8Bit();
+
+    if (!MSqlQuery::testDBConnection())
+    {
+        QString msg = QString("Trickplay Index failed.  Could not open "
+                              "new database connection for %1.")
+                              .arg(details.constData());
+        LOG(VB_GENERAL, LOG_ERR, LOC + msg);
+
+        ChangeJobStatus(jobID, JOB_ERRORED,
+                        "Could not open new database connection for "
+                        "trickplay index.");
+
+        delete program_info;
+        return;
+    }
+
+    LOG(VB_GENERAL, LOG_INFO,
+        LOC + "Trickplay Index Starting for " + detailstr);
+
+    ChangeJobStatus(jobID, JOB_RUNNING, tr("Building trickplay index"));
+
+    if (!program_info->IsLocal())
+        program_info->SetPathname(program_info->GetPlaybackURL(false,true));
+
+    bool ok = false;
+    if (program_info->IsLocal())
+    {
+        TrickplayGenerator generator(*program_info, jobID);
+        ok = generator.Run();
+    }
+
+    int priority = LOG_NOTICE;
+    QString comment;
+
+    runningJobsLock->lock();
+
+    if (!program_info->IsLocal())
+    {
+        comment = tr("Recording is not on this host");
+        ChangeJobStatus(jobID, JOB_ERRORED, comment);
+        priority = LOG_WARNING;
+    }
+    else if ((runningJobs[jobID].flag == JOB_STOP) ||
+             (GetJobCmd(jobID) == JOB_STOP))
+    {
+        comment = tr("Aborted by user");
+        ChangeJobStatus(jobID, JOB_ABORTED, comment);
+        priority = LOG_WARNING;
+    }
+    else if (!ok)
+    {
+        comment = tr("Unable to open file or init decoder");
+        ChangeJobStatus(jobID, JOB_ERRORED, comment);
+        priority = LOG_WARNING;
+    }
+    else
+    {
+        comment = tr("Trickplay Index Complete.");
+        ChangeJobStatus(jobID, JOB_FINISHED, comment);
+    }
+
+    QString msg = tr("Trickplay Index %1", "Job ID")
+        .arg(StatusText(GetJobStatus(jobID)));
+
+    if (!comment.isEmpty())
+    {
+        detailstr += QString(" (%1)").arg(comment);
+        details = detailstr.toLocal8Bit();
+    }
+
+    if (priority <= LOG_WARNING)
+        LOG(VB_GENERAL, LOG_ERR, LOC + msg + ": " + details.constData());
+
+    RemoveRunningJob(jobID);
+    runningJobsLock->unlock();
+}
+
 void *JobQueue::UserJobThread(void *param)
 {
     JobThreadStruct *jts = (JobThreadStruct *)param;
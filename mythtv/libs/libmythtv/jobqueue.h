@@ -77,6 +77,7 @@ enum JobTypes {
     JOB_TRANSCODE    = 0x0001,
     JOB_COMMFLAG     = 0x0002,
     JOB_METADATA     = 0x0004,
+    JOB_TRICKPLAY    = 0x0008,
 
     JOB_USERJOB      = 0xff00,
     JOB_USERJOB1     = 0x0100,
@@ -230,6 +231,9 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
     static void *FlagCommercialsThread(void *param);
     void DoFlagCommercialsThread(int jobID);
 
+    static void *TrickplayThread(void *param);
+    void DoTrickplayThread(int jobID);
+
     static void *UserJobThread(void *param);
     void DoUserJobThread(int jobID);
 
@@ -70,6 +70,7 @@ void LiveTVChain::AppendNewProgram(ProgramInfo *pginfo, QString channum,
     newent.starttime = pginfo->GetRecordingStartTime();
     newent.starttime.setTime(QTime(tmptime.hour(), tmptime.minute(),
                                    tmptime.second()));
+    newent.endtime = pginfo->GetRecordingEndTime();
     newent.discontinuity = discont;
     newent.hostprefix = m_hostprefix;
     newent.cardtype = m_cardtype;
@@ -186,13 +187,79 @@ void LiveTVChain::DeleteProgram(ProgramInfo *pginfo)
     }
 }
 
+/// Number of strings for each entry in EntriesToStringList()
+static const int kEntryStrings = 8;
+
+/** \fn LiveTVChain::BroadcastUpdate(void)
+ *  \brief Tells the frontends the chain changed.
+ *
+ *   The whole chain is sent with the event, so the frontends can update
+ *   their copy without querying the tvchain table again.
+ */
 void LiveTVChain::BroadcastUpdate(void)
 {
     QString message = QString("LIVETV_CHAIN UPDATE %1").arg(m_id);
-    MythEvent me(message);
+    MythEvent me(message, EntriesToStringList());
     gCoreContext->dispatch(me);
 }
 
+QStringList LiveTVChain::EntriesToStringList(void) const
+{
+    QMutexLocker lock(&m_lock);
+
+    QStringList list;
+    list << QString::number(m_maxpos);
+
+    QList<LiveTVChainEntry>::const_iterator it = m_chain.begin();
+    for (; it != m_chain.end(); ++it)
+    {
+        list << QString::number((*it).chanid)
+             << (*it).starttime.toString(Qt::ISODate)
+             << (*it).endtime.toString(Qt::ISODate)
+             << QString::number((*it).discontinuity)
+             << (*it).hostprefix
+             << (*it).cardtype
+             << (*it).channum
+             << (*it).inputname;
+    }
+
+    return list;
+}
+
+bool LiveTVChain::EntriesFromStringList(const QStringList &data)
+{
+    if (data.empty() || ((data.size() - 1) % kEntryStrings))
+        return false;
+
+    bool ok;
+    int maxpos = data[0].toInt(&ok);
+    if (!ok)
+        return false;
+
+    QList<LiveTVChainEntry> chain;
+    for (int i = 1; i < data.size(); i += kEntryStrings)
+    {
+        LiveTVChainEntry entry;
+        entry.chanid = data[i].toUInt(&ok);
+        if (!ok)
+            return false;
+        entry.starttime = QDateTime::fromString(data[i+1], Qt::ISODate);
+        entry.endtime = QDateTime::fromString(data[i+2], Qt::ISODate);
+        entry.discontinuity = data[i+3].toInt();
+        entry.hostprefix = data[i+4];
+        entry.cardtype = data[i+5];
+        entry.channum = data[i+6];
+        entry.inputname = data[i+7];
+        chain.append(entry);
+    }
+
+    QMutexLocker lock(&m_lock);
+    m_chain = chain;
+    m_maxpos = maxpos;
+
+    return true;
+}
+
 void LiveTVChain::DestroyChain(void)
 {
     QMutexLocker lock(&m_lock);
@@ -207,11 +274,10 @@ void LiveTVChain::DestroyChain(void)
         MythDB::DBError("LiveTVChain::DestroyChain", query);
 }
 
-void LiveTVChain::ReloadAll(void)
+void LiveTVChain::LoadFromDB(void)
 {
     QMutexLocker lock(&m_lock);
 
-    int prev_size = m_chain.size();
     m_chain.clear();
 
     MSqlQuery query(MSqlQuery::InitCon());
@@ -241,6 +307,19 @@ void LiveTVChain::ReloadAll(void)
             m_chain.append(entry);
         }
     }
+}
+
+/** \fn LiveTVChain::ReloadAll(const QStringList&)
+ *  \brief Updates the chain from the data sent with a LIVETV_CHAIN UPDATE
+ *         event, or from the database when there is none.
+ */
+void LiveTVChain::ReloadAll(const QStringList &data)
+{
+    QMutexLocker lock(&m_lock);
+
+    int prev_size = m_chain.size();
+    if (!EntriesFromStringList(data))
+        LoadFromDB();
 
     m_curpos = ProgramIsAt(m_cur_chanid, m_cur_startts);
     if (m_curpos < 0)
@@ -2,6 +2,7 @@
 #define _LIVETVCHAIN_H_
 
 #include <QString>
+#include <QStringList>
 #include <QDateTime>
 #include <QMutex>
 #include <QList>
@@ -42,7 +43,7 @@ class MTV_PUBLIC LiveTVChain
     void FinishedRecording(ProgramInfo *pginfo);
     void DeleteProgram(ProgramInfo *pginfo);
 
-    void ReloadAll();
+    void ReloadAll(const QStringList &data = QStringList());
 
     // const gets
     QString GetID(void)  const { return m_id; }
@@ -86,6 +87,9 @@ class MTV_PUBLIC LiveTVChain
 
   private:
     void BroadcastUpdate();
+    QStringList EntriesToStringList(void) const;
+    bool EntriesFromStringList(const QStringList &data);
+    void LoadFromDB(void);
     void GetEntryAt(int at, LiveTVChainEntry &entry) const;
     static ProgramInfo *EntryToProgram(const LiveTVChainEntry &entry);
 
@@ -20,7 +20,7 @@ DVBStreamData::DVBStreamData(uint desired_netid,  uint desired_tsid,
     : MPEGStreamData(desired_program, cacheTables),
       _desired_netid(desired_netid), _desired_tsid(desired_tsid),
       _dvb_eit_dishnet_long(false),
-      _nit_version(-2), _nito_version(-2)
+      _nit_version(-2), _eit_schedule_complete(false), _nito_version(-2)
 {
     SetVersionNIT(-1,0);
     SetVersionNITo(-1,0);
@@ -189,6 +189,9 @@ void DVBStreamData::Reset(uint desired_netid, uint desired_tsid,
     _sdt_section_seen.clear();
     _eit_version.clear();
     _eit_section_seen.clear();
+    _eit_last_table.clear();
+    _eit_schedule_expected.clear();
+    _eit_schedule_complete = false;
     _cit_version.clear();
     _cit_section_seen.clear();
 
@@ -334,6 +337,7 @@ bool DVBStreamData::HandleTables(uint pid, const PSIPTable &psip)
             }
 
             QMutexLocker locker(&_listener_lock);
+            SetEITScheduleExpected(sdt, TableID::SC_EITbego);
             for (uint i = 0; i < _dvb_other_listeners.size(); i++)
                 _dvb_other_listeners[i]->HandleSDTo(tsid, &sdt);
 
@@ -369,6 +373,8 @@ bool DVBStreamData::HandleTables(uint pid, const PSIPTable &psip)
         SetEITSectionSeen(psip.TableID(), service_id, psip.Section());
 
         DVBEventInformationTable eit(psip);
+        SetEITScheduleSeen(eit);
+
         for (uint i = 0; i < _dvb_eit_listeners.size(); i++)
             _dvb_eit_listeners[i]->HandleEIT(&eit);
 
@@ -412,6 +418,8 @@ void DVBStreamData::ProcessSDT(uint tsid, const ServiceDescriptionTable *sdt)
             _dvb_has_eit[sdt->ServiceID(i)] = true;
     }
 
+    SetEITScheduleExpected(*sdt, TableID::SC_EITbeg);
+
     for (uint i = 0; i < _dvb_main_listeners.size(); i++)
         _dvb_main_listeners[i]->HandleSDT(tsid, sdt);
 }
@@ -682,6 +690,103 @@ bool DVBStreamData::EITSectionSeen(uint tableid, uint serviceid,
     return (bool) ((*it)[section>>3] & bit_sel[section & 0x7]);
 }
 
+bool DVBStreamData::HasAllEITSections(uint tableid, uint serviceid) const
+{
+    uint key = (tableid<<16) | serviceid;
+    sections_map_t::const_iterator it = _eit_section_seen.find(key);
+    if (it == _eit_section_seen.end())
+        return false;
+    for (uint i = 0; i < 32; i++)
+        if ((*it)[i] != 0xff)
+            return false;
+    return true;
+}
+
+/** \fn DVBStreamData::SetEITScheduleSeen(const DVBEventInformationTable&)
+ *  \brief Keeps track of whether all the schedule EIT tables have been seen.
+ *
+ *   The schedule is split into segments of eight sections, and the
+ *   sections after a segment's last section are never sent, so they are
+ *   marked as seen here. Neither are the segments after the table's
+ *   last section, so they are marked on its first section. The tables
+ *   of each service go from the first
+ *   schedule table id up to its last_table_id. All the tables are only
+ *   checked once the table of this section is complete.
+ *
+ *   The schedule is only complete once every service the SDTs flag as
+ *   carrying an EIT schedule has been seen, so services whose EIT has
+ *   not started arriving yet keep it incomplete.
+ */
+void DVBStreamData::SetEITScheduleSeen(const DVBEventInformationTable &eit)
+{
+    uint table_id = eit.TableID();
+    if (table_id < TableID::SC_EITbeg || table_id > TableID::SC_EITendo)
+        return;
+
+    uint service_id = eit.ServiceID();
+    uint section    = eit.Section();
+    uint seg_last   = max(eit.SegmentLastSectionNumber(), section);
+    for (uint i = seg_last + 1; i <= (section | 0x7); i++)
+        SetEITSectionSeen(table_id, service_id, i);
+
+    uint tbl_last   = (eit.LastSection() | 0x7) + 1;
+    if (tbl_last <= 0xff && !EITSectionSeen(table_id, service_id, tbl_last))
+    {
+        for (uint i = tbl_last; i <= 0xff; i++)
+            SetEITSectionSeen(table_id, service_id, i);
+    }
+
+    uint first = (table_id < TableID::SC_EITbego) ?
+        (uint) TableID::SC_EITbeg : (uint) TableID::SC_EITbego;
+    uint last  = min(max(eit.LastTableID(), table_id), first + 0xf);
+    _eit_last_table[(first << 16) | service_id] = last;
+
+    if (!HasAllEITSections(table_id, service_id))
+    {
+        _eit_schedule_complete = false;
+        return;
+    }
+
+    bool complete = !_eit_schedule_expected.empty();
+    QMap<uint, bool>::const_iterator ex = _eit_schedule_expected.begin();
+    for (; complete && ex != _eit_schedule_expected.end(); ++ex)
+        complete = _eit_last_table.contains(ex.key());
+
+    QMap<uint, uint>::const_iterator it = _eit_last_table.begin();
+    for (; complete && it != _eit_last_table.end(); ++it)
+    {
+        uint serviceid = it.key() & 0xffff;
+        for (uint tid = it.key() >> 16; complete && tid <= *it; tid++)
+            complete = HasAllEITSections(tid, serviceid);
+    }
+    _eit_schedule_complete = complete;
+}
+
+/** \fn DVBStreamData::SetEITScheduleExpected(const ServiceDescriptionTable&, uint)
+ *  \brief Records the services whose EIT schedule is carried on this
+ *         transport, according to their EIT_schedule_flag.
+ *
+ *  \param first_table SC_EITbeg for the SDT of this transport,
+ *                     SC_EITbego for the SDTs of other transports.
+ */
+void DVBStreamData::SetEITScheduleExpected(
+    const ServiceDescriptionTable &sdt, uint first_table)
+{
+    for (uint i = 0; i < sdt.ServiceCount(); i++)
+    {
+        if (!sdt.HasEITSchedule(i))
+            continue;
+
+        uint key = (first_table << 16) | sdt.ServiceID(i);
+        if (_eit_schedule_expected.contains(key))
+            continue;
+
+        _eit_schedule_expected[key] = true;
+        if (!_eit_last_table.contains(key))
+            _eit_schedule_complete = false;
+    }
+}
+
 void DVBStreamData::SetCITSectionSeen(uint contentid, uint section)
 {
     sections_map_t::iterator it = _cit_section_seen.find(contentid);
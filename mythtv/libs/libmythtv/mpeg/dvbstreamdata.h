@@ -167,6 +167,8 @@ class MTV_PUBLIC DVBStreamData : virtual public MPEGStreamData
 
     void SetEITSectionSeen(uint tableid, uint serviceid, uint section);
     bool EITSectionSeen(uint tableid, uint serviceid, uint section) const;
+    bool HasAllEITSections(uint tableid, uint serviceid) const;
+    virtual bool HasCompleteEIT(void) const { return _eit_schedule_complete; }
 
     void SetBATSectionSeen(uint bid, uint section);
     bool BATSectionSeen(uint bid, uint section) const;
@@ -202,6 +204,10 @@ class MTV_PUBLIC DVBStreamData : virtual public MPEGStreamData
     void RemoveDVBEITListener(DVBEITStreamListener*);
 
   private:
+    void SetEITScheduleSeen(const DVBEventInformationTable &eit);
+    void SetEITScheduleExpected(const ServiceDescriptionTable &sdt,
+                                uint first_table);
+
     // Caching
     void CacheNIT(NetworkInformationTable*);
     void CacheSDT(ServiceDescriptionTable*);
@@ -230,6 +236,14 @@ class MTV_PUBLIC DVBStreamData : virtual public MPEGStreamData
     sections_map_t            _sdt_section_seen;
     QMap<uint, int>           _eit_version;
     sections_map_t            _eit_section_seen;
+    /// (first schedule table id << 16 | serviceid) -> last table id
+    QMap<uint, uint>          _eit_last_table;
+    /// (first schedule table id << 16 | serviceid) of the services the
+    /// SDTs flag as having an EIT schedule on this transport
+    QMap<uint, bool>          _eit_schedule_expected;
+    /// Set when the schedule EIT tables of all the expected services
+    /// have been seen and are complete
+    volatile bool             _eit_schedule_complete;
     // Premiere private ContentInformationTable
     QMap<uint, int>           _cit_version;
     sections_map_t            _cit_section_seen;
@@ -2,6 +2,7 @@
 // Copyright (c) 2003-2004, Daniel Thor Kristjansson
 
 #include <algorithm> // for find & max
+#include <cstring>   // for memset
 using namespace std;
 
 // POSIX headers
@@ -70,6 +71,7 @@ MPEGStreamData::MPEGStreamData(int desiredProgram, bool cacheTables)
       _eit_helper(NULL), _eit_rate(0.0f),
       _listening_disabled(false),
       _encryption_lock(QMutex::Recursive), _listener_lock(QMutex::Recursive),
+      _sections_dropped(0), _sections_parsed(0),
       _cache_tables(cacheTables), _cache_lock(QMutex::Recursive),
       // Single program stuff
       _desired_program(desiredProgram),
@@ -186,6 +188,16 @@ void MPEGStreamData::Reset(int desiredProgram)
         DeletePartialPSIP(it.key());
     _partial_psip_packet_cache.clear();
 
+    if (_sections_dropped)
+    {
+        LOG(VB_SIPARSER, LOG_INFO,
+            QString("Dropped %1 repeated sections before assembly, "
+                    "parsed %2").arg(_sections_dropped).arg(_sections_parsed));
+    }
+    _section_filter.clear();
+    _sections_dropped = 0;
+    _sections_parsed  = 0;
+
     _pids_listening.clear();
     _pids_notlistening.clear();
     _pids_writing.clear();
@@ -229,6 +241,122 @@ void MPEGStreamData::DeletePartialPSIP(uint pid)
     }
 }
 
+/// Tables whose repeated sections are dropped before they are assembled.
+/// A Premiere CIT is told apart by its content id, the others by their
+/// table_id_extension.
+static const struct
+{
+    uint pid;        ///< only on this PID, or 0x1fff for any PID
+    uint table_beg;
+    uint table_end;
+    bool content_id;
+} kSectionFilter[] =
+{
+    // DVB NIT, SDT, BAT and EIT
+    { 0x1fff,                  TableID::NIT,    TableID::SDTo,       false },
+    { 0x1fff,                  TableID::BAT,    TableID::BAT,        false },
+    { 0x1fff,                  TableID::PF_EIT, TableID::SC_EITendo, false },
+    // Premiere CIT
+    { PREMIERE_EIT_DIREKT_PID, TableID::PREMIERE_CIT,
+                               TableID::PREMIERE_CIT,                true  },
+    { PREMIERE_EIT_SPORT_PID,  TableID::PREMIERE_CIT,
+                               TableID::PREMIERE_CIT,                true  },
+    // DishNet long term EIT and the ATSC MGT, VCT, RRT and EIT
+    { 0x1fff,                  TableID::DN_EITbego, TableID::DN_EITendo,
+                                                                     false },
+};
+
+/** \brief Returns the key of a section in the repeated section filter,
+ *         or 0 if its table is not filtered.
+ *
+ *   Only the first eight bytes of the section, or twelve for a Premiere
+ *   CIT, are read so the section need not be assembled yet.
+ */
+static quint64 section_filter_key(uint pid, const unsigned char *section,
+                                  uint size)
+{
+    // needs section_syntax_indicator and current_next_indicator set
+    if (size < 8 || !(section[1] & 0x80) || !(section[5] & 0x1))
+        return 0;
+
+    uint table_id = section[0];
+    for (uint i = 0; i < sizeof(kSectionFilter) / sizeof(kSectionFilter[0]);
+         i++)
+    {
+        if (table_id < kSectionFilter[i].table_beg ||
+            table_id > kSectionFilter[i].table_end ||
+            (kSectionFilter[i].pid != 0x1fff && kSectionFilter[i].pid != pid))
+        {
+            continue;
+        }
+
+        quint64 id = (section[3] << 8) | section[4];
+        if (kSectionFilter[i].content_id)
+        {
+            if (size < 12)
+                return 0;
+            id = ((quint64)section[8] << 24) | (section[9] << 16) |
+                 (section[10] << 8) | section[11];
+        }
+
+        return ((quint64)pid << 48) | ((quint64)table_id << 40) | (id << 8);
+    }
+
+    return 0;
+}
+
+/** \fn MPEGStreamData::IsRepeatedSection(uint,const unsigned char*,uint) const
+ *  \brief Returns true if this section has been seen before and was
+ *         redundant then, judging only from its header.
+ */
+bool MPEGStreamData::IsRepeatedSection(
+    uint pid, const unsigned char *section, uint size) const
+{
+    quint64 key = section_filter_key(pid, section, size);
+    if (!key)
+        return false;
+
+    section_filter_map_t::const_iterator it = _section_filter.find(key);
+    if (it == _section_filter.end())
+        return false;
+
+    uint version = (section[5] >> 1) & 0x1f;
+    uint num     = section[6];
+    return ((*it).version == (int) version) &&
+        ((*it).seen[num >> 3] & bit_sel[num & 0x7]);
+}
+
+/** \fn MPEGStreamData::SetSectionSeen(uint,const PSIPTable&)
+ *  \brief Adds a section to the repeated section filter.
+ *
+ *   This is only called for sections IsRedundant() returns true for
+ *   after they were handled, so the filter never drops a section the
+ *   table handling would still have looked at.
+ */
+void MPEGStreamData::SetSectionSeen(uint pid, const PSIPTable &psip)
+{
+    quint64 key = section_filter_key(pid, psip.pesdata(), psip.SectionLength());
+    if (!key)
+        return;
+
+    section_filter_map_t::iterator it = _section_filter.find(key);
+    if (it == _section_filter.end())
+    {
+        section_filter_t entry;
+        entry.version = -1;
+        it = _section_filter.insert(key, entry);
+    }
+
+    if ((*it).version != (int) psip.Version())
+    {
+        (*it).version = psip.Version();
+        memset((*it).seen, 0, sizeof((*it).seen));
+    }
+
+    uint num = psip.Section();
+    (*it).seen[num >> 3] |= bit_sel[num & 0x7];
+}
+
 /** \fn MPEGStreamData::AssemblePSIP(const TSPacket*,bool&)
  *  \brief PSIP packet assembler.
  *
@@ -362,7 +490,21 @@ PSIPTable* MPEGStreamData::AssemblePSIP(const TSPacket* tspacket,
 
     const unsigned char* pesdata = tspacket->data() + offset;
     const int pes_length = (pesdata[2] & 0x0f) << 8 | pesdata[3];
-    if ((pes_length + offset + extra_offset) > 188)
+
+    // Drop sections we have already seen before assembling them and
+    // checking their CRC, unless another section follows in this packet.
+    bool fits = (pes_length + offset + extra_offset) <= 188;
+    bool another = fits && (offset + pes_length + 3 < (int)TSPacket::kSize) &&
+        (pesdata[pes_length + 4] != 0xff);
+    if (!another && IsRepeatedSection(tspacket->PID(), pesdata + 1,
+                                      TSPacket::kSize - offset - 1))
+    {
+        _sections_dropped++;
+        moreTablePackets = false;
+        return 0;
+    }
+
+    if (!fits)
     {
         SavePartialPSIP(tspacket->PID(), new PSIPTable(*tspacket));
         moreTablePackets = false;
@@ -888,6 +1030,8 @@ void MPEGStreamData::HandleTSTables(const TSPacket* tspacket)
         DONE_WITH_PSIP_PACKET();
     }
 
+    _sections_parsed++;
+
     // Don't do validation on tables withotu CRC
     if (!psip->HasCRC())
     {
@@ -949,11 +1093,15 @@ void MPEGStreamData::HandleTSTables(const TSPacket* tspacket)
             for (uint i = 0; i < _mpeg_sp_listeners.size(); i++)
                 _mpeg_sp_listeners[i]->HandleSingleProgramPMT(pmt_sp);
         }
+        SetSectionSeen(tspacket->PID(), *psip);
         DONE_WITH_PSIP_PACKET(); // already parsed this table, toss it.
     }
 
     HandleTables(tspacket->PID(), *psip);
 
+    if (IsRedundant(tspacket->PID(), *psip))
+        SetSectionSeen(tspacket->PID(), *psip);
+
     DONE_WITH_PSIP_PACKET();
 }
 #undef DONE_WITH_PSIP_PACKET
@@ -1626,6 +1774,35 @@ void MPEGStreamData::RemoveMPEGSPListener(MPEGSingleProgramStreamListener *val)
     }
 }
 
+/** \fn MPEGStreamData::ResendSingleProgramTables(void)
+ *  \brief Sends the single program PAT and PMT made from the last tables
+ *         seen to the single program listeners again.
+ *
+ *   A recorder that starts a new file after a channel change then knows
+ *   the stream types the signal monitor already found, rather than
+ *   waiting for the PMT to be repeated. A recorder still waiting for its
+ *   first keyframe does not write the resent tables.
+ *
+ *  \return true if there were tables to send.
+ */
+bool MPEGStreamData::ResendSingleProgramTables(void)
+{
+    QMutexLocker locker(&_listener_lock);
+
+    ProgramAssociationTable *pat_sp = PATSingleProgram();
+    ProgramMapTable         *pmt_sp = PMTSingleProgram();
+    if (!pat_sp || !pmt_sp)
+        return false;
+
+    for (uint i = 0; i < _mpeg_sp_listeners.size(); i++)
+    {
+        _mpeg_sp_listeners[i]->HandleSingleProgramPAT(pat_sp);
+        _mpeg_sp_listeners[i]->HandleSingleProgramPMT(pmt_sp);
+    }
+
+    return true;
+}
+
 void MPEGStreamData::AddEncryptionTestPID(uint pnum, uint pid, bool isvideo)
 {
     QMutexLocker locker(&_encryption_lock);
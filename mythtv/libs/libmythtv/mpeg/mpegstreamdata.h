@@ -11,6 +11,7 @@
 using namespace std;
 
 // Qt
+#include <QHash>
 #include <QMap>
 
 #include "tspacket.h"
@@ -42,6 +43,14 @@ typedef vector<unsigned char>           uchar_vec_t;
 typedef uchar_vec_t                     sections_t;
 typedef QMap<uint, sections_t>          sections_map_t;
 
+/// Version and sections seen of a table, for dropping repeated sections
+typedef struct
+{
+    int           version;
+    unsigned char seen[32];
+} section_filter_t;
+typedef QHash<quint64, section_filter_t> section_filter_map_t;
+
 typedef vector<MPEGStreamListener*>     mpeg_listener_vec_t;
 typedef vector<TSPacketListener*>       ts_listener_vec_t;
 typedef vector<TSPacketListenerAV*>     ts_av_listener_vec_t;
@@ -101,6 +110,7 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     // EIT Source
     virtual void SetEITHelper(EITHelper *eit_helper);
     virtual void SetEITRate(float rate);
+    virtual bool HasCompleteEIT(void) const { return false; }
     virtual bool HasEITPIDChanges(const uint_vec_t& /*in_use_pids*/) const
         { return false; }
     virtual bool GetEITPIDChanges(const uint_vec_t& /*in_use_pids*/,
@@ -117,6 +127,11 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     virtual int  ProcessData(const unsigned char *buffer, int len);
     inline  void HandleAdaptationFieldControl(const TSPacket* tspacket);
 
+    /// Sections dropped as repeats before they were assembled
+    uint GetSectionsDropped(void) const { return _sections_dropped; }
+    /// Sections assembled after passing the repeated section filter
+    uint GetSectionsParsed(void) const  { return _sections_parsed; }
+
     // Listening
     virtual void AddListeningPID(
         uint pid, PIDPriority priority = kPIDPriorityNormal)
@@ -250,6 +265,7 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     void RemoveAVListener(TSPacketListenerAV*);
     void UpdatePATSingleProgram(ProgramAssociationTable*);
     void UpdatePMTSingleProgram(ProgramMapTable*);
+    bool ResendSingleProgramTables(void);
 
   public:
     // Single program stuff, sets
@@ -298,6 +314,9 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     void ClearPartialPSIP(uint pid)
         { _partial_psip_packet_cache.remove(pid); }
     void DeletePartialPSIP(uint pid);
+    bool IsRepeatedSection(uint pid, const unsigned char *section,
+                           uint size) const;
+    void SetSectionSeen(uint pid, const PSIPTable &psip);
     void ProcessPAT(const ProgramAssociationTable *pat);
     void ProcessPMT(const ProgramMapTable *pmt);
     void ProcessEncryptedPacket(const TSPacket&);
@@ -359,6 +378,11 @@ class MTV_PUBLIC MPEGStreamData : public EITSource
     // PSIP construction
     pid_psip_map_t            _partial_psip_packet_cache;
 
+    // Repeated section filter
+    section_filter_map_t      _section_filter;
+    uint                      _sections_dropped;
+    uint                      _sections_parsed;
+
     // Caching
     bool                             _cache_tables;
     mutable QMutex                   _cache_lock;
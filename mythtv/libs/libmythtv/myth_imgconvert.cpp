@@ -24,34 +24,283 @@
  *
  */
 
+// C++ headers
+#include <algorithm>
+using namespace std;
+
 extern "C" {
 #include "libswscale/swscale.h"
+#include "libavutil/pixdesc.h"
 }
 
+// Qt headers
 #include <QMutex>
 #include <QMutexLocker>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QMap>
 
+// MythTV headers
 #include "mythlogging.h"
+#include "mthreadpool.h"
 #include "myth_imgconvert.h"
 
-int myth_sws_img_convert(AVPicture *dst, PixelFormat dst_pix_fmt, AVPicture *src,
-                PixelFormat pix_fmt, int width, int height)
+#define LOC QString("ImgConvert: ")
+
+/// Most horizontal bands a frame is split into.
+static const int kMaxSlices         = 4;
+/// Bands are a multiple of this many rows, so that the chroma rows of
+/// every subsampled format are split evenly too.
+static const int kSliceAlign        = 16;
+/// Don't split frames into bands smaller than this.
+static const int kSliceMinHeight    = 64;
+/// Most idle scaler contexts kept around.
+static const int kMaxCachedContexts = 16;
+
+typedef struct imgconvertkey
+{
+    int         src_width;
+    int         src_height;
+    PixelFormat src_fmt;
+    int         dst_width;
+    int         dst_height;
+    PixelFormat dst_fmt;
+
+    bool operator<(const struct imgconvertkey &o) const
+    {
+        if (src_width != o.src_width)
+            return src_width < o.src_width;
+        if (src_height != o.src_height)
+            return src_height < o.src_height;
+        if (src_fmt != o.src_fmt)
+            return src_fmt < o.src_fmt;
+        if (dst_width != o.dst_width)
+            return dst_width < o.dst_width;
+        if (dst_height != o.dst_height)
+            return dst_height < o.dst_height;
+        return dst_fmt < o.dst_fmt;
+    }
+} ImgConvertKey;
+
+typedef QMultiMap<ImgConvertKey, struct SwsContext*> ImgConvertCache;
+
+static QMutex           cache_lock;
+static ImgConvertCache  cache;
+static MThreadPool     *pool = NULL;
+static int              pool_threads = 0;
+
+/** \brief Takes a scaler context out of the cache, or creates one.
+ *
+ *   Contexts are handed out for the exclusive use of one band of one
+ *   conversion and given back with release_context(), so conversions
+ *   on different threads never share a context.
+ */
+static struct SwsContext *acquire_context(const ImgConvertKey &key)
+{
+    {
+        QMutexLocker locker(&cache_lock);
+        ImgConvertCache::iterator it = cache.find(key);
+        if (it != cache.end())
+        {
+            struct SwsContext *ctx = *it;
+            cache.erase(it);
+            return ctx;
+        }
+    }
+
+    struct SwsContext *ctx = sws_getContext(
+        key.src_width, key.src_height, key.src_fmt,
+        key.dst_width, key.dst_height, key.dst_fmt,
+        SWS_FAST_BILINEAR, NULL, NULL, NULL);
+    if (!ctx)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Cannot initialize the image "
+                                               "conversion context for "
+                                               "%1x%2 to %3x%4")
+                .arg(key.src_width).arg(key.src_height)
+                .arg(key.dst_width).arg(key.dst_height));
+    }
+    return ctx;
+}
+
+static void release_context(const ImgConvertKey &key, struct SwsContext *ctx)
+{
+    if (!ctx)
+        return;
+
+    QMutexLocker locker(&cache_lock);
+    if (cache.size() >= kMaxCachedContexts)
+    {
+        sws_freeContext(*cache.begin());
+        cache.erase(cache.begin());
+    }
+    cache.insert(key, ctx);
+}
+
+/// Returns the pool running all but the first band of each conversion.
+static MThreadPool *get_pool(void)
+{
+    QMutexLocker locker(&cache_lock);
+    if (!pool)
+    {
+        pool_threads = min(QThread::idealThreadCount(), kMaxSlices);
+        if (pool_threads > 1)
+        {
+            pool = new MThreadPool("ImgConvert");
+            pool->setMaxThreadCount(pool_threads - 1);
+        }
+    }
+    return pool;
+}
+
+/// Formats which can be converted in independent horizontal bands.
+static bool is_sliceable(PixelFormat fmt)
+{
+    if (fmt < 0 || fmt >= PIX_FMT_NB)
+        return false;
+    return !(av_pix_fmt_descriptors[fmt].flags &
+             (PIX_FMT_PAL | PIX_FMT_BITSTREAM | PIX_FMT_HWACCEL));
+}
+
+/// Points band at the row'th row of every plane of pict.
+static void offset_picture(AVPicture *band, const AVPicture *pict,
+                           PixelFormat fmt, int row)
+{
+    int chroma_shift = av_pix_fmt_descriptors[fmt].log2_chroma_h;
+    for (int i = 0; i < 4; i++)
+    {
+        band->linesize[i] = pict->linesize[i];
+        if (!pict->data[i])
+        {
+            band->data[i] = NULL;
+            continue;
+        }
+        // Planes 1 and 2 hold chroma, plane 3 is alpha at full height
+        int plane_row = (i == 1 || i == 2) ? (row >> chroma_shift) : row;
+        band->data[i] = pict->data[i] + plane_row * pict->linesize[i];
+    }
+}
+
+class ImgConvertSlice : public QRunnable
 {
-    static QMutex ctx_lock;
-    static struct SwsContext *convert_ctx;
+  public:
+    ImgConvertSlice() : m_ctx(NULL), m_height(0), m_done(NULL)
+    {
+        setAutoDelete(false);
+    }
 
-    QMutexLocker locker(&ctx_lock);
-    convert_ctx = sws_getCachedContext(convert_ctx, width, height, pix_fmt,
-                                       width, height, dst_pix_fmt,
-                                       SWS_FAST_BILINEAR, NULL, NULL, NULL);
-    if (convert_ctx == NULL) {
-        LOG(VB_GENERAL, LOG_ERR, "myth_sws_img_convert: Cannot initialize "
-                                 "the image conversion context");
-        return -1;
+    void Set(struct SwsContext *ctx, const AVPicture &src, const AVPicture &dst,
+             int height, QSemaphore *done)
+    {
+        m_ctx    = ctx;
+        m_src    = src;
+        m_dst    = dst;
+        m_height = height;
+        m_done   = done;
     }
 
-    sws_scale(convert_ctx, src->data, src->linesize,
-              0, height, dst->data, dst->linesize);
+    void run(void)
+    {
+        sws_scale(m_ctx, m_src.data, m_src.linesize, 0, m_height,
+                  m_dst.data, m_dst.linesize);
+        m_done->release();
+    }
+
+  private:
+    struct SwsContext *m_ctx;
+    AVPicture          m_src;
+    AVPicture          m_dst;
+    int                m_height;
+    QSemaphore        *m_done;
+};
+
+int myth_sws_img_scale(AVPicture *dst, PixelFormat dst_pix_fmt,
+                       int dst_width, int dst_height,
+                       const AVPicture *src, PixelFormat pix_fmt,
+                       int width, int height, int max_threads)
+{
+    MThreadPool *threads = get_pool();
+    if (max_threads <= 0)
+        max_threads = pool_threads;
+
+    // Bands only convert independently when no rows are scaled
+    // vertically, as a scaled row depends on the rows around it.
+    int bands = 1;
+    if (threads && (height == dst_height) &&
+        is_sliceable(pix_fmt) && is_sliceable(dst_pix_fmt))
+    {
+        bands = min(min(max_threads, pool_threads),
+                    max(height / kSliceMinHeight, 1));
+    }
+
+    int band_height = (height + bands - 1) / bands;
+    band_height = (band_height + kSliceAlign - 1) & ~(kSliceAlign - 1);
+    band_height = min(band_height, height);
+
+    ImgConvertKey      keys[kMaxSlices];
+    struct SwsContext *ctxs[kMaxSlices];
+    ImgConvertSlice    slices[kMaxSlices];
+    bool               queued[kMaxSlices];
+    QSemaphore done;
+    int count = 0, started = 0, ret = 0;
 
-    return 0;
+    for (int row = 0; (row < height) && (count < bands); count++)
+    {
+        ImgConvertKey &key = keys[count];
+        key.src_width  = width;
+        key.src_height = (count == bands - 1) ? height - row :
+                         min(band_height, height - row);
+        key.src_fmt    = pix_fmt;
+        key.dst_width  = dst_width;
+        key.dst_height = (bands > 1) ? key.src_height : dst_height;
+        key.dst_fmt    = dst_pix_fmt;
+
+        queued[count] = false;
+        ctxs[count] = acquire_context(key);
+        if (!ctxs[count])
+        {
+            ret = -1;
+            count++;
+            break;
+        }
+
+        AVPicture src_band, dst_band;
+        offset_picture(&src_band, src, pix_fmt, row);
+        offset_picture(&dst_band, dst, dst_pix_fmt, row);
+        row += key.src_height;
+
+        // The calling thread converts the first band itself, and any
+        // band the pool has no idle thread for.
+        slices[count].Set(ctxs[count], src_band, dst_band,
+                          key.src_height, &done);
+        if (count && threads->tryStart(&slices[count], "ImgConvertSlice"))
+        {
+            queued[count] = true;
+            started++;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (ctxs[i] && !queued[i])
+        {
+            slices[i].run();
+            started++;
+        }
+    }
+
+    done.acquire(started);
+
+    for (int i = 0; i < count; i++)
+        release_context(keys[i], ctxs[i]);
+
+    return ret;
+}
+
+int myth_sws_img_convert(AVPicture *dst, PixelFormat dst_pix_fmt, AVPicture *src,
+                PixelFormat pix_fmt, int width, int height)
+{
+    return myth_sws_img_scale(dst, dst_pix_fmt, width, height,
+                              src, pix_fmt, width, height);
 }
@@ -41,4 +41,17 @@ MTV_PUBLIC int myth_sws_img_convert(AVPicture *dst, PixelFormat dst_pix_fmt,
                                  AVPicture *src, PixelFormat pix_fmt,
                                  int width, int height);
 
+/**
+ * convert among pixel formats and scale
+ * Writes straight into the planes of dst. When no rows are scaled
+ * vertically the frame is converted in horizontal bands on up to
+ * max_threads threads, 0 meaning as many as are useful. Scaler
+ * contexts are cached, so repeated calls with the same sizes and
+ * formats don't set up a new one.
+ */
+MTV_PUBLIC int myth_sws_img_scale(AVPicture *dst, PixelFormat dst_pix_fmt,
+                                  int dst_width, int dst_height,
+                                  const AVPicture *src, PixelFormat pix_fmt,
+                                  int width, int height, int max_threads = 0);
+
 #endif /* MYTH_IMGCONVERT_H */
@@ -208,7 +208,9 @@ MythPlayer::MythPlayer(PlayerFlags flags)
       // LiveTVChain stuff
       m_tv(NULL),                   isDummy(false),
       // Debugging variables
-      output_jmeter(new Jitterometer(LOC))
+      output_jmeter(new Jitterometer(LOC)),
+      seek_last_ms(0),              seek_total_ms(0),
+      seek_count(0)
 {
     memset(&tc_lastval, 0, sizeof(tc_lastval));
     memset(&tc_wrap,    0, sizeof(tc_wrap));
@@ -1147,6 +1149,60 @@ void MythPlayer::DiscardVideoFrames(bool next_frame_keyframe)
         videoOutput->DiscardFrames(next_frame_keyframe);
 }
 
+/** \fn MythPlayer::ShareVideoFrame(VideoFrame*)
+ *  \brief Keeps a decoded frame from being decoded onto so that it
+ *         can be read in place, instead of being copied.
+ *
+ *   Every successful call must be matched by an UnshareVideoFrame()
+ *   call. When this returns false the frame must be copied instead.
+ */
+bool MythPlayer::ShareVideoFrame(VideoFrame *buffer)
+{
+    if (videoOutput)
+        return videoOutput->ShareFrame(buffer);
+    return false;
+}
+
+/** \fn MythPlayer::UnshareVideoFrame(VideoFrame*)
+ *  \brief Lets a frame passed to ShareVideoFrame() be decoded onto again.
+ */
+void MythPlayer::UnshareVideoFrame(VideoFrame *buffer)
+{
+    if (videoOutput)
+        videoOutput->UnshareFrame(buffer);
+}
+
+/** \fn MythPlayer::CacheGOPFrame(long long, const VideoFrame*)
+ *  \brief Keeps a copy of a frame an exact seek from keyframe decoded
+ *         and skipped, see VideoBuffers::CacheGOPFrame().
+ */
+void MythPlayer::CacheGOPFrame(long long keyframe, const VideoFrame *frame)
+{
+    if (videoOutput)
+        videoOutput->CacheGOPFrame(keyframe, frame);
+}
+
+/** \fn MythPlayer::GetGOPFrame(long long, long long, VideoFrame*)
+ *  \brief Fills buffer with a frame kept by CacheGOPFrame().
+ *  \return false if the frame isn't cached.
+ */
+bool MythPlayer::GetGOPFrame(long long keyframe, long long frameNumber,
+                             VideoFrame *frame)
+{
+    if (videoOutput)
+        return videoOutput->GetGOPFrame(keyframe, frameNumber, frame);
+    return false;
+}
+
+/** \fn MythPlayer::ClearGOPCache(void)
+ *  \brief Frees the frames kept by CacheGOPFrame().
+ */
+void MythPlayer::ClearGOPCache(void)
+{
+    if (videoOutput)
+        videoOutput->ClearGOPCache();
+}
+
 void MythPlayer::DrawSlice(VideoFrame *frame, int x, int y, int w, int h)
 {
     if (videoOutput)
@@ -2603,6 +2659,15 @@ void MythPlayer::JumpToProgram(void)
     if (nextpos > 10)
         DoFastForward(nextpos, true, false);
 
+    player_ctx->ChannelChangePhaseDone("open");
+    QString times = player_ctx->ChannelChangeDone();
+    if (!times.isEmpty() &&
+        gCoreContext->GetNumSetting("ShowChannelChangeTimes", 0))
+    {
+        SetOSDMessage(QObject::tr("Channel change %1").arg(times),
+                      kOSDTimeout_Long);
+    }
+
     player_ctx->SetPlayerChangingBuffers(false);
     LOG(VB_PLAYBACK, LOG_INFO, LOC + "JumpToProgram - end");
 }
@@ -3390,7 +3455,10 @@ void MythPlayer::ChangeSpeed(void)
     {
         videoOutput->SetPrebuffering(ffrew_skip == 1);
         if (decoder)
+        {
             decoder->setExactSeeks(exactseeks && ffrew_skip == 1);
+            decoder->setTrickPlay(ffrew_skip != 1 && ffrew_skip != 0);
+        }
         if (play_speed != 0.0f && !(last_speed == 0.0f && ffrew_skip == 1))
             DoJumpToFrame(framesPlayed + fftime - rewindtime);
     }
@@ -3643,6 +3711,9 @@ void MythPlayer::WaitForSeek(uint64_t frame, bool override_seeks,
     if (frame >= max)
         frame = max - 1;
 
+    MythTimer seekTimer;
+    seekTimer.start();
+
     decoderSeekLock.lock();
     decoderSeek = frame;
     decoderSeekLock.unlock();
@@ -3672,6 +3743,12 @@ void MythPlayer::WaitForSeek(uint64_t frame, bool override_seeks,
         osdLock.unlock();
     }
     decoder->setExactSeeks(after);
+
+    seek_last_ms   = seekTimer.elapsed();
+    seek_total_ms += seek_last_ms;
+    seek_count++;
+    LOG(VB_PLAYBACK, LOG_INFO, LOC +
+        QString("Seek to frame %1 took %2 ms").arg(frame).arg(seek_last_ms));
 }
 
 /** \fn MythPlayer::ClearAfterSeek(bool)
@@ -4088,6 +4165,9 @@ char *MythPlayer::GetScreenGrab(int secondsin, int &bufflen,
  *
  *   Warning: Don't use this on something you're playing!
  *
+ *   The file is only opened on the first call, later calls on the
+ *   same player just seek to the new frame.
+ *
  *  \param frameNum  [in]  Frame number to capture
  *  \param absolute  [in]  If False, make sure we aren't in cutlist or Comm brk
  *  \param bufflen   [out] Size of buffer returned in bytes
@@ -4108,7 +4188,9 @@ char *MythPlayer::GetScreenGrabAtFrame(uint64_t frameNum, bool absolute,
     memset(&orig,   0, sizeof(AVPicture));
     memset(&retbuf, 0, sizeof(AVPicture));
 
-    if (OpenFile(0) < 0)
+    // The file and video output stay open between calls, so a caller
+    // can grab several frames from one recording without reopening it.
+    if (!decoder && (OpenFile(0) < 0))
     {
         LOG(VB_GENERAL, LOG_ERR, LOC + "Could not open file for preview.");
         return NULL;
@@ -4131,7 +4213,7 @@ char *MythPlayer::GetScreenGrabAtFrame(uint64_t frameNum, bool absolute,
         return (char*) outputbuf;
     }
 
-    if (!InitVideo())
+    if (!videoOutput && !InitVideo())
     {
         LOG(VB_GENERAL, LOG_ERR, LOC +
             "Unable to initialize video for screen grab.");
@@ -4172,8 +4254,22 @@ char *MythPlayer::GetScreenGrabAtFrame(uint64_t frameNum, bool absolute,
     avpicture_fill(&orig, data, PIX_FMT_YUV420P,
                    video_dim.width(), video_dim.height());
 
-    avpicture_deinterlace(&orig, &orig, PIX_FMT_YUV420P,
+    // The decoded frame may still be on screen or shared with another
+    // reader, so deinterlace into a scratch picture rather than in place.
+    AVPicture deint;
+    if (avpicture_alloc(&deint, PIX_FMT_YUV420P,
+                        video_dim.width(), video_dim.height()))
+    {
+        bufflen = 0;
+        vw = vh = 0;
+        ar = 0;
+        DiscardVideoFrame(frame);
+        return NULL;
+    }
+
+    avpicture_deinterlace(&deint, &orig, PIX_FMT_YUV420P,
                           video_dim.width(), video_dim.height());
+    videoOutput->CountFrameCopy(frame->size);
 
     bufflen = video_dim.width() * video_dim.height() * 4;
     outputbuf = new unsigned char[bufflen];
@@ -4182,9 +4278,11 @@ char *MythPlayer::GetScreenGrabAtFrame(uint64_t frameNum, bool absolute,
                    video_dim.width(), video_dim.height());
 
     myth_sws_img_convert(
-        &retbuf, PIX_FMT_RGB32, &orig, PIX_FMT_YUV420P,
+        &retbuf, PIX_FMT_RGB32, &deint, PIX_FMT_YUV420P,
                 video_dim.width(), video_dim.height());
 
+    avpicture_free(&deint);
+
     vw = video_dim.width();
     vh = video_dim.height();
     ar = frame->aspect;
@@ -4518,6 +4616,7 @@ void MythPlayer::GetPlaybackData(InfoMap &infoMap)
         QString frames = QString("%1/%2").arg(videoOutput->ValidVideoFrames())
                                          .arg(videoOutput->FreeVideoFrames());
         infoMap.insert("videoframes", frames);
+        infoMap.insert("videolocks", videoOutput->GetBufferLockStatus());
     }
     if (decoder)
         infoMap["videodecoder"] = decoder->GetCodecDecoderName();
@@ -4529,6 +4628,11 @@ void MythPlayer::GetPlaybackData(InfoMap &infoMap)
             .arg(output_jmeter->GetLastSD(), 0, 'f', 2);
         infoMap["load"] = output_jmeter->GetLastCPUStats();
     }
+    if (seek_count)
+    {
+        infoMap["seektime"] = QString("%1 ms (avg %2 ms)")
+            .arg(seek_last_ms).arg(seek_total_ms / seek_count);
+    }
     GetCodecDescription(infoMap);
 }
 
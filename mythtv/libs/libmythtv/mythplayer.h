@@ -254,6 +254,12 @@ class MTV_PUBLIC MythPlayer
     void ClearDummyVideoFrame(VideoFrame *frame);
     void DiscardVideoFrame(VideoFrame *buffer);
     void DiscardVideoFrames(bool next_frame_keyframe);
+    bool ShareVideoFrame(VideoFrame *buffer);
+    void UnshareVideoFrame(VideoFrame *buffer);
+    void CacheGOPFrame(long long keyframe, const VideoFrame *frame);
+    bool GetGOPFrame(long long keyframe, long long frameNumber,
+                     VideoFrame *frame);
+    void ClearGOPCache(void);
     void DrawSlice(VideoFrame *frame, int x, int y, int w, int h);
     /// Returns the stream decoder currently in use.
     DecoderBase *GetDecoder(void) { return decoder; }
@@ -775,6 +781,9 @@ class MTV_PUBLIC MythPlayer
 
     // Debugging variables
     Jitterometer *output_jmeter;
+    int           seek_last_ms;   ///< time the last seek took
+    long long     seek_total_ms;  ///< time all seeks took
+    uint          seek_count;
 };
 
 #endif
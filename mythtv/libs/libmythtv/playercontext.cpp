@@ -483,22 +483,26 @@ void PlayerContext::StopPlaying(void)
         player->StopPlaying();
 }
 
-void PlayerContext::UpdateTVChain(void)
+void PlayerContext::UpdateTVChain(const QStringList &data)
 {
     QMutexLocker locker(&deletePlayerLock);
     if (tvchain && player)
     {
-        tvchain->ReloadAll();
+        tvchain->ReloadAll(data);
         player->CheckTVChain();
     }
 }
 
-bool PlayerContext::ReloadTVChain(void)
+/** \fn PlayerContext::ReloadTVChain(const QStringList&)
+ *  \brief Reloads the chain from the data of a LIVETV_CHAIN UPDATE event,
+ *         or from the database when there is no data.
+ */
+bool PlayerContext::ReloadTVChain(const QStringList &data)
 {
     if (!tvchain)
         return false;
 
-    tvchain->ReloadAll();
+    tvchain->ReloadAll(data);
     ProgramInfo *pinfo = tvchain->GetProgramAt(-1);
     if (pinfo)
     {
@@ -551,6 +555,72 @@ QString PlayerContext::PopPreviousChannel(void)
     return chan;
 }
 
+/** \fn PlayerContext::StartChannelChange(void)
+ *  \brief Starts timing a LiveTV channel change.
+ *
+ *   The UI thread and the player thread each add the phases they
+ *   handle with ChannelChangePhaseDone(), the recorder's phases are
+ *   added with SetChannelChangeBackendTimes() when its event arrives.
+ */
+void PlayerContext::StartChannelChange(void)
+{
+    QMutexLocker locker(&chanChangeLock);
+    chanChangePhases.clear();
+    chanChangeBackend.clear();
+    chanChangeTimer.start();
+}
+
+/// Notes how long the last phase of the channel change took.
+void PlayerContext::ChannelChangePhaseDone(const QString &phase)
+{
+    QMutexLocker locker(&chanChangeLock);
+    if (chanChangeTimer.isRunning())
+        chanChangePhases << phase << QString::number(chanChangeTimer.restart());
+}
+
+void PlayerContext::SetChannelChangeBackendTimes(const QStringList &times)
+{
+    QMutexLocker locker(&chanChangeLock);
+    if (chanChangeTimer.isRunning())
+        chanChangeBackend = times;
+}
+
+static QString format_phases(const QStringList &phases, int &total)
+{
+    QStringList list;
+    total = 0;
+    for (int i = 0; i + 1 < phases.size(); i += 2)
+    {
+        total += phases[i+1].toInt();
+        list << QString("%1 %2").arg(phases[i]).arg(phases[i+1]);
+    }
+    return list.join(", ");
+}
+
+/** \fn PlayerContext::ChannelChangeDone(void)
+ *  \brief Stops timing the channel change and logs the phases.
+ *  \return the phases in ms, or an empty string if no channel change
+ *          was being timed.
+ */
+QString PlayerContext::ChannelChangeDone(void)
+{
+    QMutexLocker locker(&chanChangeLock);
+    if (!chanChangeTimer.isRunning())
+        return QString();
+    chanChangeTimer.stop();
+
+    int total, backend_total;
+    QString msg = format_phases(chanChangePhases, total);
+    QString backend = format_phases(chanChangeBackend, backend_total);
+    msg = QString("%1 ms: %2").arg(total).arg(msg);
+    if (!backend.isEmpty())
+        msg += QString(" (backend: %1)").arg(backend);
+
+    LOG(VB_PLAYBACK, LOG_INFO, LOC + "Channel change took " + msg);
+
+    return msg;
+}
+
 QString PlayerContext::GetPreviousChannel(void) const
 {
     if (prevChan.empty())
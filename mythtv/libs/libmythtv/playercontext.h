@@ -56,8 +56,8 @@ class MTV_PUBLIC PlayerContext
     void TeardownPlayer(void);
     bool StartPlaying(int maxWait = -1);
     void StopPlaying(void);
-    void UpdateTVChain(void);
-    bool ReloadTVChain(void);
+    void UpdateTVChain(const QStringList &data = QStringList());
+    bool ReloadTVChain(const QStringList &data = QStringList());
     void CreatePIPWindow(const QRect&, int pos = -1, 
                         QWidget *widget = NULL);
     void ResizePIPWindow(const QRect&);
@@ -69,6 +69,11 @@ class MTV_PUBLIC PlayerContext
     void    PushPreviousChannel(void);
     QString PopPreviousChannel(void);
 
+    void    StartChannelChange(void);
+    void    ChannelChangePhaseDone(const QString &phase);
+    void    SetChannelChangeBackendTimes(const QStringList &times);
+    QString ChannelChangeDone(void);
+
     void ChangeState(TVState newState);
     void ForceNextStateNone(void);
     TVState DequeueNextState(void);
@@ -193,6 +198,12 @@ class MTV_PUBLIC PlayerContext
     mutable InfoMap     lastSignalUIInfo;
     mutable MythTimer   lastSignalUIInfoTime;
 
+    // Channel change timing, as name/ms pairs
+    QMutex              chanChangeLock;
+    MythTimer           chanChangeTimer;
+    QStringList         chanChangePhases;
+    QStringList         chanChangeBackend;
+
     // tv state related
     MythDeque<TVState>  nextState;
 
@@ -195,9 +195,10 @@ bool PreviewGenerator::Run(void)
     QTime tm = QTime::currentTime();
     bool ok = false;
     QString command = GetInstallPrefix() + "/bin/mythpreviewgen";
+    bool in_process = !!(mode & kInProcess);
     bool local_ok = ((IsLocal() || !!(mode & kForceLocal)) &&
                      (!!(mode & kLocal)) &&
-                     QFileInfo(command).isExecutable());
+                     (in_process || QFileInfo(command).isExecutable()));
     if (!local_ok)
     {
         if (!!(mode & kRemote))
@@ -219,6 +220,26 @@ bool PreviewGenerator::Run(void)
             msg = "Failed, local preview requested for remote file.";
         }
     }
+    else if (in_process)
+    {
+        // Decode in this process, this saves the cost of starting
+        // mythpreviewgen and of it connecting to the database.
+        ok = LocalPreviewRun();
+        if (ok)
+        {
+            msg = QString("Generated on %1 in %2 seconds, starting at %3")
+                .arg(gCoreContext->GetHostName())
+                .arg(tm.elapsed()*0.001)
+                .arg(tm.toString(Qt::ISODate));
+        }
+        else
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Run() in process preview failed for: '%1'")
+                    .arg(pathname));
+            msg = "Failed to generate preview.";
+        }
+    }
     else
     {
         // This is where we fork and run mythpreviewgen to actually make preview
@@ -761,16 +782,44 @@ char *PreviewGenerator::GetScreenGrab(
     int &bufferlen,
     int &video_width, int &video_height, float &video_aspect)
 {
-    (void) pginfo;
-    (void) filename;
-    (void) seektime;
-    (void) time_in_secs;
-    (void) bufferlen;
-    (void) video_width;
-    (void) video_height;
     char *retbuf = NULL;
     bufferlen = 0;
 
+    PlayerContext *ctx = CreatePreviewContext(pginfo, filename);
+    if (!ctx)
+        return NULL;
+
+    if (time_in_secs)
+        retbuf = ctx->player->GetScreenGrab(seektime, bufferlen,
+                                    video_width, video_height, video_aspect);
+    else
+        retbuf = ctx->player->GetScreenGrabAtFrame(
+            seektime, true, bufferlen,
+            video_width, video_height, video_aspect);
+
+    delete ctx;
+
+    if (retbuf)
+    {
+        LOG(VB_GENERAL, LOG_INFO, LOC +
+            QString("Grabbed preview '%0' %1x%2@%3%4")
+                .arg(filename).arg(video_width).arg(video_height)
+                .arg(seektime).arg((time_in_secs) ? "s" : "f"));
+    }
+
+    return retbuf;
+}
+
+/**
+ *  \brief Creates a player for grabbing frames from a recording.
+ *
+ *  \return PlayerContext with a muted player using a null video output
+ *          if the file could be opened, NULL otherwise. The caller must
+ *          delete the returned context.
+ */
+PlayerContext *PreviewGenerator::CreatePreviewContext(
+    const ProgramInfo &pginfo, const QString &filename)
+{
     if (!MSqlQuery::testDBConnection())
     {
         LOG(VB_GENERAL, LOG_ERR, LOC + "Previewer could not connect to DB.");
@@ -806,25 +855,173 @@ char *PreviewGenerator::GetScreenGrab(
     ctx->SetPlayer(new MythPlayer((PlayerFlags)(kAudioMuted | kVideoIsNull)));
     ctx->player->SetPlayerInfo(NULL, NULL, true, ctx);
 
-    if (time_in_secs)
-        retbuf = ctx->player->GetScreenGrab(seektime, bufferlen,
-                                    video_width, video_height, video_aspect);
-    else
-        retbuf = ctx->player->GetScreenGrabAtFrame(
-            seektime, true, bufferlen,
-            video_width, video_height, video_aspect);
+    return ctx;
+}
+
+/**
+ *  \brief Grabs the frames chosen by the listener from one open of the
+ *         recording.
+ *
+ *   The decoder is kept open and only seeks between grabs. Once the file
+ *   is open the listener is asked which frames to grab, and each grab is
+ *   handed to it in order. A frame that can not be grabbed is skipped.
+ *
+ *  \return false if the recording could not be opened.
+ */
+bool PreviewGenerator::GrabFrames(const ProgramInfo   &pginfo,
+                                  const QString       &filename,
+                                  PreviewGrabListener &listener)
+{
+    PlayerContext *ctx = CreatePreviewContext(pginfo, filename);
+    if (!ctx)
+        return false;
+
+    if (ctx->player->OpenFile(0) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Previewer could not open file: " +
+                QString("'%1'").arg(filename));
+        delete ctx;
+        return false;
+    }
+
+    QList<uint64_t> frames = listener.GetGrabFrames(
+        ctx->player->GetFrameRate(), ctx->player->GetTotalFrameCount());
+
+    for (int i = 0; i < frames.size(); i++)
+    {
+        float aspect = 0;
+        int   width = 0, height = 0, sz = 0;
+        unsigned char *data = (unsigned char*)
+            ctx->player->GetScreenGrabAtFrame(
+                frames[i], true, sz, width, height, aspect);
+
+        if (!data || !width || !height)
+        {
+            LOG(VB_GENERAL, LOG_WARNING, LOC +
+                QString("Could not grab frame %1 of '%2'")
+                    .arg(frames[i]).arg(filename));
+            delete[] data;
+            continue;
+        }
+
+        bool more = listener.HandleGrab(
+            i, frames[i], data, width, height, aspect);
+        delete[] data;
+
+        if (!more)
+            break;
+    }
 
     delete ctx;
 
-    if (retbuf)
+    return true;
+}
+
+/// Saves each grab of a GeneratePreviewBatch() call at every size.
+class PreviewBatchSaver : public PreviewGrabListener
+{
+  public:
+    PreviewBatchSaver(const QString &filename, const QList<long long> &times,
+                      bool time_in_secs, const QList<QSize> &sizes,
+                      QStringList &outputFiles) :
+        m_filename(filename), m_times(times), m_timeInSecs(time_in_secs),
+        m_sizes(sizes), m_outputFiles(outputFiles) { }
+
+    QList<uint64_t> GetGrabFrames(float fps, uint64_t)
     {
-        LOG(VB_GENERAL, LOG_INFO, LOC +
-            QString("Grabbed preview '%0' %1x%2@%3%4")
-                .arg(filename).arg(video_width).arg(video_height)
-                .arg(seektime).arg((time_in_secs) ? "s" : "f"));
+        QList<uint64_t> frames;
+        QList<long long>::iterator it = m_times.begin();
+        while (it != m_times.end())
+        {
+            if (*it < 0)
+            {
+                it = m_times.erase(it);
+                continue;
+            }
+            frames.push_back((m_timeInSecs) ?
+                             (uint64_t)((*it) * fps) : (uint64_t)(*it));
+            ++it;
+        }
+        return frames;
     }
 
-    return retbuf;
+    bool HandleGrab(uint index, uint64_t, const unsigned char *data,
+                    int width, int height, float aspect)
+    {
+        QList<QSize>::const_iterator sit = m_sizes.begin();
+        for (; sit != m_sizes.end(); ++sit)
+        {
+            QString outname = QString("%1.%2%3.%4x%5.png")
+                .arg(m_filename).arg(m_times[index])
+                .arg((m_timeInSecs) ? "s" : "f")
+                .arg((*sit).width()).arg((*sit).height());
+
+            int dw = ((*sit).width()  < 0) ? width  : (*sit).width();
+            int dh = ((*sit).height() < 0) ? height : (*sit).height();
+
+            if (PreviewGenerator::SavePreview(
+                    outname, data, width, height, aspect, dw, dh))
+            {
+                m_outputFiles.push_back(outname);
+            }
+        }
+        return true;
+    }
+
+  private:
+    QString           m_filename;
+    QList<long long>  m_times;
+    bool              m_timeInSecs;
+    QList<QSize>      m_sizes;
+    QStringList      &m_outputFiles;
+};
+
+/**
+ *  \brief Creates previews at several times and sizes from one open
+ *         of the recording.
+ *
+ *   Each time is grabbed once and then scaled to every requested size,
+ *   see GrabFrames(). This is meant for scrubbing strips and other users
+ *   that want many previews of one recording. The recording must be
+ *   local.
+ *
+ *   The images are named "<pathname>.<time><s|f>.<width>x<height>.png",
+ *   where time and the s or f suffix are as requested and the size is
+ *   the one asked for, a size of 0x0 uses the default preview size.
+ *
+ *  \param pginfo       Recording to grab from.
+ *  \param times        Seconds or frames into the video of each preview.
+ *  \param time_in_secs if true times are in seconds, otherwise in frames.
+ *  \param sizes        Output sizes, each time is saved at each size.
+ *  \param outputFiles  Returns the names of the images saved.
+ *  \return Number of images saved.
+ */
+uint PreviewGenerator::GeneratePreviewBatch(
+    const ProgramInfo &pginfo, const QList<long long> &times,
+    bool time_in_secs, const QList<QSize> &sizes, QStringList &outputFiles)
+{
+    outputFiles.clear();
+
+    if (times.empty() || sizes.empty())
+        return 0;
+
+    ProgramInfo proginfo(pginfo);
+    QString filename = proginfo.GetPathname();
+    QTime tm = QTime::currentTime();
+
+    proginfo.MarkAsInUse(true, kPreviewGeneratorInUseID);
+
+    PreviewBatchSaver saver(filename, times, time_in_secs, sizes,
+                            outputFiles);
+    GrabFrames(proginfo, filename, saver);
+
+    proginfo.MarkAsInUse(false, kPreviewGeneratorInUseID);
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("Saved %1 batch previews of '%2' in %3 seconds")
+            .arg(outputFiles.size()).arg(filename).arg(tm.elapsed()*0.001));
+
+    return outputFiles.size();
 }
 
 /* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -6,6 +6,7 @@
 #include <QDateTime>
 #include <QString>
 #include <QMutex>
+#include <QList>
 #include <QSize>
 #include <QMap>
 #include <QSet>
@@ -16,6 +17,7 @@
 #include "util.h"
 
 class PreviewGenerator;
+class PlayerContext;
 class QByteArray;
 class MythSocket;
 class QObject;
@@ -23,6 +25,24 @@ class QEvent;
 
 typedef QMap<QString,QDateTime> FileTimeStampMap;
 
+/** \class PreviewGrabListener
+ *  \brief Chooses and receives the frames grabbed by
+ *         PreviewGenerator::GrabFrames().
+ */
+class MTV_PUBLIC PreviewGrabListener
+{
+  public:
+    virtual ~PreviewGrabListener() { }
+
+    /// Returns the frame numbers to grab, once the recording is open.
+    virtual QList<uint64_t> GetGrabFrames(float fps,
+                                          uint64_t total_frames) = 0;
+    /// Receives grab number index, returns false to stop grabbing.
+    virtual bool HandleGrab(uint index, uint64_t frame,
+                            const unsigned char *data,
+                            int width, int height, float aspect) = 0;
+};
+
 class MTV_PUBLIC PreviewGenerator : public QObject, public MThread
 {
     friend int preview_helper(uint           chanid,
@@ -32,6 +52,7 @@ class MTV_PUBLIC PreviewGenerator : public QObject, public MThread
                               const QSize   &previewSize,
                               const QString &infile,
                               const QString &outfile);
+    friend class PreviewBatchSaver;
 
     Q_OBJECT
 
@@ -43,7 +64,8 @@ class MTV_PUBLIC PreviewGenerator : public QObject, public MThread
         kRemote         = 0x2,
         kLocalAndRemote = 0x3,
         kForceLocal     = 0x5,
-        kModeMask       = 0x7,
+        kInProcess      = 0x8,
+        kModeMask       = 0xF,
     } Mode;
 
   public:
@@ -67,6 +89,15 @@ class MTV_PUBLIC PreviewGenerator : public QObject, public MThread
 
     void AttachSignals(QObject*);
 
+    static uint GeneratePreviewBatch(const ProgramInfo      &pginfo,
+                                     const QList<long long> &times,
+                                     bool                    time_in_secs,
+                                     const QList<QSize>     &sizes,
+                                     QStringList            &outputFiles);
+    static bool GrabFrames(const ProgramInfo   &pginfo,
+                           const QString       &filename,
+                           PreviewGrabListener &listener);
+
   public slots:
     void deleteLater();
 
@@ -80,6 +111,9 @@ class MTV_PUBLIC PreviewGenerator : public QObject, public MThread
 
     bool RunReal(void);
 
+    static PlayerContext *CreatePreviewContext(const ProgramInfo &pginfo,
+                                               const QString     &filename);
+
     static char *GetScreenGrab(const ProgramInfo &pginfo,
                                const QString     &filename,
                                long long          seektime,
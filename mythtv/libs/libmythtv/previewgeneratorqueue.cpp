@@ -38,8 +38,13 @@ PreviewGeneratorQueue::PreviewGeneratorQueue(
 {
     if (PreviewGenerator::kLocal & mode)
     {
+        // In process generators decode in our address space, so don't
+        // run more of them than we have cores.
         int idealThreads = QThread::idealThreadCount();
-        m_maxThreads = (idealThreads >= 1) ? idealThreads * 2 : 2;
+        if (PreviewGenerator::kInProcess & mode)
+            m_maxThreads = (idealThreads >= 1) ? idealThreads : 2;
+        else
+            m_maxThreads = (idealThreads >= 1) ? idealThreads * 2 : 2;
     }
 
     moveToThread(qthread());
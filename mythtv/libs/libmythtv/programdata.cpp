@@ -1,6 +1,7 @@
 // -*- Mode: c++ -*-
 
 #include <limits.h>
+#include <math.h>
 
 // C++ includes
 #include <algorithm>
@@ -16,6 +17,9 @@ using namespace std;
 
 #define LOC      QString("ProgramData: ")
 
+/// Most rows put in one multi-row INSERT or looked up in one IN (...) list.
+static const uint kMaxBulkRows = 50;
+
 static const char *roles[] =
 {
     "",
@@ -240,8 +244,136 @@ uint DBEvent::UpdateDB(
     }
 }
 
+/** \brief Finds the programs the event could replace, the ones that start
+ *         or end within it.
+ */
+static bool is_overlapping(const DBEvent &event, const DBEvent &prog)
+{
+    return ((prog.starttime >= event.starttime &&
+             prog.starttime <  event.endtime) ||
+            (prog.endtime   >  event.starttime &&
+             prog.endtime   <= event.endtime));
+}
+
+/** \brief Same as UpdateDB(MSqlQuery&, uint, int), but matches against
+ *         programs loaded with LoadOverlappingPrograms() rather than
+ *         querying them, and keeps those programs in step with the writes.
+ *
+ *  window must hold every stored program the event overlaps, so that a
+ *  batch of events can share one query.
+ */
+uint DBEvent::UpdateDBInWindow(MSqlQuery &query, uint chanid,
+                               int match_threshold,
+                               vector<DBEvent> &window) const
+{
+    vector<DBEvent> programs;
+    vector<uint>    index;
+    for (uint i = 0; i < window.size(); i++)
+    {
+        if (is_overlapping(*this, window[i]))
+        {
+            programs.push_back(window[i]);
+            index.push_back(i);
+        }
+    }
+
+    int match = -1;
+    if (!programs.empty())
+    {
+        int i     = -1;
+        int score = GetMatch(programs, i);
+
+        if (score >= match_threshold)
+        {
+            LOG(VB_EIT, LOG_DEBUG,
+                QString("EIT: accept match[%1]: %2 '%3' vs. '%4'")
+                    .arg(i).arg(score).arg(title).arg(programs[i].title));
+            match = i;
+        }
+        else if (i >= 0)
+        {
+            LOG(VB_EIT, LOG_DEBUG,
+                QString("EIT: reject match[%1]: %2 '%3' vs. '%4'")
+                    .arg(i).arg(score).arg(title).arg(programs[i].title));
+        }
+    }
+
+    // adjust/delete overlaps, in the database and in the window
+    bool ok = true;
+    vector<uint> removed;
+    for (uint i = 0; i < programs.size(); i++)
+    {
+        if ((int)i == match)
+            continue;
+
+        if (!MoveOutOfTheWayDB(query, chanid, programs[i]))
+        {
+            ok = false;
+            continue;
+        }
+
+        const DBEvent &prog = programs[i];
+        if (prog.starttime >= starttime && prog.endtime <= endtime)
+            removed.push_back(index[i]);
+        else if (prog.starttime < starttime && prog.endtime > starttime)
+            window[index[i]].endtime = starttime;
+        else if (prog.starttime < endtime && prog.endtime > endtime)
+            window[index[i]].starttime = endtime;
+    }
+
+    // if we failed to move programs out of the way, don't insert new ones..
+    uint count = 0;
+    if (ok && match >= 0)
+    {
+        count = UpdateDB(query, chanid, programs[match]);
+        if (count)
+            Merge(programs[match], window[index[match]]);
+    }
+    else if (ok)
+    {
+        count = InsertDB(query, chanid);
+        // InsertDB() replaces any program with the same start time
+        for (uint i = 0; count && i < window.size(); i++)
+        {
+            if (window[i].starttime == starttime &&
+                find(removed.begin(), removed.end(), i) == removed.end())
+            {
+                removed.push_back(i);
+            }
+        }
+    }
+
+    sort(removed.begin(), removed.end());
+    for (int i = removed.size() - 1; i >= 0; i--)
+        window.erase(window.begin() + removed[i]);
+
+    if (count && match < 0)
+    {
+        // a copy of this event, without the credits
+        window.push_back(DBEvent(listingsource));
+        Merge(*this, window.back());
+    }
+
+    return count;
+}
+
 uint DBEvent::GetOverlappingPrograms(
     MSqlQuery &query, uint chanid, vector<DBEvent> &programs) const
+{
+    return LoadOverlappingPrograms(query, chanid, starttime, endtime,
+                                   programs);
+}
+
+/** \brief Appends the programs of chanid that start or end within
+ *         [from, to) to programs.
+ *
+ *  These are all the programs GetOverlappingPrograms() could return for
+ *  any event inside [from, to), so one call can serve a batch of events.
+ *  \return number of programs appended
+ */
+uint DBEvent::LoadOverlappingPrograms(
+    MSqlQuery &query, uint chanid, const QDateTime &from, const QDateTime &to,
+    vector<DBEvent> &programs)
 {
     uint count = 0;
     query.prepare(
@@ -261,10 +393,10 @@ uint DBEvent::GetOverlappingPrograms(
         "      ( ( starttime >= :STIME1 AND starttime <  :ETIME1 ) OR "
         "        ( endtime   >  :STIME2 AND endtime   <= :ETIME2 ) )");
     query.bindValue(":CHANID", chanid);
-    query.bindValue(":STIME1", starttime);
-    query.bindValue(":ETIME1", endtime);
-    query.bindValue(":STIME2", starttime);
-    query.bindValue(":ETIME2", endtime);
+    query.bindValue(":STIME1", from);
+    query.bindValue(":ETIME1", to);
+    query.bindValue(":STIME2", from);
+    query.bindValue(":ETIME2", to);
 
     if (!query.exec())
     {
@@ -465,65 +597,80 @@ uint DBEvent::UpdateDB(
     return UpdateDB(q, chanid, p[match]);
 }
 
-uint DBEvent::UpdateDB(
-    MSqlQuery &query, uint chanid, const DBEvent &match) const
+/** \brief Fills merged with this event, completed with the details only
+ *         the matched program has. The credits are not copied.
+ */
+void DBEvent::Merge(const DBEvent &match, DBEvent &merged) const
 {
-    QString  ltitle     = title;
-    QString  lsubtitle  = subtitle;
-    QString  ldesc      = description;
-    QString  lcategory  = category;
-    uint16_t lairdate   = airdate;
-    QString  lprogramId = programId;
-    QString  lseriesId  = seriesId;
-    QDate loriginalairdate = originalairdate;
+    merged.title           = title;
+    merged.subtitle        = subtitle;
+    merged.description     = description;
+    merged.category        = category;
+    merged.starttime       = starttime;
+    merged.endtime         = endtime;
+    merged.airdate         = airdate;
+    merged.originalairdate = originalairdate;
+    merged.programId       = programId;
+    merged.seriesId        = seriesId;
+    merged.stars           = stars;
 
-    if (match.title.length() >= ltitle.length())
-        ltitle = match.title;
+    if (match.title.length() >= merged.title.length())
+        merged.title = match.title;
 
-    if (match.subtitle.length() >= lsubtitle.length())
-        lsubtitle = match.subtitle;
+    if (match.subtitle.length() >= merged.subtitle.length())
+        merged.subtitle = match.subtitle;
 
-    if (match.description.length() >= ldesc.length())
-        ldesc = match.description;
+    if (match.description.length() >= merged.description.length())
+        merged.description = match.description;
 
-    if (lcategory.isEmpty() && !match.category.isEmpty())
-        lcategory = match.category;
+    if (merged.category.isEmpty() && !match.category.isEmpty())
+        merged.category = match.category;
 
-    if (!lairdate && !match.airdate)
-        lairdate = match.airdate;
+    if (!merged.airdate && !match.airdate)
+        merged.airdate = match.airdate;
 
-    if (!loriginalairdate.isValid() && match.originalairdate.isValid())
-        loriginalairdate = match.originalairdate;
+    if (!merged.originalairdate.isValid() && match.originalairdate.isValid())
+        merged.originalairdate = match.originalairdate;
 
-    if (lprogramId.isEmpty() && !match.programId.isEmpty())
-        lprogramId = match.programId;
+    if (merged.programId.isEmpty() && !match.programId.isEmpty())
+        merged.programId = match.programId;
 
-    if (lseriesId.isEmpty() && !match.seriesId.isEmpty())
-        lseriesId = match.seriesId;
+    if (merged.seriesId.isEmpty() && !match.seriesId.isEmpty())
+        merged.seriesId = match.seriesId;
 
-    uint tmp = categoryType;
+    merged.categoryType = categoryType;
     if (!categoryType && match.categoryType)
-        tmp = match.categoryType;
+        merged.categoryType = match.categoryType;
 
-    QString lcattype = myth_category_type_to_string(tmp);
+    merged.subtitleType = subtitleType | match.subtitleType;
+    merged.audioProps   = audioProps   | match.audioProps;
+    merged.videoProps   = videoProps   | match.videoProps;
 
-    unsigned char lsubtype = subtitleType | match.subtitleType;
-    unsigned char laudio   = audioProps   | match.audioProps;
-    unsigned char lvideo   = videoProps   | match.videoProps;
-
-    uint lpartnumber =
+    merged.partnumber =
         (!partnumber && match.partnumber) ? match.partnumber : partnumber;
-    uint lparttotal =
+    merged.parttotal =
         (!parttotal  && match.parttotal ) ? match.parttotal  : parttotal;
 
-    bool lpreviouslyshown = previouslyshown | match.previouslyshown;
+    merged.previouslyshown = previouslyshown | match.previouslyshown;
 
-    uint32_t llistingsource = listingsource | match.listingsource;
+    merged.listingsource = listingsource | match.listingsource;
 
-    QString lsyndicatedepisodenumber = syndicatedepisodenumber;
-    if (lsyndicatedepisodenumber.isEmpty() &&
+    merged.syndicatedepisodenumber = syndicatedepisodenumber;
+    if (merged.syndicatedepisodenumber.isEmpty() &&
         !match.syndicatedepisodenumber.isEmpty())
-        lsyndicatedepisodenumber = match.syndicatedepisodenumber;
+        merged.syndicatedepisodenumber = match.syndicatedepisodenumber;
+}
+
+uint DBEvent::UpdateDB(
+    MSqlQuery &query, uint chanid, const DBEvent &match) const
+{
+    DBEvent merged(listingsource);
+    Merge(match, merged);
+
+    QString  lcattype = myth_category_type_to_string(merged.categoryType);
+    unsigned char lsubtype = merged.subtitleType;
+    unsigned char laudio   = merged.audioProps;
+    unsigned char lvideo   = merged.videoProps;
 
     query.prepare(
         "UPDATE program "
@@ -546,10 +693,10 @@ uint DBEvent::UpdateDB(
 
     query.bindValue(":CHANID",      chanid);
     query.bindValue(":OLDSTART",    match.starttime);
-    query.bindValue(":TITLE",       denullify(ltitle));
-    query.bindValue(":SUBTITLE",    denullify(lsubtitle));
-    query.bindValue(":DESC",        denullify(ldesc));
-    query.bindValue(":CATEGORY",    denullify(lcategory));
+    query.bindValue(":TITLE",       denullify(merged.title));
+    query.bindValue(":SUBTITLE",    denullify(merged.subtitle));
+    query.bindValue(":DESC",        denullify(merged.description));
+    query.bindValue(":CATEGORY",    denullify(merged.category));
     query.bindValue(":CATTYPE",     lcattype);
     query.bindValue(":STARTTIME",   starttime);
     query.bindValue(":ENDTIME",     endtime);
@@ -560,15 +707,16 @@ uint DBEvent::UpdateDB(
     query.bindValue(":SUBTYPE",     lsubtype);
     query.bindValue(":AUDIOPROP",   laudio);
     query.bindValue(":VIDEOPROP",   lvideo);
-    query.bindValue(":PARTNO",      lpartnumber);
-    query.bindValue(":PARTTOTAL",   lparttotal);
-    query.bindValue(":SYNDICATENO", denullify(lsyndicatedepisodenumber));
-    query.bindValue(":AIRDATE",     lairdate?QString::number(lairdate):"0000");
-    query.bindValue(":ORIGAIRDATE", loriginalairdate);
-    query.bindValue(":LSOURCE",     llistingsource);
-    query.bindValue(":SERIESID",    denullify(lseriesId));
-    query.bindValue(":PROGRAMID",   denullify(lprogramId));
-    query.bindValue(":PREVSHOWN",   lpreviouslyshown);
+    query.bindValue(":PARTNO",      merged.partnumber);
+    query.bindValue(":PARTTOTAL",   merged.parttotal);
+    query.bindValue(":SYNDICATENO", denullify(merged.syndicatedepisodenumber));
+    query.bindValue(":AIRDATE",     merged.airdate ?
+                    QString::number(merged.airdate) : "0000");
+    query.bindValue(":ORIGAIRDATE", merged.originalairdate);
+    query.bindValue(":LSOURCE",     merged.listingsource);
+    query.bindValue(":SERIESID",    denullify(merged.seriesId));
+    query.bindValue(":PROGRAMID",   denullify(merged.programId));
+    query.bindValue(":PREVSHOWN",   merged.previouslyshown);
 
     if (!query.exec())
     {
@@ -799,6 +947,72 @@ void ProgInfo::Squeeze(void)
     clumpmax.squeeze();
 }
 
+static const char *kProgInfoColumns =
+    "  chanid,         title,          subtitle,        description, "
+    "  category,       category_type,  "
+    "  starttime,      endtime, "
+    "  closecaptioned, stereo,         hdtv,            subtitled, "
+    "  subtitletypes,  audioprop,      videoprop, "
+    "  partnumber,     parttotal, "
+    "  syndicatedepisodenumber, "
+    "  airdate,        originalairdate,listingsource, "
+    "  seriesid,       programid,      previouslyshown, "
+    "  stars,          showtype,       title_pronounce, colorcode ";
+
+static const char *kProgInfoValues =
+    " %1CHANID,       %1TITLE,        %1SUBTITLE,      %1DESCRIPTION, "
+    " %1CATEGORY,     %1CATTYPE,      "
+    " %1STARTTIME,    %1ENDTIME, "
+    " %1CC,           %1STEREO,       %1HDTV,          %1HASSUBTITLES, "
+    " %1SUBTYPES,     %1AUDIOPROP,    %1VIDEOPROP, "
+    " %1PARTNUMBER,   %1PARTTOTAL, "
+    " %1SYNDICATENO, "
+    " %1AIRDATE,      %1ORIGAIRDATE,  %1LSOURCE, "
+    " %1SERIESID,     %1PROGRAMID,    %1PREVSHOWN, "
+    " %1STARS,        %1SHOWTYPE,     %1TITLEPRON,     %1COLORCODE ";
+
+/// Binds the kProgInfoValues placeholders, each name starts with prefix.
+static void bind_proginfo(MSqlQuery &query, const QString &prefix,
+                          uint chanid, const ProgInfo &pi)
+{
+    QString cattype = myth_category_type_to_string(pi.categoryType);
+
+    query.bindValue(prefix + "CHANID",      chanid);
+    query.bindValue(prefix + "TITLE",       denullify(pi.title));
+    query.bindValue(prefix + "SUBTITLE",    denullify(pi.subtitle));
+    query.bindValue(prefix + "DESCRIPTION", denullify(pi.description));
+    query.bindValue(prefix + "CATEGORY",    denullify(pi.category));
+    query.bindValue(prefix + "CATTYPE",     cattype);
+    query.bindValue(prefix + "STARTTIME",   pi.starttime);
+    query.bindValue(prefix + "ENDTIME",     pi.endtime);
+    query.bindValue(prefix + "CC",
+                    pi.subtitleType & SUB_HARDHEAR ? true : false);
+    query.bindValue(prefix + "STEREO",
+                    pi.audioProps   & AUD_STEREO   ? true : false);
+    query.bindValue(prefix + "HDTV",
+                    pi.videoProps   & VID_HDTV     ? true : false);
+    query.bindValue(prefix + "HASSUBTITLES",
+                    pi.subtitleType & SUB_NORMAL   ? true : false);
+    query.bindValue(prefix + "SUBTYPES",    pi.subtitleType);
+    query.bindValue(prefix + "AUDIOPROP",   pi.audioProps);
+    query.bindValue(prefix + "VIDEOPROP",   pi.videoProps);
+    query.bindValue(prefix + "PARTNUMBER",  pi.partnumber);
+    query.bindValue(prefix + "PARTTOTAL",   pi.parttotal);
+    query.bindValue(prefix + "SYNDICATENO",
+                    denullify(pi.syndicatedepisodenumber));
+    query.bindValue(prefix + "AIRDATE",
+                    pi.airdate ? QString::number(pi.airdate) : "0000");
+    query.bindValue(prefix + "ORIGAIRDATE", pi.originalairdate);
+    query.bindValue(prefix + "LSOURCE",     pi.listingsource);
+    query.bindValue(prefix + "SERIESID",    denullify(pi.seriesId));
+    query.bindValue(prefix + "PROGRAMID",   denullify(pi.programId));
+    query.bindValue(prefix + "PREVSHOWN",   pi.previouslyshown);
+    query.bindValue(prefix + "STARS",       pi.stars);
+    query.bindValue(prefix + "SHOWTYPE",    pi.showtype);
+    query.bindValue(prefix + "TITLEPRON",   pi.title_pronounce);
+    query.bindValue(prefix + "COLORCODE",   pi.colorcode);
+}
+
 uint ProgInfo::InsertDB(MSqlQuery &query, uint chanid) const
 {
     LOG(VB_XMLTV, LOG_INFO,
@@ -808,65 +1022,10 @@ uint ProgInfo::InsertDB(MSqlQuery &query, uint chanid) const
             .arg(channel)
             .arg(title));
 
-    query.prepare(
-        "REPLACE INTO program ("
-        "  chanid,         title,          subtitle,        description, "
-        "  category,       category_type,  "
-        "  starttime,      endtime, "
-        "  closecaptioned, stereo,         hdtv,            subtitled, "
-        "  subtitletypes,  audioprop,      videoprop, "
-        "  partnumber,     parttotal, "
-        "  syndicatedepisodenumber, "
-        "  airdate,        originalairdate,listingsource, "
-        "  seriesid,       programid,      previouslyshown, "
-        "  stars,          showtype,       title_pronounce, colorcode ) "
-
-        "VALUES("
-        " :CHANID,        :TITLE,         :SUBTITLE,       :DESCRIPTION, "
-        " :CATEGORY,      :CATTYPE,       "
-        " :STARTTIME,     :ENDTIME, "
-        " :CC,            :STEREO,        :HDTV,           :HASSUBTITLES, "
-        " :SUBTYPES,      :AUDIOPROP,     :VIDEOPROP, "
-        " :PARTNUMBER,    :PARTTOTAL, "
-        " :SYNDICATENO, "
-        " :AIRDATE,       :ORIGAIRDATE,   :LSOURCE, "
-        " :SERIESID,      :PROGRAMID,     :PREVSHOWN, "
-        " :STARS,         :SHOWTYPE,      :TITLEPRON,      :COLORCODE)");
-
-    QString cattype = myth_category_type_to_string(categoryType);
-
-    query.bindValue(":CHANID",      chanid);
-    query.bindValue(":TITLE",       denullify(title));
-    query.bindValue(":SUBTITLE",    denullify(subtitle));
-    query.bindValue(":DESCRIPTION", denullify(description));
-    query.bindValue(":CATEGORY",    denullify(category));
-    query.bindValue(":CATTYPE",     cattype);
-    query.bindValue(":STARTTIME",   starttime);
-    query.bindValue(":ENDTIME",     endtime);
-    query.bindValue(":CC",
-                    subtitleType & SUB_HARDHEAR ? true : false);
-    query.bindValue(":STEREO",
-                    audioProps   & AUD_STEREO   ? true : false);
-    query.bindValue(":HDTV",
-                    videoProps   & VID_HDTV     ? true : false);
-    query.bindValue(":HASSUBTITLES",
-                    subtitleType & SUB_NORMAL   ? true : false);
-    query.bindValue(":SUBTYPES",    subtitleType);
-    query.bindValue(":AUDIOPROP",   audioProps);
-    query.bindValue(":VIDEOPROP",   videoProps);
-    query.bindValue(":PARTNUMBER",  partnumber);
-    query.bindValue(":PARTTOTAL",   parttotal);
-    query.bindValue(":SYNDICATENO", denullify(syndicatedepisodenumber));
-    query.bindValue(":AIRDATE",     airdate ? QString::number(airdate):"0000");
-    query.bindValue(":ORIGAIRDATE", originalairdate);
-    query.bindValue(":LSOURCE",     listingsource);
-    query.bindValue(":SERIESID",    denullify(seriesId));
-    query.bindValue(":PROGRAMID",   denullify(programId));
-    query.bindValue(":PREVSHOWN",   previouslyshown);
-    query.bindValue(":STARS",       stars);
-    query.bindValue(":SHOWTYPE",    showtype);
-    query.bindValue(":TITLEPRON",   title_pronounce);
-    query.bindValue(":COLORCODE",   colorcode);
+    query.prepare(QString("REPLACE INTO program (%1) VALUES (%2)")
+                  .arg(kProgInfoColumns)
+                  .arg(QString(kProgInfoValues).arg(":")));
+    bind_proginfo(query, ":", chanid, *this);
 
     if (!query.exec())
     {
@@ -1048,17 +1207,41 @@ void ProgramData::FixProgramList(QList<ProgInfo*> &fixlist)
     }
 }
 
+void ProgramUpdateStats::AddChange(
+    const QDateTime &start, const QDateTime &end)
+{
+    if (!changedFrom.isValid() || start < changedFrom)
+        changedFrom = start;
+    if (!changedTo.isValid() || end > changedTo)
+        changedTo = end;
+}
+
 void ProgramData::HandlePrograms(
     uint sourceid, QMap<QString, QList<ProgInfo> > &proglist)
 {
-    uint unchanged = 0, updated = 0;
+    ProgramUpdateStats stats;
+
+    HandlePrograms(sourceid, proglist, stats);
 
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Updated programs: %1 Unchanged programs: %2 "
+                "Removed programs: %3")
+                .arg(stats.updated).arg(stats.unchanged).arg(stats.removed));
+}
+
+/** \brief Like HandlePrograms(uint, QMap&) but adds to stats instead of
+ *         logging the counts, for callers that hand over one batch at a time.
+ */
+void ProgramData::HandlePrograms(
+    uint sourceid, QMap<QString, QList<ProgInfo> > &proglist,
+    ProgramUpdateStats &stats)
+{
     MSqlQuery query(MSqlQuery::InitCon());
 
     QMap<QString, QList<ProgInfo> >::const_iterator mapiter;
     for (mapiter = proglist.begin(); mapiter != proglist.end(); ++mapiter)
     {
-        if (mapiter.key().isEmpty())
+        if (mapiter.key().isEmpty() || mapiter->empty())
             continue;
 
         query.prepare(
@@ -1097,35 +1280,389 @@ void ProgramData::HandlePrograms(
 
         for (uint i = 0; i < chanids.size(); ++i)
         {
-            HandlePrograms(query, chanids[i], sortlist, unchanged, updated);
+            HandlePrograms(query, chanids[i], sortlist, stats);
         }
     }
-
-    LOG(VB_GENERAL, LOG_INFO,
-        QString("Updated programs: %1 Unchanged programs: %2")
-                .arg(updated) .arg(unchanged));
 }
 
+/** \brief Brings the programs of one channel in line with sortlist.
+ *
+ *  The programs already stored for the time the list covers are read in
+ *  one query and compared in memory. Unchanged programs are left alone.
+ *  The time taken by the changed ones is cleared with one set of deletes
+ *  per contiguous run, and the changed programs are then inserted in bulk.
+ *  If the existing programs can't be read, each program is checked and
+ *  replaced on its own instead.
+ */
 void ProgramData::HandlePrograms(MSqlQuery             &query,
                                  uint                   chanid,
                                  const QList<ProgInfo*> &sortlist,
-                                 uint &unchanged,
-                                 uint &updated)
+                                 ProgramUpdateStats    &stats)
 {
+    if (sortlist.empty())
+        return;
+
+    QDateTime last = sortlist.last()->starttime;
     QList<ProgInfo*>::const_iterator it = sortlist.begin();
     for (; it != sortlist.end(); ++it)
+        last = max(last, (*it)->endtime);
+
+    QMultiMap<QDateTime, ProgInfo> existing;
+    bool loaded = LoadPrograms(query, chanid, sortlist.first()->starttime,
+                               last, existing);
+
+    QList<ProgInfo*> toinsert;
+    QList<QPair<QDateTime, QDateTime> > toclear;
+
+    for (it = sortlist.begin(); it != sortlist.end(); ++it)
     {
-        if (IsUnchanged(query, chanid, **it))
+        const ProgInfo &pi = **it;
+
+        bool same = (loaded) ?
+            IsUnchanged(existing, pi) : IsUnchanged(query, chanid, pi);
+        if (same)
         {
-            unchanged++;
+            stats.unchanged++;
             continue;
         }
 
-        if (!DeleteOverlaps(query, chanid, **it))
+        if (!loaded)
+        {
+            if (!DeleteOverlaps(query, chanid, pi))
+                continue;
+        }
+        else if (!toclear.empty() && toclear.last().second == pi.starttime)
+        {
+            toclear.last().second = max(pi.starttime, pi.endtime);
+        }
+        else
+        {
+            toclear.push_back(
+                qMakePair(pi.starttime, max(pi.starttime, pi.endtime)));
+        }
+
+        // The list has no overlaps left, so clearing the time of a later
+        // program can't remove one that is waiting to be inserted.
+        toinsert.push_back(*it);
+        stats.AddChange(pi.starttime, pi.endtime);
+    }
+
+    for (int i = 0; i < toclear.size(); ++i)
+    {
+        stats.removed += ClearPrograms(
+            query, chanid, toclear[i].first, toclear[i].second, existing);
+    }
+
+    stats.updated += InsertPrograms(query, chanid, toinsert);
+}
+
+/** \brief Reads the programs of chanid that start from "from" up to and
+ *         including "to", keyed by start time.
+ *
+ *  Only the columns IsUnchanged() compares are filled in.
+ */
+bool ProgramData::LoadPrograms(
+    MSqlQuery &query, uint chanid, const QDateTime &from, const QDateTime &to,
+    QMultiMap<QDateTime, ProgInfo> &existing)
+{
+    query.prepare(
+        "SELECT starttime,       endtime,         title, "
+        "       subtitle,        description,     category, "
+        "       category_type,   airdate,         stars, "
+        "       previouslyshown, title_pronounce, audioprop+0, "
+        "       videoprop+0,     subtitletypes+0, partnumber, "
+        "       parttotal,       seriesid,        showtype, "
+        "       colorcode,       syndicatedepisodenumber, "
+        "       programid "
+        "FROM program "
+        "WHERE chanid     = :CHANID AND "
+        "      starttime >= :FROM   AND "
+        "      starttime <= :TO");
+    query.bindValue(":CHANID", chanid);
+    query.bindValue(":FROM",   from);
+    query.bindValue(":TO",     to);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("ProgramData::LoadPrograms", query);
+        return false;
+    }
+
+    while (query.next())
+    {
+        ProgInfo pi;
+        pi.starttime       = query.value(0).toDateTime();
+        pi.endtime         = query.value(1).toDateTime();
+        pi.title           = query.value(2).toString();
+        pi.subtitle        = query.value(3).toString();
+        pi.description     = query.value(4).toString();
+        pi.category        = query.value(5).toString();
+        pi.categoryType    =
+            string_to_myth_category_type(query.value(6).toString());
+        pi.airdate         = query.value(7).toUInt();
+        pi.stars           = query.value(8).toString();
+        pi.previouslyshown = query.value(9).toBool();
+        pi.title_pronounce = query.value(10).toString();
+        pi.audioProps      = query.value(11).toUInt();
+        pi.videoProps      = query.value(12).toUInt();
+        pi.subtitleType    = query.value(13).toUInt();
+        pi.partnumber      = query.value(14).toUInt();
+        pi.parttotal       = query.value(15).toUInt();
+        pi.seriesId        = query.value(16).toString();
+        pi.showtype        = query.value(17).toString();
+        pi.colorcode       = query.value(18).toString();
+        pi.syndicatedepisodenumber = query.value(19).toString();
+        pi.programId       = query.value(20).toString();
+
+        existing.insert(pi.starttime, pi);
+    }
+
+    return true;
+}
+
+/** \brief Deletes the programs of chanid starting in [from, to), along with
+ *         their ratings, credits and genres.
+ *  \return number of existing programs removed
+ */
+uint ProgramData::ClearPrograms(
+    MSqlQuery &query, uint chanid, const QDateTime &from, const QDateTime &to,
+    const QMultiMap<QDateTime, ProgInfo> &existing)
+{
+    uint count = 0;
+
+    QMultiMap<QDateTime, ProgInfo>::const_iterator it =
+        existing.lowerBound(from);
+    for (; it != existing.end() && it.key() < to; ++it)
+    {
+        LOG(VB_XMLTV, LOG_INFO,
+            QString("Removing existing program: %1 - %2 %3")
+                .arg((*it).starttime.toString(Qt::ISODate))
+                .arg((*it).endtime.toString(Qt::ISODate))
+                .arg((*it).title));
+        count++;
+    }
+
+    if (!count)
+        return 0;
+
+    if (!ClearDataByChannel(chanid, from, to, false))
+    {
+        LOG(VB_XMLTV, LOG_ERR,
+            QString("Program delete failed    : %1 - %2")
+                .arg(from.toString(Qt::ISODate))
+                .arg(to.toString(Qt::ISODate)));
+        return 0;
+    }
+
+    return count;
+}
+
+/** \brief Runs head followed by the collected value rows as one statement,
+ *         then empties rows and bindings for the next chunk.
+ */
+static bool exec_rows(MSqlQuery &query, const QString &head,
+                      QStringList &rows, MSqlBindings &bindings,
+                      const char *ctx)
+{
+    if (rows.empty())
+        return true;
+
+    query.prepare(head + rows.join(", "));
+    query.bindValues(bindings);
+    rows.clear();
+    bindings.clear();
+
+    if (query.exec())
+        return true;
+
+    MythDB::DBError(ctx, query);
+    return false;
+}
+
+/** \brief Inserts the programs, their ratings and their credits with
+ *         multi-row statements of up to kMaxBulkRows rows each.
+ *  \return number of programs inserted
+ */
+uint ProgramData::InsertPrograms(
+    MSqlQuery &query, uint chanid, const QList<ProgInfo*> &list)
+{
+    if (list.empty())
+        return 0;
+
+    const QString head = QString("REPLACE INTO program (%1) VALUES ")
+        .arg(kProgInfoColumns);
+    QStringList  rows;
+    MSqlBindings bindings;
+    uint inserted = 0;
+
+    for (int first = 0; first < list.size(); first += kMaxBulkRows)
+    {
+        int last = min(first + (int)kMaxBulkRows, list.size());
+
+        for (int i = first; i < last; ++i)
+        {
+            LOG(VB_XMLTV, LOG_INFO,
+                QString("Inserting new program    : %1 - %2 %3 %4")
+                    .arg(list[i]->starttime.toString(Qt::ISODate))
+                    .arg(list[i]->endtime.toString(Qt::ISODate))
+                    .arg(list[i]->channel)
+                    .arg(list[i]->title));
+
+            rows << QString("(%1)").arg(QString(kProgInfoValues)
+                                        .arg(QString(":P%1").arg(i - first)));
+        }
+
+        query.prepare(head + rows.join(", "));
+        for (int i = first; i < last; ++i)
+        {
+            bind_proginfo(query, QString(":P%1").arg(i - first),
+                          chanid, *list[i]);
+        }
+        rows.clear();
+
+        if (query.exec())
+            inserted += last - first;
+        else
+            MythDB::DBError("program bulk insert", query);
+    }
+
+    QList<ProgInfo*>::const_iterator it;
+    const QString rhead =
+        "INSERT INTO programrating (chanid, starttime, system, rating) "
+        "VALUES ";
+    for (it = list.begin(); it != list.end(); ++it)
+    {
+        QList<EventRating>::const_iterator j = (*it)->ratings.begin();
+        for (; j != (*it)->ratings.end(); ++j)
+        {
+            const QString prefix = QString(":R%1").arg(rows.size());
+            rows << QString("(%1CHANID, %1START, %1SYS, %1RATING)")
+                .arg(prefix);
+            bindings[prefix + "CHANID"] = chanid;
+            bindings[prefix + "START"]  = (*it)->starttime;
+            bindings[prefix + "SYS"]    = (*j).system;
+            bindings[prefix + "RATING"] = (*j).rating;
+            if (rows.size() >= (int)kMaxBulkRows)
+                exec_rows(query, rhead, rows, bindings,
+                          "programrating bulk insert");
+        }
+    }
+    exec_rows(query, rhead, rows, bindings, "programrating bulk insert");
+
+    InsertCredits(query, chanid, list);
+
+    return inserted;
+}
+
+/** \brief Looks up the person ids of all credited people in a few queries,
+ *         adding anybody who is missing, then inserts the credits.
+ */
+void ProgramData::InsertCredits(
+    MSqlQuery &query, uint chanid, const QList<ProgInfo*> &list)
+{
+    QMap<QString, uint> people;
+    QList<ProgInfo*>::const_iterator it = list.begin();
+    for (; it != list.end(); ++it)
+    {
+        if (!(*it)->credits)
             continue;
+        for (uint i = 0; i < (*it)->credits->size(); ++i)
+            people[(*(*it)->credits)[i].GetName()] = 0;
+    }
+
+    if (people.empty())
+        return;
 
-        updated += (*it)->InsertDB(query, chanid);
+    QStringList missing = GetPersonIDs(query, people.keys(), people);
+
+    QStringList  rows;
+    MSqlBindings bindings;
+    const QString phead = "INSERT IGNORE INTO people (name) VALUES ";
+    for (int i = 0; i < missing.size(); ++i)
+    {
+        const QString name = QString(":N%1NAME").arg(rows.size());
+        rows << QString("(%1)").arg(name);
+        bindings[name] = missing[i];
+        if (rows.size() >= (int)kMaxBulkRows)
+            exec_rows(query, phead, rows, bindings, "people bulk insert");
     }
+    exec_rows(query, phead, rows, bindings, "people bulk insert");
+
+    if (!missing.empty())
+        GetPersonIDs(query, missing, people);
+
+    const QString chead =
+        "REPLACE INTO credits (person, chanid, starttime, role) VALUES ";
+    for (it = list.begin(); it != list.end(); ++it)
+    {
+        if (!(*it)->credits)
+            continue;
+
+        const DBCredits &credits = *(*it)->credits;
+        for (uint i = 0; i < credits.size(); ++i)
+        {
+            uint personid = people.value(credits[i].GetName());
+            if (!personid)
+            {
+                // Name differs from how MySQL returned it (e.g. trailing
+                // spaces in the CHAR column), use the one at a time path.
+                credits[i].InsertDB(query, chanid, (*it)->starttime);
+                continue;
+            }
+
+            const QString prefix = QString(":C%1").arg(rows.size());
+            rows << QString("(%1PERSON, %1CHANID, %1START, %1ROLE)")
+                .arg(prefix);
+            bindings[prefix + "PERSON"] = personid;
+            bindings[prefix + "CHANID"] = chanid;
+            bindings[prefix + "START"]  = (*it)->starttime;
+            bindings[prefix + "ROLE"]   = credits[i].GetRole();
+            if (rows.size() >= (int)kMaxBulkRows)
+                exec_rows(query, chead, rows, bindings, "credits bulk insert");
+        }
+    }
+    exec_rows(query, chead, rows, bindings, "credits bulk insert");
+}
+
+/** \brief Fills in the person id of each of the names found in the people
+ *         table.
+ *  \return the names that are not in the people table yet
+ */
+QStringList ProgramData::GetPersonIDs(
+    MSqlQuery &query, const QStringList &names, QMap<QString, uint> &people)
+{
+    QStringList missing;
+
+    for (int first = 0; first < names.size(); first += kMaxBulkRows)
+    {
+        int last = min(first + (int)kMaxBulkRows, names.size());
+
+        QStringList placeholders;
+        for (int i = first; i < last; ++i)
+            placeholders << QString(":N%1NAME").arg(i - first);
+
+        query.prepare("SELECT person, name FROM people WHERE name IN (" +
+                      placeholders.join(", ") + ")");
+        for (int i = first; i < last; ++i)
+            query.bindValue(placeholders[i - first], names[i]);
+
+        if (!query.exec())
+        {
+            MythDB::DBError("get_people", query);
+            continue;
+        }
+
+        while (query.next())
+            people[query.value(1).toString()] = query.value(0).toUInt();
+
+        for (int i = first; i < last; ++i)
+        {
+            if (!people.value(names[i]))
+                missing.push_back(names[i]);
+        }
+    }
+
+    return missing;
 }
 
 int ProgramData::fix_end_times(void)
@@ -1190,6 +1727,45 @@ int ProgramData::fix_end_times(void)
     return count;
 }
 
+/** \brief Returns true if one of the existing programs starting at the
+ *         same time matches pi in all the columns the query version checks.
+ */
+bool ProgramData::IsUnchanged(
+    const QMultiMap<QDateTime, ProgInfo> &existing, const ProgInfo &pi)
+{
+    QMultiMap<QDateTime, ProgInfo>::const_iterator it =
+        existing.find(pi.starttime);
+    for (; it != existing.end() && it.key() == pi.starttime; ++it)
+    {
+        const ProgInfo &db = *it;
+        if (db.endtime         == pi.endtime         &&
+            db.title           == pi.title           &&
+            db.subtitle        == pi.subtitle        &&
+            db.description     == pi.description     &&
+            db.category        == pi.category        &&
+            db.categoryType    == pi.categoryType    &&
+            db.airdate         == pi.airdate         &&
+            fabs(db.stars.toFloat() - pi.stars.toFloat()) <= 0.001f &&
+            db.previouslyshown == pi.previouslyshown &&
+            db.title_pronounce == pi.title_pronounce &&
+            db.audioProps      == pi.audioProps      &&
+            db.videoProps      == pi.videoProps      &&
+            db.subtitleType    == pi.subtitleType    &&
+            db.partnumber      == pi.partnumber      &&
+            db.parttotal       == pi.parttotal       &&
+            db.seriesId        == pi.seriesId        &&
+            db.showtype        == pi.showtype        &&
+            db.colorcode       == pi.colorcode       &&
+            db.syndicatedepisodenumber == pi.syndicatedepisodenumber &&
+            db.programId       == pi.programId)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool ProgramData::IsUnchanged(
     MSqlQuery &query, uint chanid, const ProgInfo &pi)
 {
@@ -9,6 +9,7 @@ using namespace std;
 #include <stdint.h>
 
 // Qt headers
+#include <QStringList>
 #include <QString>
 #include <QDateTime>
 #include <QList>
@@ -44,6 +45,7 @@ class MTV_PUBLIC DBPerson
     DBPerson(const QString &_role, const QString &_name);
 
     QString GetRole(void) const;
+    QString GetName(void) const { return name; }
 
     uint InsertDB(MSqlQuery &query, uint chanid,
                   const QDateTime &starttime) const;
@@ -126,6 +128,13 @@ class MTV_PUBLIC DBEvent
     void AddPerson(const QString &role, const QString &name);
 
     uint UpdateDB(MSqlQuery &query, uint chanid, int match_threshold) const;
+    uint UpdateDBInWindow(MSqlQuery &query, uint chanid, int match_threshold,
+                          vector<DBEvent> &window) const;
+
+    static uint LoadOverlappingPrograms(
+        MSqlQuery &query, uint chanid,
+        const QDateTime &from, const QDateTime &to,
+        vector<DBEvent> &programs);
 
     bool HasCredits(void) const { return credits; }
     bool HasTimeConflict(const DBEvent &other) const;
@@ -145,6 +154,7 @@ class MTV_PUBLIC DBEvent
         MSqlQuery&, uint chanid, const DBEvent &nonmatch) const;
     virtual uint InsertDB(MSqlQuery&, uint chanid) const;
     virtual void Squeeze(void);
+    void Merge(const DBEvent &match, DBEvent &merged) const;
 
   public:
     QString       title;
@@ -211,6 +221,13 @@ class MTV_PUBLIC DBEventEIT : public DBEvent
         return DBEvent::UpdateDB(query, chanid, match_threshold);
     }
 
+    uint UpdateDB(MSqlQuery &query, int match_threshold,
+                  vector<DBEvent> &window) const
+    {
+        return DBEvent::UpdateDBInWindow(query, chanid, match_threshold,
+                                         window);
+    }
+
   public:
     uint32_t      chanid;
     uint32_t      fixup;
@@ -253,11 +270,29 @@ class MTV_PUBLIC ProgInfo : public DBEvent
     QString       clumpmax;
 };
 
+/// Counts kept by ProgramData::HandlePrograms() across batches.
+class MTV_PUBLIC ProgramUpdateStats
+{
+  public:
+    ProgramUpdateStats() : unchanged(0), updated(0), removed(0) { }
+
+    void AddChange(const QDateTime &start, const QDateTime &end);
+
+    uint      unchanged;    ///< programs already stored as they are
+    uint      updated;      ///< programs inserted or replaced
+    uint      removed;      ///< stored programs deleted to make room
+    QDateTime changedFrom;  ///< start of the earliest changed program
+    QDateTime changedTo;    ///< end of the latest changed program
+};
+
 class MTV_PUBLIC ProgramData
 {
   public:
     static void HandlePrograms(uint sourceid,
                                QMap<QString, QList<ProgInfo> > &proglist);
+    static void HandlePrograms(uint sourceid,
+                               QMap<QString, QList<ProgInfo> > &proglist,
+                               ProgramUpdateStats &stats);
 
     static int  fix_end_times(void);
     static bool ClearDataByChannel(
@@ -276,7 +311,24 @@ class MTV_PUBLIC ProgramData
     static void HandlePrograms(
         MSqlQuery &query, uint chanid,
         const QList<ProgInfo*> &sortlist,
-        uint &unchanged, uint &updated);
+        ProgramUpdateStats &stats);
+    static bool LoadPrograms(
+        MSqlQuery &query, uint chanid,
+        const QDateTime &from, const QDateTime &to,
+        QMultiMap<QDateTime, ProgInfo> &existing);
+    static uint ClearPrograms(
+        MSqlQuery &query, uint chanid,
+        const QDateTime &from, const QDateTime &to,
+        const QMultiMap<QDateTime, ProgInfo> &existing);
+    static uint InsertPrograms(
+        MSqlQuery &query, uint chanid, const QList<ProgInfo*> &list);
+    static void InsertCredits(
+        MSqlQuery &query, uint chanid, const QList<ProgInfo*> &list);
+    static QStringList GetPersonIDs(
+        MSqlQuery &query, const QStringList &names,
+        QMap<QString, uint> &people);
+    static bool IsUnchanged(
+        const QMultiMap<QDateTime, ProgInfo> &existing, const ProgInfo &pi);
     static bool IsUnchanged(
         MSqlQuery &query, uint chanid, const ProgInfo &pi);
     static bool DeleteOverlaps(
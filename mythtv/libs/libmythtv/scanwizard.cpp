@@ -180,6 +180,7 @@ void ScanWizard::SetPage(const QString &pageTitle)
             configPane->GetInputName(),           configPane->GetSourceID(),
             configPane->DoIgnoreSignalTimeout(),  configPane->DoFollowNIT(),
             configPane->DoTestDecryption(),       configPane->DoFreeToAirOnly(),
+            configPane->DoUseAllInputs(),
             configPane->GetServiceRequirements(),
             // stuff needed for particular scans
             configPane->GetMultiplex(),         start_chan,
@@ -0,0 +1,228 @@
+// Qt headers
+#include <QTemporaryFile>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QBuffer>
+#include <QImage>
+#include <QFile>
+#include <QTime>
+
+// MythTV headers
+#include "trickplaygenerator.h"
+#include "previewgenerator.h"
+#include "jobqueue.h"
+#include "mythcorecontext.h"
+#include "mythlogging.h"
+#include "util.h"
+
+#define LOC QString("Trickplay: ")
+
+/// JPEG quality of the index images, they are small so keep them cheap.
+static const int kTrickplayQuality = 70;
+
+TrickplayGenerator::TrickplayGenerator(const ProgramInfo &pginfo, int jobID) :
+    m_programInfo(pginfo), m_pathname(pginfo.GetPathname()),
+    m_jobID(jobID),
+    m_interval(gCoreContext->GetNumSetting("TrickplayInterval", 10)),
+    m_tileSize(gCoreContext->GetNumSetting("TrickplayWidth", 160), 0),
+    m_stopped(false)
+{
+    if (!m_interval)
+        m_interval = 1;
+}
+
+/** \fn TrickplayGenerator::Run(void)
+ *  \brief Grabs the images and writes the index file next to the recording.
+ *  \return true if the index file was written.
+ */
+bool TrickplayGenerator::Run(void)
+{
+    QTime tm = QTime::currentTime();
+
+    m_entries.clear();
+
+    if (!GrabImages())
+        return false;
+
+    if (m_entries.empty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("No images could be grabbed from '%1'").arg(m_pathname));
+        return false;
+    }
+
+    QString filename = GetFilename(m_pathname);
+    if (!SaveIndex(filename))
+        return false;
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("Saved %1 images every %2 seconds to '%3' in %4 seconds")
+            .arg(m_entries.size()).arg(m_interval).arg(filename)
+            .arg(tm.elapsed()*0.001));
+
+    return true;
+}
+
+bool TrickplayGenerator::GrabImages(void)
+{
+    m_stopped = false;
+    if (!PreviewGenerator::GrabFrames(m_programInfo, m_pathname, *this))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Could not open '%1'")
+                .arg(m_pathname));
+        return false;
+    }
+    return !m_stopped;
+}
+
+/// Picks a frame every m_interval seconds of the recording.
+QList<uint64_t> TrickplayGenerator::GetGrabFrames(
+    float fps, uint64_t total_frames)
+{
+    uint duration = 0;
+    if ((fps > 0.0f) && total_frames)
+        duration = (uint)(total_frames / fps);
+    if (!duration)
+    {
+        duration = m_programInfo.GetRecordingStartTime()
+            .secsTo(m_programInfo.GetRecordingEndTime());
+    }
+
+    QList<uint64_t> frames;
+    m_seconds.clear();
+    for (uint secs = 0; secs < duration; secs += m_interval)
+    {
+        frames.push_back((uint64_t)(secs * fps));
+        m_seconds.push_back(secs);
+    }
+    return frames;
+}
+
+bool TrickplayGenerator::HandleGrab(
+    uint index, uint64_t frame, const unsigned char *data,
+    int width, int height, float aspect)
+{
+    if (CheckJobStop(index, m_seconds.size()))
+    {
+        m_stopped = true;
+        return false;
+    }
+
+    uint secs = m_seconds[index];
+
+    // Drop the bogus rows of 1080 line video decoded as 1088.
+    if (height == 1088)
+        height = 1080;
+
+    aspect = (aspect <= 0.0f) ? ((float) width) / height : aspect;
+
+    if (m_tileSize.width() <= 0)
+        m_tileSize.setWidth(160);
+    if (m_tileSize.height() <= 0)
+        m_tileSize.setHeight(max(1, (int)(m_tileSize.width() / aspect)));
+
+    const QImage img(data, width, height, QImage::Format_RGB32);
+    QImage tile = img.scaled(m_tileSize.width(), m_tileSize.height(),
+                             Qt::IgnoreAspectRatio,
+                             Qt::SmoothTransformation);
+
+    TrickplayEntry entry;
+    entry.frame   = frame;
+    entry.seconds = secs;
+    entry.offset  = 0;
+
+    QBuffer buffer(&entry.image);
+    buffer.open(QIODevice::WriteOnly);
+    if (!tile.save(&buffer, "JPEG", kTrickplayQuality))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC +
+            QString("Could not encode image at %1 seconds").arg(secs));
+        return true;
+    }
+    buffer.close();
+
+    entry.length = entry.image.size();
+    m_entries.push_back(entry);
+
+    return true;
+}
+
+bool TrickplayGenerator::SaveIndex(const QString &filename)
+{
+    // header, then one table row per image
+    quint32 offset = (6 * sizeof(quint32)) +
+        m_entries.size() * (sizeof(quint64) + 3 * sizeof(quint32));
+
+    QList<TrickplayEntry>::iterator it = m_entries.begin();
+    for (; it != m_entries.end(); ++it)
+    {
+        (*it).offset = offset;
+        offset += (*it).length;
+    }
+
+    QTemporaryFile f(QFileInfo(filename).absoluteFilePath()+".XXXXXX");
+    f.setAutoRemove(false);
+    if (!f.open())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Could not create '%1'").arg(filename));
+        return false;
+    }
+
+    QDataStream out(&f);
+    out << (quint32) TRICKPLAY_MAGIC << (quint32) TRICKPLAY_VERSION
+        << (quint32) m_interval
+        << (quint32) m_tileSize.width() << (quint32) m_tileSize.height()
+        << (quint32) m_entries.size();
+
+    for (it = m_entries.begin(); it != m_entries.end(); ++it)
+        out << (*it).frame << (*it).seconds << (*it).offset << (*it).length;
+
+    for (it = m_entries.begin(); it != m_entries.end(); ++it)
+        out.writeRawData((*it).image.constData(), (*it).image.size());
+
+    f.flush();
+    if (f.error() != QFile::NoError)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Error writing '%1': %2")
+                .arg(f.fileName()).arg(f.errorString()));
+        f.remove();
+        return false;
+    }
+    f.close();
+
+    // Let anybody update it
+    makeFileAccessible(f.fileName().toLocal8Bit().constData());
+    QFile::remove(filename);
+    if (!f.rename(filename))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Could not rename '%1' to '%2'")
+                .arg(f.fileName()).arg(filename));
+        f.remove();
+        return false;
+    }
+
+    return true;
+}
+
+/// Reports progress and returns true if the job was asked to stop.
+bool TrickplayGenerator::CheckJobStop(uint done, uint total)
+{
+    if ((m_jobID < 0) || (done % 20))
+        return false;
+
+    if (JobQueue::GetJobCmd(m_jobID) == JOB_STOP)
+    {
+        LOG(VB_GENERAL, LOG_NOTICE, LOC + "Stopped by request");
+        return true;
+    }
+
+    JobQueue::ChangeJobComment(m_jobID, QObject::tr("%1% Completed")
+                               .arg(done * 100 / max(total, 1U)));
+
+    return false;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
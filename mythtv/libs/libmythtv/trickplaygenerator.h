@@ -0,0 +1,80 @@
+// -*- Mode: c++ -*-
+#ifndef _TRICKPLAY_GENERATOR_H_
+#define _TRICKPLAY_GENERATOR_H_
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QSize>
+
+#include "previewgenerator.h"
+#include "programinfo.h"
+#include "mythtvexp.h"
+
+/// Trickplay index files start with this, "MTRP" in ASCII.
+#define TRICKPLAY_MAGIC   0x4D545250
+#define TRICKPLAY_VERSION 1
+
+typedef struct trickplayentry
+{
+    quint64    frame;    ///< frame number the image was grabbed at
+    quint32    seconds;  ///< seconds into the recording
+    quint32    offset;   ///< byte offset of the JPEG from start of file
+    quint32    length;   ///< size of the JPEG in bytes
+    QByteArray image;    ///< JPEG data, only used while building the file
+} TrickplayEntry;
+
+/** \class TrickplayGenerator
+ *  \brief Builds a trickplay index of a recording.
+ *
+ *   A trickplay index is a small JPEG every few seconds of the recording,
+ *   all packed into one "<recording>.trickplay" file next to the
+ *   recording. Frontends can show scrub previews from it without
+ *   decoding the recording itself.
+ *
+ *   The file is written big-endian with QDataStream. It starts with a
+ *   header of quint32 magic, version, interval in seconds, tile width,
+ *   tile height and entry count. Then for each entry come a quint64
+ *   frame number and quint32 seconds, offset and length. The JPEG data
+ *   follows the table, and each offset is from the start of the file,
+ *   so a client can fetch one image with an HTTP or FileTransfer range
+ *   request once it has read the table.
+ */
+class MTV_PUBLIC TrickplayGenerator : public PreviewGrabListener
+{
+  public:
+    TrickplayGenerator(const ProgramInfo &pginfo, int jobID = -1);
+
+    void SetInterval(uint seconds)
+        { m_interval = (seconds) ? seconds : 1; }
+    void SetTileSize(const QSize &size) { m_tileSize = size; }
+
+    bool Run(void);
+
+    uint GetImageCount(void) const      { return m_entries.size(); }
+
+    static QString GetFilename(const QString &pathname)
+        { return pathname + ".trickplay"; }
+
+    // PreviewGrabListener
+    QList<uint64_t> GetGrabFrames(float fps, uint64_t total_frames);
+    bool HandleGrab(uint index, uint64_t frame, const unsigned char *data,
+                    int width, int height, float aspect);
+
+  private:
+    bool GrabImages(void);
+    bool SaveIndex(const QString &filename);
+    bool CheckJobStop(uint done, uint total);
+
+  private:
+    ProgramInfo           m_programInfo;
+    QString               m_pathname;
+    int                   m_jobID;
+    uint                  m_interval;
+    QSize                 m_tileSize;
+    QList<TrickplayEntry> m_entries;
+    QList<uint>           m_seconds;
+    bool                  m_stopped;
+};
+
+#endif // _TRICKPLAY_GENERATOR_H_
@@ -2737,8 +2737,15 @@ void TV::timerEvent(QTimerEvent *te)
         PlayerContext *mctx = GetPlayerReadLock(0, __FILE__, __LINE__);
         bool still_exists = find_player_index(ctx) >= 0;
 
-        if (still_exists)
-            ctx->UpdateTVChain();
+        if (still_exists && ctx->tvchain)
+        {
+            QStringList data;
+            {
+                QMutexLocker locker(&timerIdLock);
+                data = tvchainUpdate.take(ctx->tvchain->GetID());
+            }
+            ctx->UpdateTVChain(data);
+        }
 
         ReturnPlayerLock(mctx);
         handled = true;
@@ -6980,6 +6987,7 @@ void TV::ChangeChannel(PlayerContext *ctx, int direction)
     if (ctx->prevChan.empty())
         ctx->PushPreviousChannel();
 
+    ctx->StartChannelChange();
     PauseAudioUntilBuffered(ctx);
     PauseLiveTV(ctx);
 
@@ -6992,6 +7000,7 @@ void TV::ChangeChannel(PlayerContext *ctx, int direction)
     ctx->UnlockDeletePlayer(__FILE__, __LINE__);
 
     ctx->recorder->ChangeChannel(direction);
+    ctx->ChannelChangePhaseDone("backend");
     ClearInputQueues(ctx, false);
 
     if (ctx->player)
@@ -7158,6 +7167,7 @@ void TV::ChangeChannel(PlayerContext *ctx, uint chanid, const QString &chan)
     if (ctx->prevChan.empty())
         ctx->PushPreviousChannel();
 
+    ctx->StartChannelChange();
     PauseAudioUntilBuffered(ctx);
     PauseLiveTV(ctx);
 
@@ -7170,6 +7180,7 @@ void TV::ChangeChannel(PlayerContext *ctx, uint chanid, const QString &chan)
     ctx->UnlockDeletePlayer(__FILE__, __LINE__);
 
     ctx->recorder->SetChannel(channum);
+    ctx->ChannelChangePhaseDone("backend");
 
     if (ctx->player)
         ctx->player->GetAudio()->Reset();
@@ -8891,6 +8902,7 @@ void TV::customEvent(QEvent *e)
             if (ctx->tvchain && ctx->tvchain->GetID() == id)
             {
                 QMutexLocker locker(&timerIdLock);
+                tvchainUpdate[id] = me->ExtraDataList();
                 tvchainUpdateTimerId[StartTimer(1, __LINE__)] = ctx;
                 break;
             }
@@ -8914,6 +8926,20 @@ void TV::customEvent(QEvent *e)
         ReturnPlayerLock(mctx);
     }
 
+    if (message.left(20) == "CHANNEL_CHANGE_TIMES")
+    {
+        cardnum = (tokens.size() >= 2) ? tokens[1].toUInt() : 0;
+
+        PlayerContext *mctx = GetPlayerReadLock(0, __FILE__, __LINE__);
+        for (uint i = 0; mctx && (i < player.size()); i++)
+        {
+            PlayerContext *ctx = GetPlayer(mctx, i);
+            if (ctx->recorder && (ctx->GetCardID() == cardnum))
+                ctx->SetChannelChangeBackendTimes(me->ExtraDataList());
+        }
+        ReturnPlayerLock(mctx);
+    }
+
     if (message.left(6) == "SIGNAL")
     {
         cardnum = (tokens.size() >= 2) ? tokens[1].toUInt() : 0;
@@ -11907,7 +11933,16 @@ void TV::UnpauseLiveTV(PlayerContext *ctx, bool bQuietly /*=false*/)
 
     if (ctx->HasPlayer() && ctx->tvchain)
     {
-        ctx->ReloadTVChain();
+        // Use the latest chain update if it is still pending, else the
+        // chain already loaded, instead of reading the whole chain again.
+        QStringList data;
+        {
+            QMutexLocker locker(&timerIdLock);
+            data = tvchainUpdate.value(ctx->tvchain->GetID());
+        }
+        if (!data.empty() || !ctx->tvchain->TotalSize())
+            ctx->ReloadTVChain(data);
+        ctx->ChannelChangePhaseDone("chain");
         ctx->tvchain->JumpTo(-1, 1);
         ctx->LockDeletePlayer(__FILE__, __LINE__);
         if (ctx->player)
@@ -816,6 +816,8 @@ class MTV_PUBLIC TV : public QObject
     TimerContextMap      stateChangeTimerId;
     TimerContextMap      signalMonitorTimerId;
     TimerContextMap      tvchainUpdateTimerId;
+    /// Chain sent with the last LIVETV_CHAIN UPDATE, by chain id
+    QMap<QString,QStringList> tvchainUpdate;
 
   public:
     // Constants
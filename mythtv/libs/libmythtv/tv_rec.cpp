@@ -934,6 +934,7 @@ void TVRec::FinishedRecording(RecordingInfo *curRec, RecordingQuality *recq)
     {
         JobQueue::RemoveJobsFromMask(JOB_COMMFLAG,  autoRunJobs);
         JobQueue::RemoveJobsFromMask(JOB_TRANSCODE, autoRunJobs);
+        JobQueue::RemoveJobsFromMask(JOB_TRICKPLAY, autoRunJobs);
     }
     if (autoRunJobs)
     {
@@ -3376,7 +3377,14 @@ void TVRec::HandleTuning(void)
         if (TuningOnSameMultiplex(request))
             LOG(VB_PLAYBACK, LOG_INFO, LOC + "On same multiplex");
 
+        if ((request.flags & kFlagLiveTV) && !(request.flags & kFlagEITScan))
+        {
+            tuningPhases.clear();
+            tuningTimer.start();
+        }
+
         TuningShutdowns(request);
+        TuningPhaseDone("shutdown");
 
         // The dequeue isn't safe to do until now because we
         // release the stateChangeLock to teardown a recorder
@@ -3391,6 +3399,7 @@ void TVRec::HandleTuning(void)
                 LOG(VB_RECORD, LOG_INFO, LOC +
                     "No recorder yet, calling TuningFrequency");
                 TuningFrequency(request);
+                TuningPhaseDone("tune");
             }
             else
             {
@@ -3407,14 +3416,20 @@ void TVRec::HandleTuning(void)
             return;
 
         ClearFlags(kFlagWaitingForRecPause);
+        TuningPhaseDone("pause");
         LOG(VB_RECORD, LOG_INFO, LOC +
             "Recorder paused, calling TuningFrequency");
         TuningFrequency(lastTuningRequest);
+        TuningPhaseDone("tune");
     }
 
     MPEGStreamData *streamData = NULL;
-    if (HasFlags(kFlagWaitingForSignal) && !(streamData = TuningSignalCheck()))
-        return;
+    if (HasFlags(kFlagWaitingForSignal))
+    {
+        if (!(streamData = TuningSignalCheck()))
+            return;
+        TuningPhaseDone("lock");
+    }
 
     if (HasFlags(kFlagNeedToStartRecorder))
     {
@@ -3422,6 +3437,8 @@ void TVRec::HandleTuning(void)
             TuningRestartRecorder();
         else
             TuningNewRecorder(streamData);
+        TuningPhaseDone("recorder");
+        TuningPhasesDone();
 
         // If we got this far it is safe to set a new starting channel...
         if (channel)
@@ -3429,6 +3446,39 @@ void TVRec::HandleTuning(void)
     }
 }
 
+/// Notes how long the last phase of a LiveTV channel change took.
+void TVRec::TuningPhaseDone(const QString &phase)
+{
+    if (tuningTimer.isRunning())
+        tuningPhases << phase << QString::number(tuningTimer.restart());
+}
+
+/** \fn TVRec::TuningPhasesDone(void)
+ *  \brief Logs how long each phase of a LiveTV channel change took,
+ *         and sends the times to the frontend for its OSD.
+ */
+void TVRec::TuningPhasesDone(void)
+{
+    if (!tuningTimer.isRunning())
+        return;
+    tuningTimer.stop();
+
+    int total = 0;
+    QStringList times;
+    for (int i = 0; i + 1 < tuningPhases.size(); i += 2)
+    {
+        total += tuningPhases[i+1].toInt();
+        times << QString("%1 %2").arg(tuningPhases[i]).arg(tuningPhases[i+1]);
+    }
+
+    LOG(VB_RECORD, LOG_INFO, LOC + QString("Channel change took %1 ms (%2)")
+            .arg(total).arg(times.join(", ")));
+
+    MythEvent me(QString("CHANNEL_CHANGE_TIMES %1").arg(cardid),
+                 tuningPhases);
+    gCoreContext->dispatch(me);
+}
+
 /** \fn TVRec::TuningCheckForHWChange(const TuningRequest&,QString&,QString&)
  *  \brief Returns cardid for device info row in capturecard if it changes.
  */
@@ -3836,6 +3886,9 @@ static int init_jobs(const RecordingInfo *rec, RecordingProfile &profile,
     // grab standard jobs flags from program info
     JobQueue::AddJobsToMask(rec->GetAutoRunJobs(), jobs);
 
+    if (gCoreContext->GetNumSetting("AutoTrickplayIndex", 0))
+        JobQueue::AddJobsToMask(JOB_TRICKPLAY, jobs);
+
     // disable commercial flagging on PBS, BBC, etc.
     if (rec->IsCommercialFree())
         JobQueue::RemoveJobsFromMask(JOB_COMMFLAG, jobs);
@@ -4102,6 +4155,13 @@ void TVRec::TuningRestartRecorder(void)
     }
     recorder->Reset();
 
+    // Give the recorder the stream types of the PMT the signal monitor
+    // found, so it can find the first keyframe without waiting for the
+    // PMT to be repeated. When the recorder waits for a keyframe it drops
+    // the tables themselves, they are written when they are repeated.
+    if (GetDTVRecorder() && GetDTVRecorder()->GetStreamData())
+        GetDTVRecorder()->GetStreamData()->ResendSingleProgramTables();
+
     // Set file descriptor of channel from recorder for V4L
     if (GetV4LChannel())
         channel->SetFd(recorder->GetVideoFd());
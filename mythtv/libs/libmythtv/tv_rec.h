@@ -11,6 +11,7 @@
 
 // MythTV headers
 #include "mthread.h"
+#include "mythtimer.h"
 #include "inputinfo.h"
 #include "inputgroupmap.h"
 #include "mythdeque.h"
@@ -288,6 +289,8 @@ class MTV_PUBLIC TVRec : public SignalMonitorListener, public QRunnable
                                 QString &channum,
                                 QString &inputname);
     bool TuningOnSameMultiplex(TuningRequest &request);
+    void TuningPhaseDone(const QString &phase);
+    void TuningPhasesDone(void);
 
     void HandleStateChange(void);
     void ChangeState(TVState nextState);
@@ -359,6 +362,9 @@ class MTV_PUBLIC TVRec : public SignalMonitorListener, public QRunnable
     uint           stateFlags;
     TuningQueue    tuningRequests;
     TuningRequest  lastTuningRequest;
+    /// Times each phase of a LiveTV channel change, as name/ms pairs
+    MythTimer      tuningTimer;
+    QStringList    tuningPhases;
     QDateTime      eitScanStartTime;
     mutable QMutex triggerEventLoopLock;
     QWaitCondition triggerEventLoopWait;
@@ -1,6 +1,18 @@
+#include "mythconfig.h"
 #include "util-osd.h"
 #include "dithertable.h"
 
+extern "C" {
+#include "libavutil/cpu.h"
+}
+
+#if defined(__SSE2__) && !HAVE_BIGENDIAN
+#define OSD_SSE2 1
+#include <emmintrin.h>
+#else
+#define OSD_SSE2 0
+#endif
+
 #if HAVE_BIGENDIAN
 #define R_OI  1
 #define G_OI  2
@@ -13,6 +25,16 @@
 #define A_OI  3
 #endif
 
+#if OSD_SSE2
+static bool osd_use_sse2(void)
+{
+    static int sse2 = -1;
+    if (sse2 < 0)
+        sse2 = (av_get_cpu_flags() & AV_CPU_FLAG_SSE2) ? 1 : 0;
+    return sse2;
+}
+#endif
+
 void yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
                     int left, int top, int right, int bottom)
 {
@@ -28,6 +50,18 @@ void yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
         LOG(VB_GENERAL, LOG_ERR,
             QString("OSD image size is odd. This shouldn't happen."));
     }
+#if OSD_SSE2
+    else if (osd_use_sse2())
+    {
+        int sse2_right = left + ((right - left) & ~15);
+        if (sse2_right > left)
+            sse2_yuv888_to_yv12(frame, osd_image, left, top,
+                                sse2_right, bottom);
+        if (sse2_right < right)
+            c_yuv888_to_yv12(frame, osd_image, sse2_right, top,
+                             right, bottom);
+    }
+#endif
     else if (mmx_aligned)
     {
         mmx_yuv888_to_yv12(frame, osd_image, left, top, right, bottom);
@@ -221,6 +255,121 @@ void inline mmx_yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
 #endif
 }
 
+#if OSD_SSE2
+/// Splits 8 YUVA pixels into 16 bit Y, U, V and (255 - alpha) words.
+static inline void sse2_unpack8(const unsigned char *src, __m128i &y,
+                                __m128i &u, __m128i &v, __m128i &ia)
+{
+    const __m128i mask = _mm_set1_epi32(0xff);
+    __m128i p0 = _mm_loadu_si128((const __m128i*)(src));
+    __m128i p1 = _mm_loadu_si128((const __m128i*)(src + 16));
+
+    y  = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, R_OI * 8), mask),
+                         _mm_and_si128(_mm_srli_epi32(p1, R_OI * 8), mask));
+    u  = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, G_OI * 8), mask),
+                         _mm_and_si128(_mm_srli_epi32(p1, G_OI * 8), mask));
+    v  = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, B_OI * 8), mask),
+                         _mm_and_si128(_mm_srli_epi32(p1, B_OI * 8), mask));
+    ia = _mm_sub_epi16(_mm_set1_epi16(255),
+         _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, A_OI * 8), mask),
+                         _mm_and_si128(_mm_srli_epi32(p1, A_OI * 8), mask)));
+}
+
+/// Blends 8 luma pixels, dst = ((dst * (255 - a)) >> 8) + y
+static inline __m128i sse2_blend8(__m128i dst, __m128i y, __m128i ia)
+{
+    return _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(dst, ia), 8), y);
+}
+
+/// Averages the 2x2 blocks of a pair of rows of 8 words into 4 dwords.
+static inline __m128i sse2_avg2x2(__m128i row1, __m128i row2)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    return _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(row1, ones),
+                                        _mm_madd_epi16(row2, ones)), 2);
+}
+
+/** \fn sse2_yuv888_to_yv12
+ *  \brief Blends the OSD onto the frame 16 pixels and two lines at a time.
+ *
+ *   This gives the same result as c_yuv888_to_yv12(), except that blocks
+ *   of the OSD which are completely transparent are skipped, leaving
+ *   the video untouched instead of darkening it by up to one level.
+ *   The width must be a multiple of 16.
+ */
+void sse2_yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
+                         int left, int top, int right, int bottom)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i amask = _mm_set1_epi32(0xff << (A_OI * 8));
+    int bpl = osd_image->bytesPerLine();
+
+    for (int row = top; row < bottom; row += 2)
+    {
+        unsigned char *src1 = osd_image->scanLine(row) + (left << 2);
+        unsigned char *src2 = src1 + bpl;
+        unsigned char *y1 = frame->buf + frame->offsets[0] +
+                            (frame->pitches[0] * row) + left;
+        unsigned char *y2 = y1 + frame->pitches[0];
+        unsigned char *u  = frame->buf + frame->offsets[1] +
+                            (frame->pitches[1] * (row >> 1)) + (left >> 1);
+        unsigned char *v  = frame->buf + frame->offsets[2] +
+                            (frame->pitches[2] * (row >> 1)) + (left >> 1);
+
+        for (int col = left; col < right; col += 16)
+        {
+            __m128i any = zero;
+            for (int i = 0; i < 64; i += 16)
+            {
+                any = _mm_or_si128(any,
+                    _mm_loadu_si128((const __m128i*)(src1 + i)));
+                any = _mm_or_si128(any,
+                    _mm_loadu_si128((const __m128i*)(src2 + i)));
+            }
+            any = _mm_and_si128(any, amask);
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xffff)
+            {
+                __m128i ya, ua, va, ia, yb, ub, vb, ib;
+                __m128i yc, uc, vc, ic, yd, ud, vd, id;
+                sse2_unpack8(src1,      ya, ua, va, ia);
+                sse2_unpack8(src1 + 32, yb, ub, vb, ib);
+                sse2_unpack8(src2,      yc, uc, vc, ic);
+                sse2_unpack8(src2 + 32, yd, ud, vd, id);
+
+                __m128i d = _mm_loadu_si128((__m128i*)y1);
+                d = _mm_packus_epi16(
+                    sse2_blend8(_mm_unpacklo_epi8(d, zero), ya, ia),
+                    sse2_blend8(_mm_unpackhi_epi8(d, zero), yb, ib));
+                _mm_storeu_si128((__m128i*)y1, d);
+
+                d = _mm_loadu_si128((__m128i*)y2);
+                d = _mm_packus_epi16(
+                    sse2_blend8(_mm_unpacklo_epi8(d, zero), yc, ic),
+                    sse2_blend8(_mm_unpackhi_epi8(d, zero), yd, id));
+                _mm_storeu_si128((__m128i*)y2, d);
+
+                __m128i ca = _mm_packs_epi32(sse2_avg2x2(ia, ic),
+                                             sse2_avg2x2(ib, id));
+                __m128i cu = _mm_packs_epi32(sse2_avg2x2(ua, uc),
+                                             sse2_avg2x2(ub, ud));
+                __m128i cv = _mm_packs_epi32(sse2_avg2x2(va, vc),
+                                             sse2_avg2x2(vb, vd));
+
+                d = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*)u), zero);
+                _mm_storel_epi64((__m128i*)u,
+                    _mm_packus_epi16(sse2_blend8(d, cu, ca), zero));
+                d = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*)v), zero);
+                _mm_storel_epi64((__m128i*)v,
+                    _mm_packus_epi16(sse2_blend8(d, cv, ca), zero));
+            }
+
+            src1 += 64; src2 += 64; y1 += 16; y2 += 16; u += 8; v += 8;
+        }
+    }
+}
+#endif
+
 void inline c_yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
                              int left, int top, int right, int bottom)
 {
@@ -285,6 +434,49 @@ void inline c_yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
     }
 }
 
+/** \fn yuv888_opaque_rect
+ *  \brief Returns the part of rect which has any non-transparent pixels,
+ *         widened to the given alignment, or an empty rect if none.
+ *
+ *   The result never extends past rect, so rect should already be aligned.
+ */
+QRect yuv888_opaque_rect(MythImage *osd_image, const QRect &rect,
+                         int align_x, int align_y)
+{
+    QRect area = rect & osd_image->rect();
+    int min_x = area.right() + 1, max_x = area.left() - 1;
+    int min_y = area.bottom() + 1, max_y = area.top() - 1;
+
+    for (int row = area.top(); row <= area.bottom(); row++)
+    {
+        const unsigned char *alpha =
+            osd_image->scanLine(row) + (area.left() << 2) + A_OI;
+        for (int col = area.left(); col <= area.right(); col++, alpha += 4)
+        {
+            if (!*alpha)
+                continue;
+            min_x = qMin(min_x, col);
+            max_x = qMax(max_x, col);
+            min_y = qMin(min_y, row);
+            max_y = qMax(max_y, row);
+        }
+    }
+
+    if (max_x < min_x)
+        return QRect();
+
+    align_x = qMax(align_x, 1);
+    align_y = qMax(align_y, 1);
+    int left   = qMax(min_x - (min_x % align_x), area.left());
+    int top    = qMax(min_y - (min_y % align_y), area.top());
+    int right  = qMin(((max_x + align_x) / align_x) * align_x,
+                      area.right() + 1);
+    int bottom = qMin(((max_y + align_y) / align_y) * align_y,
+                      area.bottom() + 1);
+
+    return QRect(left, top, right - left, bottom - top);
+}
+
 void yuv888_to_i44(unsigned char *dest, MythImage *osd_image, QSize dst_size,
                    int left, int top, int right, int bottom, bool ifirst)
 {
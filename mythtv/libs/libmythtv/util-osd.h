@@ -3,6 +3,7 @@
 
 #include "mythlogging.h"
 #include "mythimage.h"
+#include "mythtvexp.h"
 #include "frame.h"
 
 #define ALIGN_C 2
@@ -12,12 +13,16 @@
 #define ALIGN_X_MMX 2
 #endif
 
-void yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
-                    int left, int top, int right, int bottom);
+MTV_PUBLIC void yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
+                               int left, int top, int right, int bottom);
+void sse2_yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
+                         int left, int top, int right, int bottom);
 void inline mmx_yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
                                int left, int top, int right, int bottom);
 void inline c_yuv888_to_yv12(VideoFrame *frame, MythImage *osd_image,
                              int left, int top, int right, int bottom);
+MTV_PUBLIC QRect yuv888_opaque_rect(MythImage *osd_image, const QRect &rect,
+                                    int align_x, int align_y);
 void yuv888_to_i44(unsigned char *dest, MythImage *osd_image, QSize dst_size,
                    int left, int top, int right, int bottom, bool ifirst);
 #endif
@@ -2,6 +2,7 @@
 // based on earlier work in MythTV's videout_xvmc.cpp
 
 #include <unistd.h>
+#include <sys/time.h>
 
 #include "mythconfig.h"
 
@@ -20,6 +21,63 @@ extern "C" {
 
 int next_dbg_str = 0;
 
+static inline uint64_t lock_usecs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
+
+/** \class VideoBuffersLocker
+ *  \brief QMutexLocker for VideoBuffers::global_lock which also records
+ *         how long the lock was waited for and held.
+ *
+ *   Only the outermost lock of a thread is timed. It is used in the
+ *   methods the decoder and display threads call for every frame, and
+ *   in the seek methods which hold the lock longest. The outermost lock
+ *   also returns the frames the display thread handed back while the
+ *   lock was busy.
+ */
+class VideoBuffersLocker
+{
+  public:
+    VideoBuffersLocker(VideoBuffers *vb) : m_vb(vb)
+    {
+        if (m_vb->global_lock.tryLock())
+        {
+            if (!m_vb->lock_depth)
+                m_vb->lock_start = lock_usecs();
+        }
+        else
+        {
+            uint64_t start = lock_usecs();
+            m_vb->global_lock.lock();
+            m_vb->lock_start = lock_usecs();
+
+            uint64_t wait = m_vb->lock_start - start;
+            m_vb->lock_waits++;
+            m_vb->lock_wait_max = max(m_vb->lock_wait_max, wait);
+        }
+        if (!m_vb->lock_depth++)
+            m_vb->ReturnDoneFrames();
+    }
+
+   ~VideoBuffersLocker()
+    {
+        if (!--m_vb->lock_depth)
+        {
+            uint64_t hold = lock_usecs() - m_vb->lock_start;
+            m_vb->lock_count++;
+            m_vb->lock_hold_total += hold;
+            m_vb->lock_hold_max = max(m_vb->lock_hold_max, hold);
+        }
+        m_vb->global_lock.unlock();
+    }
+
+  private:
+    VideoBuffers *m_vb;
+};
+
 YUVInfo::YUVInfo(uint w, uint h, uint sz, const int *p, const int *o)
     : width(w), height(h), size(sz)
 {
@@ -108,6 +166,7 @@ YUVInfo::YUVInfo(uint w, uint h, uint sz, const int *p, const int *o)
  *  displayed - frames displayed but still used as a reference frame
  *  pause     - frames used for pause
  *  finished  - frames that are finished displaying but still in use by decoder
+ *               or shared
  *
  *  NOTE: All queues are mutually exclusive except "decode" which tracks frames
  *        that have been released but still in use by the decoder. If a frame
@@ -115,6 +174,13 @@ YUVInfo::YUVInfo(uint w, uint h, uint sz, const int *p, const int *o)
  *        decoder (in the decode queue) then it is placed in the finished queue
  *        until the decoder is no longer using it (not in the decode queue).
  *
+ *  Frames can also be shared with ShareFrame(), before or after they
+ *  are released, which lets something like an encoder or analyzer keep
+ *  reading the frame after it has been displayed or discarded, instead
+ *  of copying it. A shared
+ *  frame is not handed out by GetNextFreeFrame() again until every
+ *  ShareFrame() call has been matched by an UnshareFrame() call.
+ *
  * \see VideoOutput
  */
 
@@ -122,6 +188,11 @@ VideoBuffers::VideoBuffers()
     : needfreeframes(0), needprebufferframes(0),
       needprebufferframes_normal(0), needprebufferframes_small(0),
       keepprebufferframes(0), createdpauseframe(false), rpos(0), vpos(0),
+      copiedBytes(0), copiedFrames(0),
+      gop_cache_key(-1), gop_cache_bytes(0),
+      lock_depth(0), lock_start(0), lock_count(0), lock_waits(0),
+      lock_wait_max(0), lock_hold_total(0), lock_hold_max(0),
+      done_head(0), done_tail(0), done_producer(0), done_handoffs(0),
       global_lock(QMutex::Recursive)
 {
 }
@@ -218,6 +289,9 @@ void VideoBuffers::Reset()
     pause.clear();
     displayed.clear();
     vbufferMap.clear();
+
+    // Forget frames handed back for the old buffers
+    done_tail.fetchAndStoreRelease(done_head.fetchAndAddAcquire(0));
 }
 
 /**
@@ -233,25 +307,45 @@ void VideoBuffers::SetPrebuffering(bool normal)
 
 VideoFrame *VideoBuffers::GetNextFreeFrameInternal(BufferType enqueue_to)
 {
-    QMutexLocker locker(&global_lock);
+    VideoBuffersLocker locker(this);
     VideoFrame *frame = NULL;
+    VideoFrame *busy  = NULL;
 
-    // Try to get a frame not being used by the decoder
+    // Try to get a frame not being used by the decoder or shared
     for (uint i = 0; i < available.size(); i++)
     {
         frame = available.dequeue();
-        if (decode.contains(frame))
-            available.enqueue(frame);
-        else
+        if (!InUse(frame))
             break;
+        available.enqueue(frame);
+
+        // A frame still used by the decoder is served as a last resort,
+        // but a shared frame is never served.
+        if (shared.find(frame) == shared.end())
+            busy = frame;
+        frame = NULL;
     }
 
+    if (!frame)
+        frame = busy;
+
     while (frame && used.contains(frame))
     {
         LOG(VB_PLAYBACK, LOG_NOTICE,
             QString("GetNextFreeFrame() served a busy frame %1. Dropping. %2")
                 .arg(DebugString(frame, true)).arg(GetStatus()));
-        frame = available.dequeue();
+        frame = NULL;
+
+        // Shared frames are left in the queue, they are still being read.
+        for (uint i = available.size(); i && !frame; i--)
+        {
+            frame = available.dequeue();
+            if (shared.find(frame) != shared.end())
+            {
+                available.enqueue(frame);
+                frame = NULL;
+            }
+        }
     }
 
     if (frame)
@@ -305,7 +399,7 @@ VideoFrame *VideoBuffers::GetNextFreeFrame(BufferType enqueue_to)
  */
 void VideoBuffers::ReleaseFrame(VideoFrame *frame)
 {
-    QMutexLocker locker(&global_lock);
+    VideoBuffersLocker locker(this);
 
     vpos = vbufferMap[frame];
     limbo.remove(frame);
@@ -320,7 +414,7 @@ void VideoBuffers::ReleaseFrame(VideoFrame *frame)
  */
 void VideoBuffers::DeLimboFrame(VideoFrame *frame)
 {
-    QMutexLocker locker(&global_lock);
+    VideoBuffersLocker locker(this);
     if (limbo.contains(frame))
         limbo.remove(frame);
 
@@ -340,29 +434,120 @@ void VideoBuffers::DeLimboFrame(VideoFrame *frame)
  */
 void VideoBuffers::StartDisplayingFrame(void)
 {
-    QMutexLocker locker(&global_lock);
+    VideoBuffersLocker locker(this);
     rpos = vbufferMap[used.head()];
 }
 
 /**
  * \fn VideoBuffers::DoneDisplayingFrame(VideoFrame *frame)
  *  Removes frame from used queue and adds it to the available list.
+ *
+ *  When another thread holds the lock, for instance the decoder in
+ *  DiscardFrames() after a seek, the frame is handed over through a
+ *  lock-free ring instead, so the display thread does not wait. The
+ *  next thread to take the lock returns it.
  */
 void VideoBuffers::DoneDisplayingFrame(VideoFrame *frame)
 {
-    QMutexLocker locker(&global_lock);
+    bool locked = global_lock.tryLock();
+    if (!locked && PushDoneFrame(frame))
+        return;
+
+    VideoBuffersLocker locker(this);
+    if (locked)
+        global_lock.unlock();
+
+    FinishDisplayingFrame(frame);
+}
+
+/**
+ * \fn VideoBuffers::PushDoneFrame(VideoFrame*)
+ *  Adds a frame to the ring of displayed frames without taking
+ *  global_lock. Returns false, and the caller has to take the lock, when
+ *  the ring is full or another thread is pushing a frame.
+ */
+bool VideoBuffers::PushDoneFrame(VideoFrame *frame)
+{
+    if (!done_producer.testAndSetAcquire(0, 1))
+        return false;
+
+    const int wrap = 2 * kDoneRingSize;
+    int head = done_head.fetchAndAddAcquire(0);
+    int tail = done_tail.fetchAndAddAcquire(0);
+    bool pushed = ((head - tail + wrap) % wrap) < (int)kDoneRingSize;
+    if (pushed)
+    {
+        done_ring[head % kDoneRingSize] = frame;
+        done_head.fetchAndStoreRelease((head + 1) % wrap);
+    }
+
+    done_producer.fetchAndStoreRelease(0);
+    return pushed;
+}
 
+/**
+ * \fn VideoBuffers::ReturnDoneFrames(void)
+ *  Finishes the frames PushDoneFrame() handed over. Must be called
+ *  with global_lock held, which makes the lock holder the only consumer.
+ *  A frame which was discarded for a seek in the meantime, and may
+ *  already be decoded onto again, is left alone.
+ */
+void VideoBuffers::ReturnDoneFrames(void)
+{
+    const int wrap = 2 * kDoneRingSize;
+    int tail = done_tail.fetchAndAddAcquire(0);
+    while (tail != done_head.fetchAndAddAcquire(0))
+    {
+        VideoFrame *frame = done_ring[tail % kDoneRingSize];
+        tail = (tail + 1) % wrap;
+        done_tail.fetchAndStoreRelease(tail);
+        done_handoffs++;
+
+        if ((vbufferMap.find(frame) == vbufferMap.end()) ||
+            (!used.contains(frame) &&
+             (available.contains(frame) || limbo.contains(frame))))
+        {
+            continue;
+        }
+        FinishDisplayingFrame(frame);
+    }
+}
+
+/// Moves a displayed frame from used to finished, with global_lock held.
+void VideoBuffers::FinishDisplayingFrame(VideoFrame *frame)
+{
     if(used.contains(frame))
         remove(kVideoBuffer_used, frame);
 
     enqueue(kVideoBuffer_finished, frame);
 
-    // check if any finished frames are no longer used by decoder and return to available
+    ReturnFinishedFrames();
+
+    if (copiedBytes && (++copiedFrames >= 500))
+    {
+        LOG(VB_PLAYBACK, LOG_DEBUG,
+            QString("VideoBuffers: %1 bytes copied per displayed frame")
+                .arg(copiedBytes / copiedFrames));
+        copiedBytes  = 0;
+        copiedFrames = 0;
+    }
+}
+
+/// Returns true if the decoder or a reader still needs the frame.
+bool VideoBuffers::InUse(const VideoFrame *frame) const
+{
+    return decode.contains(const_cast<VideoFrame*>(frame)) ||
+           (shared.find(frame) != shared.end());
+}
+
+/// Moves finished frames nobody is using any more to available.
+void VideoBuffers::ReturnFinishedFrames(void)
+{
     frame_queue_t ula(finished);
     frame_queue_t::iterator it = ula.begin();
     for (; it != ula.end(); ++it)
     {
-        if (!decode.contains(*it))
+        if (!InUse(*it))
         {
             remove(kVideoBuffer_finished, *it);
             enqueue(kVideoBuffer_avail, *it);
@@ -370,6 +555,186 @@ void VideoBuffers::DoneDisplayingFrame(VideoFrame *frame)
     }
 }
 
+/**
+ * \fn VideoBuffers::ShareFrame(VideoFrame*)
+ *  Keeps a frame from being reused until UnshareFrame() is called, so
+ *  it can be read without being copied. The frame can be shared while
+ *  the decoder still holds it, and GetNextFreeFrame() skips it after it
+ *  is released until the last UnshareFrame() call.
+ *
+ *  At most a quarter of the buffers can be shared at once, so that the
+ *  decoder never runs out of frames. When this returns false the caller
+ *  has to copy the frame as before.
+ */
+bool VideoBuffers::ShareFrame(VideoFrame *frame)
+{
+    QMutexLocker locker(&global_lock);
+
+    if (!frame || (vbufferMap.find(frame) == vbufferMap.end()))
+        return false;
+
+    frame_ref_map_t::iterator it = shared.find(frame);
+    if (it != shared.end())
+    {
+        it->second++;
+        return true;
+    }
+
+    if (shared.size() >= Size() / 4)
+        return false;
+
+    shared[frame] = 1;
+    return true;
+}
+
+/**
+ * \fn VideoBuffers::UnshareFrame(VideoFrame*)
+ *  Releases a ShareFrame() reference, when the last one is released
+ *  a finished frame is returned to the available queue.
+ */
+void VideoBuffers::UnshareFrame(VideoFrame *frame)
+{
+    QMutexLocker locker(&global_lock);
+
+    frame_ref_map_t::iterator it = shared.find(frame);
+    if (it == shared.end())
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            QString("UnshareFrame() called on unshared frame %1")
+                .arg(DebugString(frame, true)));
+        return;
+    }
+
+    if (--(it->second))
+        return;
+
+    shared.erase(it);
+    ReturnFinishedFrames();
+}
+
+bool VideoBuffers::IsShared(const VideoFrame *frame) const
+{
+    QMutexLocker locker(&global_lock);
+    return shared.find(frame) != shared.end();
+}
+
+/**
+ * \fn VideoBuffers::CountCopy(uint)
+ *  Adds to the number of frame bytes copied, which is logged as bytes
+ *  copied per displayed frame with -v playback --loglevel debug.
+ *  The video outputs count their pause and scratch frame copies,
+ *  mythtranscode counts frames it could not share, screen grabs
+ *  count their deinterlace pass, and the GOP cache counts its own.
+ */
+void VideoBuffers::CountCopy(uint bytes)
+{
+    QMutexLocker locker(&global_lock);
+    copiedBytes += bytes;
+}
+
+/**
+ * \fn VideoBuffers::CacheGOPFrame(long long, const VideoFrame*)
+ *  Keeps a copy of a frame an exact seek decoded and skipped on its way
+ *  from keyframe to the seek target, so that a later exact seek into
+ *  the same GOP, like stepping back a frame at a time, can show the
+ *  copy instead of decoding from the keyframe again.
+ *
+ *  Only the GOP of the last keyframe passed in is kept, and only up to
+ *  kGOPCacheBytes of it. Frames without a YV12 buffer in system memory,
+ *  i.e. hardware decoded frames, aren't cached.
+ */
+void VideoBuffers::CacheGOPFrame(long long keyframe, const VideoFrame *frame)
+{
+    if (!frame || !frame->buf || frame->dummy || (FMT_YV12 != frame->codec))
+        return;
+
+    QMutexLocker locker(&global_lock);
+
+    if (keyframe != gop_cache_key)
+    {
+        ClearGOPCache();
+        gop_cache_key = keyframe;
+    }
+
+    frame_vector_t::const_iterator it = gop_cache.begin();
+    for (; it != gop_cache.end(); ++it)
+    {
+        if (it->frameNumber == frame->frameNumber)
+            return;
+    }
+
+    if (gop_cache_bytes + frame->size > kGOPCacheBytes)
+        return;
+
+    VideoFrame cached = *frame;
+    cached.buf = (unsigned char*)av_malloc(frame->size);
+    if (!cached.buf)
+        return;
+    memcpy(cached.buf, frame->buf, frame->size);
+    cached.qscale_table = NULL;
+    cached.qstride      = 0;
+    memset(cached.priv, 0, sizeof(cached.priv));
+
+    gop_cache.push_back(cached);
+    gop_cache_bytes += frame->size;
+    copiedBytes     += frame->size;
+}
+
+/**
+ * \fn VideoBuffers::GetGOPFrame(long long, long long, VideoFrame*)
+ *  Copies frame frameNumber of the GOP starting at keyframe from the
+ *  GOP cache into frame, along with its timecodes and flags.
+ *
+ * \return false if the frame isn't cached or frame's layout differs.
+ */
+bool VideoBuffers::GetGOPFrame(long long keyframe, long long frameNumber,
+                               VideoFrame *frame)
+{
+    QMutexLocker locker(&global_lock);
+
+    if (!frame || !frame->buf || (keyframe != gop_cache_key))
+        return false;
+
+    frame_vector_t::const_iterator it = gop_cache.begin();
+    for (; it != gop_cache.end(); ++it)
+    {
+        if (it->frameNumber == frameNumber)
+            break;
+    }
+
+    if (it == gop_cache.end() || !compatible(frame, &(*it)))
+        return false;
+
+    memcpy(frame->buf, it->buf, it->size);
+    frame->interlaced_frame = it->interlaced_frame;
+    frame->top_field_first  = it->top_field_first;
+    frame->repeat_pict      = it->repeat_pict;
+    frame->timecode         = it->timecode;
+    frame->disp_timecode    = it->disp_timecode;
+    frame->frameNumber      = it->frameNumber;
+    frame->aspect           = it->aspect;
+    frame->dummy            = 0;
+
+    copiedBytes += it->size;
+    return true;
+}
+
+/**
+ * \fn VideoBuffers::ClearGOPCache(void)
+ *  Frees the frames kept by CacheGOPFrame().
+ */
+void VideoBuffers::ClearGOPCache(void)
+{
+    QMutexLocker locker(&global_lock);
+
+    frame_vector_t::iterator it = gop_cache.begin();
+    for (; it != gop_cache.end(); ++it)
+        av_free(it->buf);
+    gop_cache.clear();
+    gop_cache_key   = -1;
+    gop_cache_bytes = 0;
+}
+
 /**
  * \fn VideoBuffers::DiscardFrame(VideoFrame*)
  *  Frame is ready to be reused by decoder.
@@ -377,7 +742,7 @@ void VideoBuffers::DoneDisplayingFrame(VideoFrame *frame)
  */
 void VideoBuffers::DiscardFrame(VideoFrame *frame)
 {
-    QMutexLocker locker(&global_lock);
+    VideoBuffersLocker locker(this);
     safeEnqueue(kVideoBuffer_avail, frame);
 }
 
@@ -432,6 +797,7 @@ const frame_queue_t *VideoBuffers::queue(BufferType type) const
 VideoFrame *VideoBuffers::dequeue(BufferType type)
 {
     QMutexLocker locker(&global_lock);
+    ReturnDoneFrames();
 
     frame_queue_t *q = queue(type);
 
@@ -444,6 +810,7 @@ VideoFrame *VideoBuffers::dequeue(BufferType type)
 VideoFrame *VideoBuffers::head(BufferType type)
 {
     QMutexLocker locker(&global_lock);
+    ReturnDoneFrames();
 
     frame_queue_t *q = queue(type);
 
@@ -459,6 +826,7 @@ VideoFrame *VideoBuffers::head(BufferType type)
 VideoFrame *VideoBuffers::tail(BufferType type)
 {
     QMutexLocker locker(&global_lock);
+    ReturnDoneFrames();
 
     frame_queue_t *q = queue(type);
 
@@ -538,6 +906,7 @@ void VideoBuffers::safeEnqueue(BufferType dst, VideoFrame* frame)
 frame_queue_t::iterator VideoBuffers::begin_lock(BufferType type)
 {
     global_lock.lock();
+    ReturnDoneFrames();
     frame_queue_t *q = queue(type);
     if (q)
         return q->begin();
@@ -562,6 +931,7 @@ frame_queue_t::iterator VideoBuffers::end(BufferType type)
 uint VideoBuffers::size(BufferType type) const
 {
     QMutexLocker locker(&global_lock);
+    const_cast<VideoBuffers*>(this)->ReturnDoneFrames();
 
     const frame_queue_t *q = queue(type);
     if (q)
@@ -573,6 +943,7 @@ uint VideoBuffers::size(BufferType type) const
 bool VideoBuffers::contains(BufferType type, VideoFrame *frame) const
 {
     QMutexLocker locker(&global_lock);
+    const_cast<VideoBuffers*>(this)->ReturnDoneFrames();
 
     const frame_queue_t *q = queue(type);
     if (q)
@@ -611,7 +982,7 @@ void VideoBuffers::SetLastShownFrameToScratch(void)
  */
 void VideoBuffers::DiscardFrames(bool next_frame_keyframe)
 {
-    QMutexLocker locker(&global_lock);
+    VideoBuffersLocker locker(this);
     LOG(VB_PLAYBACK, LOG_INFO, QString("VideoBuffers::DiscardFrames(%1): %2")
             .arg(next_frame_keyframe).arg(GetStatus()));
 
@@ -627,11 +998,6 @@ void VideoBuffers::DiscardFrames(bool next_frame_keyframe)
         return;
     }
 
-    // Remove inheritence of all frames not in displayed or pause
-    frame_queue_t ula(used);
-    ula.insert(ula.end(), limbo.begin(), limbo.end());
-    ula.insert(ula.end(), available.begin(), available.end());
-    ula.insert(ula.end(), finished.begin(), finished.end());
     frame_queue_t::iterator it;
 
     // Discard frames
@@ -676,7 +1042,7 @@ void VideoBuffers::DiscardFrames(bool next_frame_keyframe)
 void VideoBuffers::ClearAfterSeek(void)
 {
     {
-        QMutexLocker locker(&global_lock);
+        VideoBuffersLocker locker(this);
 
         for (uint i = 0; i < Size(); i++)
             at(i)->timecode = 0;
@@ -784,6 +1150,15 @@ uint VideoBuffers::AddBuffer(int width, int height, void* data,
 void VideoBuffers::DeleteBuffers()
 {
     next_dbg_str = 0;
+
+    if (!shared.empty())
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            QString("VideoBuffers::DeleteBuffers(): %1 frames still shared")
+                .arg(shared.size()));
+        shared.clear();
+    }
+
     for (uint i = 0; i < Size(); i++)
     {
         buffers[i].buf = NULL;
@@ -798,6 +1173,43 @@ void VideoBuffers::DeleteBuffers()
     for (uint i = 0; i < allocated_arrays.size(); i++)
         av_free(allocated_arrays[i]);
     allocated_arrays.clear();
+
+    ClearGOPCache();
+}
+
+/**
+ * \fn VideoBuffers::GetLockStatus(void)
+ *  Returns the longest wait for and the longest hold of the buffer lock
+ *  since the last call, e.g. "0.0/0.1ms", followed by the number of
+ *  frames the display thread handed back without the lock if there were
+ *  any, and starts a new interval. Contended locks, locks taken and the
+ *  average hold time are logged with -v playback --loglevel debug.
+ */
+QString VideoBuffers::GetLockStatus(void)
+{
+    QMutexLocker locker(&global_lock);
+
+    QString str = QString("%1/%2ms")
+        .arg(lock_wait_max * 0.001, 0, 'f', 1)
+        .arg(lock_hold_max * 0.001, 0, 'f', 1);
+    if (done_handoffs)
+        str += QString(" %1 unlocked").arg(done_handoffs);
+
+    LOG(VB_PLAYBACK, LOG_DEBUG,
+        QString("VideoBuffers: %1 of %2 locks contended, max wait %3 us, "
+                "hold avg %4 us max %5 us, %6 frames handed back unlocked")
+            .arg(lock_waits).arg(lock_count).arg(lock_wait_max)
+            .arg(lock_count ? lock_hold_total / lock_count : 0)
+            .arg(lock_hold_max).arg(done_handoffs));
+
+    lock_count      = 0;
+    lock_waits      = 0;
+    lock_wait_max   = 0;
+    lock_hold_total = 0;
+    lock_hold_max   = 0;
+    done_handoffs   = 0;
+
+    return str;
 }
 
 static unsigned long long to_bitmap(const frame_queue_t& list);
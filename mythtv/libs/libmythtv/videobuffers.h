@@ -12,6 +12,7 @@ using namespace std;
 
 #include <QMutex>
 #include <QString>
+#include <QAtomicInt>
 #include <QWaitCondition>
 
 #include "mythdeque.h"
@@ -25,6 +26,7 @@ typedef vector<VideoFrame>                    frame_vector_t;
 typedef map<const unsigned char*, void*>      buffer_map_t;
 typedef map<const VideoFrame*, uint>          vbuffer_map_t;
 typedef map<const VideoFrame*, QMutex*>       frame_lock_map_t;
+typedef map<const VideoFrame*, uint>          frame_ref_map_t;
 typedef vector<unsigned char*>                uchar_vector_t;
 
 
@@ -60,6 +62,8 @@ class YUVInfo
 
 class VideoBuffers
 {
+    friend class VideoBuffersLocker;
+
   public:
     VideoBuffers();
     virtual ~VideoBuffers();
@@ -87,6 +91,16 @@ class VideoBuffers
     void DoneDisplayingFrame(VideoFrame *frame);
     void DiscardFrame(VideoFrame *frame);
 
+    bool ShareFrame(VideoFrame *frame);
+    void UnshareFrame(VideoFrame *frame);
+    bool IsShared(const VideoFrame *frame) const;
+    void CountCopy(uint bytes);
+
+    void CacheGOPFrame(long long keyframe, const VideoFrame *frame);
+    bool GetGOPFrame(long long keyframe, long long frameNumber,
+                     VideoFrame *frame);
+    void ClearGOPCache(void);
+
     VideoFrame *at(uint i) { return &buffers[i]; }
     VideoFrame *dequeue(BufferType);
     VideoFrame *head(BufferType); // peek at next dequeue
@@ -129,10 +143,16 @@ class VideoBuffers
                    VideoFrameType fmt);
 
     QString GetStatus(int n=-1) const; // debugging method
+    QString GetLockStatus(void);
   private:
     frame_queue_t         *queue(BufferType type);
     const frame_queue_t   *queue(BufferType type) const;
     VideoFrame            *GetNextFreeFrameInternal(BufferType enqueue_to);
+    bool                   InUse(const VideoFrame *frame) const;
+    void                   ReturnFinishedFrames(void);
+    void                   FinishDisplayingFrame(VideoFrame *frame);
+    bool                   PushDoneFrame(VideoFrame *frame);
+    void                   ReturnDoneFrames(void);
 
     frame_queue_t          available, used, limbo, pause, displayed, decode, finished;
     vbuffer_map_t          vbufferMap; // videobuffers to buffer's index
@@ -149,6 +169,38 @@ class VideoBuffers
     uint                   rpos;
     uint                   vpos;
 
+    frame_ref_map_t        shared; // read only users of released frames
+    uint64_t               copiedBytes;
+    uint                   copiedFrames;
+
+    // Copies of the frames exact seeks decoded on their way from the
+    // keyframe to the target, see CacheGOPFrame()
+    static const uint      kGOPCacheBytes = 64 * 1024 * 1024;
+    frame_vector_t         gop_cache;
+    long long              gop_cache_key;   ///< keyframe of the cached GOP
+    uint64_t               gop_cache_bytes;
+
+    // global_lock contention in the decode/display hand off,
+    // in microseconds, see GetLockStatus()
+    uint                   lock_depth;
+    uint64_t               lock_start;
+    uint                   lock_count;
+    uint                   lock_waits;
+    uint64_t               lock_wait_max;
+    uint64_t               lock_hold_total;
+    uint64_t               lock_hold_max;
+
+    // Single producer, single consumer ring the display thread hands
+    // displayed frames back through when global_lock is busy, see
+    // DoneDisplayingFrame(). Indices run modulo 2 * kDoneRingSize so a
+    // full ring can be told from an empty one.
+    static const uint      kDoneRingSize = 64;
+    VideoFrame            *done_ring[kDoneRingSize];
+    QAtomicInt             done_head;     ///< next slot the producer fills
+    QAtomicInt             done_tail;     ///< next slot the consumer reads
+    QAtomicInt             done_producer; ///< set while a thread pushes
+    uint                   done_handoffs; ///< frames handed back unlocked
+
     mutable QMutex         global_lock;
 };
 
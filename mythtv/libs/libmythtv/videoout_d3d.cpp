@@ -434,6 +434,7 @@ void VideoOutputD3D::UpdatePauseFrame(int64_t &disp_timecode)
         if (!used_frame)
             used_frame = vbuffers.GetScratchFrame();
         CopyFrame(&m_pauseFrame, used_frame);
+        vbuffers.CountCopy(used_frame->size);
         disp_timecode = m_pauseFrame.disp_timecode;
     }
     else if (codec_is_dxva2(video_codec_id))
@@ -536,6 +537,7 @@ void VideoOutputD3D::ProcessFrame(VideoFrame *frame, OSD *osd,
         {
             frame = vbuffers.GetScratchFrame();
             CopyFrame(vbuffers.GetScratchFrame(), &m_pauseFrame);
+            vbuffers.CountCopy(m_pauseFrame.size);
         }
         pauseframe = true;
     }
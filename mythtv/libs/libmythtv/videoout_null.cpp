@@ -213,13 +213,17 @@ void VideoOutputNull::UpdatePauseFrame(int64_t &disp_timecode)
         used_frame = vbuffers.head(kVideoBuffer_used);
 
     if (used_frame)
+    {
         CopyFrame(&av_pause_frame, used_frame);
+        vbuffers.CountCopy(used_frame->size);
+    }
     vbuffers.end_lock();
 
     if (!used_frame)
     {
         vbuffers.GetScratchFrame()->frameNumber = framesPlayed - 1;
         CopyFrame(&av_pause_frame, vbuffers.GetScratchFrame());
+        vbuffers.CountCopy(av_pause_frame.size);
     }
 
     disp_timecode = av_pause_frame.disp_timecode;
@@ -469,6 +469,7 @@ void VideoOutputOpenGL::ProcessFrame(VideoFrame *frame, OSD *osd,
     {
         frame = vbuffers.GetScratchFrame();
         CopyFrame(vbuffers.GetScratchFrame(), &av_pause_frame);
+        vbuffers.CountCopy(av_pause_frame.size);
         pauseframe = true;
     }
 
@@ -691,6 +692,7 @@ void VideoOutputOpenGL::UpdatePauseFrame(int64_t &disp_timecode)
         used_frame = vbuffers.GetScratchFrame();
 
     CopyFrame(&av_pause_frame, used_frame);
+    vbuffers.CountCopy(used_frame->size);
     disp_timecode = av_pause_frame.disp_timecode;
 }
 
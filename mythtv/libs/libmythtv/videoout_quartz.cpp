@@ -1662,6 +1662,7 @@ void VideoOutputQuartz::UpdatePauseFrame(int64_t &disp_timecode)
         CopyFrame(&pauseFrame, pauseu);
     else
         CopyFrame(&pauseFrame, pauseb);
+    vbuffers.CountCopy(pauseFrame.size);
 
     disp_timecode = pauseFrame.disp_timecode;
 }
@@ -1679,6 +1680,7 @@ void VideoOutputQuartz::ProcessFrame(VideoFrame *frame, OSD *osd,
     {
         frame = vbuffers.GetScratchFrame();
         CopyFrame(vbuffers.GetScratchFrame(), &pauseFrame);
+        vbuffers.CountCopy(pauseFrame.size);
     }
 
     if (filterList)
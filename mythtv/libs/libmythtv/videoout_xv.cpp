@@ -1423,39 +1423,16 @@ void VideoOutputXv::PrepareFrameMem(VideoFrame *buffer, FrameScanType /*scan*/)
 
     int out_width  = display_visible_rect.width()  & ~0x1;
     int out_height = display_visible_rect.height() & ~0x1;
-    unsigned char *sbuf = new unsigned char[out_width * out_height * 3 / 2];
     AVPicture image_in, image_out;
-    static struct SwsContext  *scontext;
 
-    avpicture_fill(&image_out, (uint8_t *)sbuf, PIX_FMT_YUV420P,
-                   out_width, out_height);
-
-    if ((out_width  == width) &&
-        (out_height == height))
-    {
-        memcpy(sbuf, buffer->buf, width * height * 3 / 2);
-    }
-    else
-    {
-        avpicture_fill(&image_in, buffer->buf, PIX_FMT_YUV420P,
-                       width, height);
-        scontext = sws_getCachedContext(scontext, width, height,
-                       PIX_FMT_YUV420P, out_width,
-                       out_height, PIX_FMT_YUV420P,
-                       SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-        sws_scale(scontext, image_in.data, image_in.linesize, 0, height,
-                  image_out.data, image_out.linesize);
-    }
-
-    avpicture_fill(&image_in, (uint8_t *)XJ_non_xv_image->data,
+    // Scale and convert in one pass, straight into the XImage
+    avpicture_fill(&image_in, buffer->buf, PIX_FMT_YUV420P, width, height);
+    avpicture_fill(&image_out, (uint8_t *)XJ_non_xv_image->data,
                    non_xv_av_format, out_width, out_height);
 
-
-    // XXX TODO: join with the scaling after removing img_convert, img_resample
-    myth_sws_img_convert(
-        &image_in, non_xv_av_format, &image_out, PIX_FMT_YUV420P,
-         out_width, out_height);
+    myth_sws_img_scale(
+        &image_out, non_xv_av_format, out_width, out_height,
+        &image_in, PIX_FMT_YUV420P, width, height);
 
     {
         QMutexLocker locker(&global_lock);
@@ -1468,8 +1445,6 @@ void VideoOutputXv::PrepareFrameMem(VideoFrame *buffer, FrameScanType /*scan*/)
                       0, 0, 0, 0, out_width, out_height);
         disp->Unlock();
     }
-
-    delete [] sbuf;
 }
 
 // this is documented in videooutbase.cpp
@@ -1761,7 +1736,10 @@ void VideoOutputXv::UpdatePauseFrame(int64_t &disp_timecode)
             used_frame = vbuffers.head(kVideoBuffer_used);
 
         if (used_frame)
+        {
             CopyFrame(&av_pause_frame, used_frame);
+            vbuffers.CountCopy(used_frame->size);
+        }
 
         vbuffers.end_lock();
 
@@ -1769,6 +1747,7 @@ void VideoOutputXv::UpdatePauseFrame(int64_t &disp_timecode)
         {
             vbuffers.GetScratchFrame()->frameNumber = framesPlayed - 1;
             CopyFrame(&av_pause_frame, vbuffers.GetScratchFrame());
+            vbuffers.CountCopy(av_pause_frame.size);
         }
 
         disp_timecode = av_pause_frame.disp_timecode;
@@ -1795,6 +1774,7 @@ void VideoOutputXv::ProcessFrame(VideoFrame *frame, OSD *osd,
         locks.push_back(frame);
         locks.push_back(&av_pause_frame);
         CopyFrame(frame, &av_pause_frame);
+        vbuffers.CountCopy(av_pause_frame.size);
         pauseframe = true;
     }
 
@@ -1349,6 +1349,7 @@ bool VideoOutput::DisplayOSD(VideoFrame *frame, OSD *osd)
         LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("OSD size changed."));
         osd_image->DownRef();
         osd_image = NULL;
+        osd_visible = QRegion();
     }
 
     if (!osd_image)
@@ -1383,14 +1384,36 @@ bool VideoOutput::DisplayOSD(VideoFrame *frame, OSD *osd)
     bool show       = !visible.isEmpty();
 
     if (!show)
+    {
+        osd_visible = QRegion();
+        osd_blend_rects.clear();
         return show;
+    }
 
     if (!changed && frame->codec != FMT_YV12)
         return show;
 
     QSize video_dim = window.GetVideoDim();
 
-    QVector<QRect> vis = visible.rects();
+    // YV12 frames are blended every frame, so only blend the parts of
+    // the OSD that have something in them, and only look for those
+    // parts again when the OSD has been redrawn.
+    if (FMT_YV12 == frame->codec && (changed || visible != osd_visible))
+    {
+        osd_visible = visible;
+        osd_blend_rects.clear();
+        QVector<QRect> rects = visible.rects();
+        for (int i = 0; i < rects.size(); i++)
+        {
+            QRect opaque = yuv888_opaque_rect(osd_image, rects[i],
+                                              ALIGN_X_MMX, ALIGN_C);
+            if (!opaque.isEmpty())
+                osd_blend_rects.push_back(opaque);
+        }
+    }
+
+    QVector<QRect> vis = (FMT_YV12 == frame->codec) ?
+        osd_blend_rects : visible.rects();
     for (int i = 0; i < vis.size(); i++)
     {
         int left   = min(vis[i].left(), osd_image->width());
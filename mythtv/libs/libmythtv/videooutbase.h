@@ -10,6 +10,8 @@ extern "C" {
 
 #include <QSize>
 #include <QRect>
+#include <QRegion>
+#include <QVector>
 #include <QString>
 #include <QPoint>
 #include <QMap>
@@ -167,6 +169,9 @@ class VideoOutput
         { return vbuffers.ValidVideoFrames(); }
     /// \brief Returns number of frames available for decoding onto.
     int FreeVideoFrames(void) { return vbuffers.FreeVideoFrames(); }
+    /// \brief Returns the longest wait for and hold of the frame buffer
+    ///        lock since the last call.
+    QString GetBufferLockStatus(void) { return vbuffers.GetLockStatus(); }
     /// \brief Returns true iff enough frames are available to decode onto.
     bool EnoughFreeFrames(void) { return vbuffers.EnoughFreeFrames(); }
     /// \brief Returns true iff there are plenty of decoded frames ready
@@ -202,6 +207,22 @@ class VideoOutput
     /// \brief Releases all frames not being actively displayed from any queue
     ///        onto the queue of frames ready for decoding onto.
     virtual void DiscardFrames(bool kf) { vbuffers.DiscardFrames(kf); }
+    /// \brief Keeps a frame from being decoded onto until
+    ///        UnshareFrame() is called, returns false if it can't.
+    bool ShareFrame(VideoFrame *frame) { return vbuffers.ShareFrame(frame); }
+    /// \brief Lets a frame passed to ShareFrame() be decoded onto again.
+    void UnshareFrame(VideoFrame *frame) { vbuffers.UnshareFrame(frame); }
+    /// \brief Counts bytes of frames copied, for the copy statistics.
+    void CountFrameCopy(uint bytes) { vbuffers.CountCopy(bytes); }
+    /// \brief Keeps a copy of a frame an exact seek decoded past.
+    void CacheGOPFrame(long long keyframe, const VideoFrame *frame)
+        { vbuffers.CacheGOPFrame(keyframe, frame); }
+    /// \brief Fills frame from the GOP cache, returns false if it isn't there.
+    bool GetGOPFrame(long long keyframe, long long frameNumber,
+                     VideoFrame *frame)
+        { return vbuffers.GetGOPFrame(keyframe, frameNumber, frame); }
+    /// \brief Frees the frames kept by CacheGOPFrame().
+    void ClearGOPCache(void) { vbuffers.ClearGOPCache(); }
     /// \brief Clears the frame to black. Subclasses may choose
     ///        to mark the frame as a dummy and act appropriately
     virtual void ClearDummyFrame(VideoFrame* frame);
@@ -345,6 +366,10 @@ class VideoOutput
     // OSD painter and surface
     MythYUVAPainter *osd_painter;
     MythImage       *osd_image;
+    /// Visible OSD region the blend rects were last worked out for
+    QRegion          osd_visible;
+    /// Parts of the visible OSD which aren't fully transparent
+    QVector<QRect>   osd_blend_rects;
 
     // Visualisation
     VideoVisual     *m_visual;
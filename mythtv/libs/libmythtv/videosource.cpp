@@ -124,7 +124,9 @@ void VideoSourceSelector::Load(void)
 class InstanceCount : public TransSpinBoxSetting
 {
   public:
-    InstanceCount(const CaptureCard &parent) : TransSpinBoxSetting(1, 5, 1)
+    InstanceCount(const CaptureCard &parent) :
+        TransSpinBoxSetting(0, kMaxMultirecCount, 1, false,
+                            QObject::tr("Automatic"))
     {
         setLabel(QObject::tr("Max recordings"));
         setHelpText(
@@ -132,10 +134,14 @@ class InstanceCount : public TransSpinBoxSetting
                 "Maximum number of simultaneous recordings this device "
                 "should make. Some digital transmitters transmit multiple "
                 "programs on a multiplex, if this is set to a value greater "
-                "than one MythTV can sometimes take advantage of this."));
+                "than one MythTV can sometimes take advantage of this. "
+                "Automatic allows as many recordings as the largest "
+                "multiplex has channels. It is updated when the backend "
+                "that owns the tuner starts, so after a channel rescan it "
+                "only takes effect once that backend has been restarted."));
         uint cnt = parent.GetInstanceCount();
         cnt = (!cnt) ? kDefaultMultirecCount : ((cnt < 1) ? 1 : cnt);
-        setValue(cnt);
+        setValue((parent.IsMultirecAuto()) ? 0 : cnt);
     };
 };
 
@@ -2310,7 +2316,7 @@ void CaptureCardGroup::triggerChanged(const QString& value)
 }
 
 CaptureCard::CaptureCard(bool use_card_group)
-    : id(new ID), instance_count(0)
+    : id(new ID), instance_count(0), multirec_auto(false)
 {
     addChild(id);
     if (use_card_group)
@@ -2368,6 +2374,7 @@ void CaptureCard::loadByID(int cardid)
 
     // Update instance count for cloned cards.
     uint new_cnt = 0;
+    bool new_auto = false;
     if (cardid > 0)
     {
         QString type = CardUtil::GetRawCardType(cardid);
@@ -2376,9 +2383,11 @@ void CaptureCard::loadByID(int cardid)
             QString dev = CardUtil::GetVideoDevice(cardid);
             vector<uint> cardids = CardUtil::GetCardIDs(dev, type);
             new_cnt = cardids.size();
+            new_auto = CardUtil::IsMultirecAuto(cardid);
         }
     }
     instance_count = new_cnt;
+    multirec_auto = new_auto;
 }
 
 void CaptureCard::Save(void)
@@ -2406,39 +2415,18 @@ void CaptureCard::Save(void)
     }
     vector<uint> cardids = CardUtil::GetCardIDs(init_dev, type);
 
-    if (!instance_count)
+    if (multirec_auto)
     {
-        instance_count = (init_cardid) ?
-            max((size_t)1, cardids.size()) : kDefaultMultirecCount;
+        instance_count = CardUtil::GetMultiplexCapacity(cardid);
     }
-    uint cloneCount = instance_count - 1;
-
-    if (!init_cardid)
-        init_cardid = cardid;
-
-    // Delete old clone cards as required.
-    for (uint i = cardids.size() - 1; (i > cloneCount) && cardids.size(); i--)
+    else if (!instance_count)
     {
-        CardUtil::DeleteCard(cardids.back());
-        cardids.pop_back();
-    }
-
-    // Make sure clones & original all share an input group
-    if (cloneCount && !CardUtil::CreateInputGroupIfNeeded(cardid))
-        return;
-
-    // Clone this config to existing clone cards.
-    for (uint i = 0; i < cardids.size(); i++)
-    {
-        if (cardids[i] != init_cardid)
-            CardUtil::CloneCard(init_cardid, cardids[i]);
+        instance_count = (init_cardid) ?
+            max((size_t)1, cardids.size()) : kDefaultMultirecCount;
     }
+    CardUtil::SetMultirecAuto(cardid, multirec_auto);
 
-    // Create new clone cards as required.
-    for (uint i = cardids.size(); i < cloneCount + 1; i++)
-    {
-        CardUtil::CloneCard(init_cardid, 0);
-    }
+    CardUtil::SetCloneCount(cardid, instance_count);
 }
 
 void CaptureCard::reload(void)
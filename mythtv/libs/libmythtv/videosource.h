@@ -629,11 +629,14 @@ public:
     virtual void Save(void);
 
     uint GetInstanceCount(void) const { return instance_count; }
+    bool IsMultirecAuto(void) const { return multirec_auto; }
 
 public slots:
-    void SetInstanceCount(uint cnt) { instance_count = cnt; }
+    /// A count of zero means follow the channels per multiplex.
+    void SetInstanceCount(uint cnt)
+        { instance_count = cnt; multirec_auto = !cnt; }
     // this is needed to connect valueChanged() signal from legacy settings
-    void SetInstanceCount(int cnt)  { instance_count = (uint)cnt; }
+    void SetInstanceCount(int cnt)  { SetInstanceCount((uint)cnt); }
 
 private:
 
@@ -657,6 +660,7 @@ private:
 private:
     ID       *id;
     uint      instance_count;
+    bool      multirec_auto;
 };
 
 class CardInputDBStorage : public SimpleDBStorage
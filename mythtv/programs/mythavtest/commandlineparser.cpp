@@ -50,5 +50,33 @@ void MythAVTestCommandLineParser::LoadArguments(void)
                     "The number of seconds to run the test (default 5).", "")
                     ->SetGroup("Video Performance Testing")
                     ->SetChildOf("test");
+    add("--nullvideo", "nullvideo", false,
+                    "Use the null video output, no display is needed.",
+                    "Decode and process frames as usual but do not display "
+                    "them, so the test can run headless on a build machine.")
+                    ->SetGroup("Video Performance Testing")
+                    ->SetChildOf("test");
+    add("--realtime", "realtime", false,
+                    "Show frames at the video frame rate.",
+                    "Show frames at the video frame rate instead of as fast "
+                    "as possible, counting the frames more than a frame "
+                    "interval late as dropped.")
+                    ->SetGroup("Video Performance Testing")
+                    ->SetChildOf("test");
+    add("--filters", "filters", "",
+                    "Video filter chain to run on every frame.",
+                    "Video filter chain to run on every frame, e.g. "
+                    "'yadifdeint,denoise3d'.")
+                    ->SetGroup("Video Performance Testing")
+                    ->SetChildOf("test");
+    add("--osd", "osd", false,
+                    "Blend a progress bar and subtitles into every frame.", "")
+                    ->SetGroup("Video Performance Testing")
+                    ->SetChildOf("test");
+    add("--results", "results", "",
+                    "Write the results as JSON to this file, '-' for stdout.",
+                    "")
+                    ->SetGroup("Video Performance Testing")
+                    ->SetChildOf("test");
 }
 
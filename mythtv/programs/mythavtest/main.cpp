@@ -1,4 +1,8 @@
 #include <unistd.h>
+#include <sys/time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 #include <iostream>
 
 using namespace std;
@@ -8,12 +12,19 @@ using namespace std;
 #include <QDir>
 #include <QApplication>
 #include <QTime>
+#include <QFile>
+#include <QThread>
+#include <QVector>
+#include <QPainter>
+#include <QImage>
 
 #include "tv_play.h"
 #include "programinfo.h"
 #include "commandlineparser.h"
 #include "mythplayer.h"
 #include "jitterometer.h"
+#include "filtermanager.h"
+#include "util-osd.h"
 
 #include "exitcodes.h"
 #include "mythcontext.h"
@@ -26,6 +37,33 @@ using namespace std;
 // libmythui
 #include "mythuihelper.h"
 #include "mythmainwindow.h"
+#include "mythpainter_yuva.h"
+
+/// Per frame timings and counters of a performance test run.
+typedef struct perfteststats
+{
+    uint64_t  frames;        ///< frames shown, or decoded with decodeonly
+    uint64_t  dropped;       ///< frames too late to show with realtime
+    uint64_t  wait_usecs;    ///< waiting for the decoder
+    uint64_t  filter_usecs;  ///< running the filter chain
+    uint64_t  osd_usecs;     ///< blending the OSD
+    uint64_t  output_usecs;  ///< video output process, prepare and show
+} PerfTestStats;
+
+static uint64_t perf_usecs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
+
+#ifndef _WIN32
+static uint64_t perf_cpu_usecs(const struct rusage &ru)
+{
+    return (uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000ULL +
+           ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+#endif
 
 class VideoPerformanceTest
 {
@@ -33,19 +71,36 @@ class VideoPerformanceTest
     VideoPerformanceTest(const QString &filename, bool novsync, bool onlydecode,
                          int runfor, bool deint)
       : file(filename), novideosync(novsync), decodeonly(onlydecode),
-        secondstorun(runfor), deinterlace(deint), ctx(NULL)
+        secondstorun(runfor), deinterlace(deint), nullvideo(false),
+        realtime(false), drawosd(false), ctx(NULL), filterchain(NULL),
+        osdimage(NULL)
     {
         if (secondstorun < 1)
             secondstorun = 1;
         if (secondstorun > 3600)
             secondstorun = 3600;
+        memset(&stats, 0, sizeof(stats));
     }
 
    ~VideoPerformanceTest()
     {
+        delete filterchain;
+        if (osdimage)
+            osdimage->DownRef();
         delete ctx;
     }
 
+    /// Use VideoOutputNull, so no display is needed.
+    void SetNullVideo(bool null)            { nullvideo = null; }
+    /// Show frames at the video frame rate instead of as fast as possible.
+    void SetRealTime(bool pace)             { realtime = pace; }
+    /// Run every frame through this filter chain.
+    void SetFilters(const QString &chain)   { filters = chain; }
+    /// Blend a progress bar and subtitles into every frame.
+    void SetDrawOSD(bool draw)              { drawosd = draw; }
+    /// Write the results as JSON to this file, "-" for stdout.
+    void SetResultsFile(const QString &name) { resultsfile = name; }
+
     void Test(void)
     {
         PIPMap dummy;
@@ -53,15 +108,20 @@ class VideoPerformanceTest
         if (novideosync) // TODO
             LOG(VB_GENERAL, LOG_INFO, "Will attempt to disable sync-to-vblank.");
 
+        PlayerFlags flags = kAudioMuted;
+        if (nullvideo)
+            flags = (PlayerFlags)(flags | kVideoIsNull);
+
         RingBuffer *rb  = RingBuffer::Create(file, false, true, 2000);
-        MythPlayer  *mp  = new MythPlayer(kAudioMuted);
+        MythPlayer  *mp  = new MythPlayer(flags);
         mp->GetAudio()->SetAudioInfo("NULL", "NULL", 0, 0);
         mp->GetAudio()->SetNoAudio();
         ctx = new PlayerContext("VideoPerformanceTest");
         ctx->SetRingBuffer(rb);
         ctx->SetPlayer(mp);
         ctx->SetPlayingInfo(new ProgramInfo(file));
-        mp->SetPlayerInfo(NULL, GetMythMainWindow(), true, ctx);
+        mp->SetPlayerInfo(NULL, (nullvideo) ? NULL : GetMythMainWindow(),
+                          true, ctx);
         FrameScanType scan = deinterlace ? kScan_Interlaced : kScan_Progressive;
         if (!mp->StartPlaying())
         {
@@ -89,6 +149,16 @@ class VideoPerformanceTest
 
         Jitterometer *jitter = new Jitterometer("Performance: ", mp->GetFrameRate());
 
+        double fps = mp->GetFrameRate();
+        uint64_t interval = (uint64_t)(1000000.0 / ((fps > 0.0) ? fps : 25.0));
+
+#ifndef _WIN32
+        struct rusage ru_start;
+        getrusage(RUSAGE_SELF, &ru_start);
+#endif
+        uint64_t start_usecs = perf_usecs();
+        uint64_t next_show   = start_usecs;
+
         int ms = secondstorun * 1000;
         QTime start = QTime::currentTime();
         while (1)
@@ -112,7 +182,10 @@ class VideoPerformanceTest
                 break;
             }
 
-            if (!mp->PrebufferEnoughFrames())
+            uint64_t t = perf_usecs();
+            bool ready = mp->PrebufferEnoughFrames();
+            stats.wait_usecs += perf_usecs() - t;
+            if (!ready)
                 continue;
 
             mp->SetBuffering(false);
@@ -120,25 +193,233 @@ class VideoPerformanceTest
             VideoFrame *frame = vo->GetLastShownFrame();
             mp->CheckAspectRatio(frame);
 
-            if (!decodeonly)
+            // Like the player, drop frames which are more than a frame late
+            bool drop = false;
+            if (realtime)
+            {
+                t = perf_usecs();
+                if (t < next_show)
+                    usleep(next_show - t);
+                else if (t > next_show + interval)
+                    drop = true;
+                next_show += interval;
+            }
+
+            if (drop)
+            {
+                stats.dropped++;
+            }
+            else
             {
-                vo->ProcessFrame(frame, NULL, NULL, dummy, scan);
-                vo->PrepareFrame(frame, scan, NULL);
-                vo->Show(scan);
+                ProcessFrame(frame, scan);
+
+                if (!decodeonly)
+                {
+                    t = perf_usecs();
+                    vo->ProcessFrame(frame, NULL, NULL, dummy, scan);
+                    vo->PrepareFrame(frame, scan, NULL);
+                    vo->Show(scan);
+                    stats.output_usecs += perf_usecs() - t;
+                }
+                stats.frames++;
             }
             vo->DoneDisplayingFrame(frame);
             jitter->RecordCycleTime();
         }
+
+        uint64_t elapsed = max(perf_usecs() - start_usecs, (uint64_t)1);
+        uint64_t cpu = 0;
+        long max_rss = 0;
+#ifndef _WIN32
+        struct rusage ru_end;
+        getrusage(RUSAGE_SELF, &ru_end);
+        cpu     = perf_cpu_usecs(ru_end) - perf_cpu_usecs(ru_start);
+        max_rss = ru_end.ru_maxrss;
+#endif
+
+        long long decoded = 0;
+        uint64_t decode_usecs = 0;
+        if (mp->GetDecoder())
+        {
+            decoded      = mp->GetDecoder()->GetFramesRead();
+            decode_usecs = mp->GetDecoder()->GetVideoDecodeTime();
+        }
+
+        ReportResults(elapsed, decoded, decode_usecs, cpu, max_rss);
+
+        delete jitter;
         LOG(VB_GENERAL, LOG_INFO, "-----------------------------------");
     }
 
   private:
+    /// Applies the filter chain and the OSD, if they were asked for.
+    void ProcessFrame(VideoFrame *frame, FrameScanType scan)
+    {
+        if ((filters.isEmpty() && !drawosd) || frame->codec != FMT_YV12)
+            return;
+
+        if (!filters.isEmpty() && !filterchain)
+        {
+            VideoFrameType inpixfmt  = FMT_YV12;
+            VideoFrameType outpixfmt = FMT_YV12;
+            int width   = frame->width;
+            int height  = frame->height;
+            int bufsize = 0;
+            filterchain = filtermanager.LoadFilters(
+                filters, inpixfmt, outpixfmt, width, height, bufsize,
+                QThread::idealThreadCount());
+            if (!filterchain)
+            {
+                LOG(VB_GENERAL, LOG_ERR, QString("Could not load filters "
+                                                 "'%1'").arg(filters));
+                filters.clear();
+            }
+        }
+
+        if (filterchain)
+        {
+            uint64_t t = perf_usecs();
+            filterchain->ProcessFrame(frame, scan);
+            stats.filter_usecs += perf_usecs() - t;
+        }
+
+        if (drawosd)
+        {
+            if (!osdimage)
+                CreateOSD(frame->width, frame->height);
+
+            uint64_t t = perf_usecs();
+            for (int i = 0; i < osdrects.size(); i++)
+            {
+                const QRect &r = osdrects[i];
+                yuv888_to_yv12(frame, osdimage, r.left(), r.top(),
+                               r.left() + r.width(), r.top() + r.height());
+            }
+            stats.osd_usecs += perf_usecs() - t;
+        }
+    }
+
+    /// Draws a translucent progress bar and two lines of subtitle sized
+    /// blocks, the OSD a viewer usually has on screen. No text is drawn
+    /// so no fonts are needed.
+    void CreateOSD(int width, int height)
+    {
+        QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+        image.fill(0);
+
+        QRect progress(width / 12, height / 27, width * 5 / 6, height / 9);
+        QRect subtitles(0, height * 5 / 6, width, height / 8);
+        {
+            QPainter painter(&image);
+            painter.fillRect(progress, QColor(0, 0, 64, 160));
+            int line = subtitles.height() / 3;
+            for (int row = 0; row < 2; row++)
+            {
+                int y = subtitles.top() + line / 4 + row * (line + line / 4);
+                for (int x = width / 4; x < width * 3 / 4; x += line / 2)
+                    painter.fillRect(x, y, line * 3 / 8, line, Qt::white);
+            }
+        }
+
+        osdimage = yuvapainter.GetFormatImage();
+        osdimage->Assign(image);
+        osdimage->ConvertToYUV();
+
+        QRect rect = yuv888_opaque_rect(osdimage, progress,
+                                        ALIGN_X_MMX, ALIGN_C);
+        if (!rect.isEmpty())
+            osdrects << rect;
+        rect = yuv888_opaque_rect(osdimage, subtitles, ALIGN_X_MMX, ALIGN_C);
+        if (!rect.isEmpty())
+            osdrects << rect;
+    }
+
+    void ReportResults(uint64_t elapsed, long long decoded,
+                       uint64_t decode_usecs, uint64_t cpu, long max_rss)
+    {
+        double secs   = elapsed / 1000000.0;
+        double frames = (double) max(stats.frames, (uint64_t)1);
+        double dec    = (double) max(decoded, 1LL);
+
+        QString res = QString(
+            "{\n"
+            "  \"file\": \"%1\",\n"
+            "  \"seconds\": %2,\n"
+            "  \"frames\": %3,\n"
+            "  \"dropped\": %4,\n"
+            "  \"fps\": %5,\n"
+            "  \"decoded\": %6,\n"
+            "  \"decode_fps\": %7,\n")
+            .arg(QString(file).replace("\\", "\\\\").replace("\"", "\\\""))
+            .arg(secs, 0, 'f', 3)
+            .arg(stats.frames).arg(stats.dropped)
+            .arg(stats.frames / secs, 0, 'f', 2)
+            .arg(decoded)
+            .arg(decoded / secs, 0, 'f', 2);
+        res += QString(
+            "  \"ms_per_frame\": {\n"
+            "    \"decode\": %1,\n"
+            "    \"wait\": %2,\n"
+            "    \"filter\": %3,\n"
+            "    \"osd\": %4,\n"
+            "    \"output\": %5\n"
+            "  },\n"
+            "  \"cpu_percent\": %6,\n"
+            "  \"max_rss_kb\": %7\n"
+            "}\n")
+            .arg(decode_usecs / dec / 1000.0, 0, 'f', 3)
+            .arg(stats.wait_usecs / frames / 1000.0, 0, 'f', 3)
+            .arg(stats.filter_usecs / frames / 1000.0, 0, 'f', 3)
+            .arg(stats.osd_usecs / frames / 1000.0, 0, 'f', 3)
+            .arg(stats.output_usecs / frames / 1000.0, 0, 'f', 3)
+            .arg(cpu * 100.0 / elapsed, 0, 'f', 1)
+            .arg(max_rss);
+
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Showed %1 frames (%2 dropped) at %3 fps, decoded %4 "
+                    "frames at %5 fps, %6% CPU")
+                .arg(stats.frames).arg(stats.dropped)
+                .arg(stats.frames / secs, 0, 'f', 2)
+                .arg(decoded).arg(decoded / secs, 0, 'f', 2)
+                .arg(cpu * 100.0 / elapsed, 0, 'f', 1));
+
+        if (resultsfile.isEmpty())
+            return;
+
+        if (resultsfile == "-")
+        {
+            cout << res.toLocal8Bit().constData() << flush;
+            return;
+        }
+
+        QFile f(resultsfile);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            LOG(VB_GENERAL, LOG_ERR, QString("Could not write results to "
+                                             "'%1'").arg(resultsfile));
+            return;
+        }
+        f.write(res.toUtf8());
+    }
+
     QString file;
     bool    novideosync;
     bool    decodeonly;
     int     secondstorun;
     bool    deinterlace;
+    bool    nullvideo;
+    bool    realtime;
+    bool    drawosd;
+    QString filters;
+    QString resultsfile;
     PlayerContext *ctx;
+
+    FilterManager    filtermanager;
+    FilterChain     *filterchain;
+    MythYUVAPainter  yuvapainter;
+    MythImage       *osdimage;
+    QVector<QRect>   osdrects;
+    PerfTestStats    stats;
 };
 
 int main(int argc, char *argv[])
@@ -162,7 +443,10 @@ int main(int argc, char *argv[])
         return GENERIC_EXIT_OK;
     }
 
-    QApplication a(argc, argv);
+    // A benchmark on the null video output needs no display at all
+    bool headless = cmdline.toBool("test") && cmdline.toBool("nullvideo");
+
+    QApplication a(argc, argv, !headless);
     QCoreApplication::setApplicationName(MYTH_APPNAME_MYTHAVTEST);
 
     int retval;
@@ -186,7 +470,7 @@ int main(int argc, char *argv[])
         filename = cmdline.GetArgs()[0];
 
     gContext = new MythContext(MYTH_BINARY_VERSION);
-    if (!gContext->Init())
+    if (!gContext->Init(!headless))
     {
         LOG(VB_GENERAL, LOG_ERR, "Failed to init MythContext, exiting.");
         return GENERIC_EXIT_NO_MYTHCONTEXT;
@@ -196,32 +480,35 @@ int main(int argc, char *argv[])
 
     setuid(getuid());
 
-    QString themename = gCoreContext->GetSetting("Theme");
-    QString themedir = GetMythUI()->FindThemeDir(themename);
-    if (themedir.isEmpty())
+    if (!headless)
     {
-        QString msg = QString("Fatal Error: Couldn't find theme '%1'.")
-            .arg(themename);
-        LOG(VB_GENERAL, LOG_ERR, msg);
-        return GENERIC_EXIT_NO_THEME;
-    }
+        QString themename = gCoreContext->GetSetting("Theme");
+        QString themedir = GetMythUI()->FindThemeDir(themename);
+        if (themedir.isEmpty())
+        {
+            QString msg = QString("Fatal Error: Couldn't find theme '%1'.")
+                .arg(themename);
+            LOG(VB_GENERAL, LOG_ERR, msg);
+            return GENERIC_EXIT_NO_THEME;
+        }
 
-    GetMythUI()->LoadQtConfig();
+        GetMythUI()->LoadQtConfig();
 
 #if defined(Q_OS_MACX)
-    // Mac OS X doesn't define the AudioOutputDevice setting
+        // Mac OS X doesn't define the AudioOutputDevice setting
 #else
-    QString auddevice = gCoreContext->GetSetting("AudioOutputDevice");
-    if (auddevice.isEmpty())
-    {
-        LOG(VB_GENERAL, LOG_ERR, "Fatal Error: Audio not configured, you need "
-                                 "to run 'mythfrontend', not 'mythtv'.");
-        return GENERIC_EXIT_SETUP_ERROR;
-    }
+        QString auddevice = gCoreContext->GetSetting("AudioOutputDevice");
+        if (auddevice.isEmpty())
+        {
+            LOG(VB_GENERAL, LOG_ERR, "Fatal Error: Audio not configured, you "
+                                     "need to run 'mythfrontend', not 'mythtv'.");
+            return GENERIC_EXIT_SETUP_ERROR;
+        }
 #endif
 
-    MythMainWindow *mainWindow = GetMythMainWindow();
-    mainWindow->Init();
+        MythMainWindow *mainWindow = GetMythMainWindow();
+        mainWindow->Init();
+    }
 
     if (cmdline.toBool("test"))
     {
@@ -231,6 +518,11 @@ int main(int argc, char *argv[])
         VideoPerformanceTest *test = new VideoPerformanceTest(filename, false,
                     cmdline.toBool("decodeonly"), seconds,
                     cmdline.toBool("deinterlace"));
+        test->SetNullVideo(headless);
+        test->SetRealTime(cmdline.toBool("realtime"));
+        test->SetFilters(cmdline.toString("filters"));
+        test->SetDrawOSD(cmdline.toBool("osd"));
+        test->SetResultsFile(cmdline.toString("results"));
         test->Test();
         delete test;
     }
@@ -255,7 +547,8 @@ int main(int argc, char *argv[])
             TV::StartTV(&pginfo, kStartTVNoFlags);
         }
     }
-    DestroyMythMainWindow();
+    if (!headless)
+        DestroyMythMainWindow();
 
     delete gContext;
 
@@ -38,6 +38,8 @@
 #include "mythsystem.h"
 #include "exitcodes.h"
 #include "jobqueue.h"
+#include "eithelper.h"
+#include "eitcache.h"
 #include "upnp.h"
 #include <util.h>
 
@@ -561,6 +563,29 @@ void HttpStatus::FillStatusXML( QDomDocument *pDoc )
         pDoc->createTextNode(gCoreContext->GetSetting("DataDirectMessage"));
     guide.appendChild(dataDirectMessage);
 
+    // EIT cache ---------------------
+
+    EITCacheStats eitStats = EITHelper::GetCacheStats();
+
+    QDomElement eitcache = pDoc->createElement("EITCache");
+    mInfo.appendChild(eitcache);
+
+    eitcache.setAttribute("accesses", eitStats.accesses);
+    eitcache.setAttribute("hits",     eitStats.hits);
+    eitcache.setAttribute("hitRatio", eitStats.HitRatio());
+    eitcache.setAttribute("entries",  eitStats.entries);
+    eitcache.setAttribute("bytes",    (qulonglong)eitStats.bytes);
+
+    EITWriterStats writerStats = EITHelper::GetWriterStats();
+
+    QDomElement eitwriter = pDoc->createElement("EITWriter");
+    mInfo.appendChild(eitwriter);
+
+    eitwriter.setAttribute("queued",  writerStats.queued);
+    eitwriter.setAttribute("written", (qulonglong)writerStats.written);
+    eitwriter.setAttribute("batches", writerStats.batches);
+    eitwriter.setAttribute("eventsPerSecond", writerStats.EventsPerSecond());
+
     // Add Miscellaneous information
 
     QString info_script = gCoreContext->GetSetting("MiscStatusScript");
@@ -1450,6 +1475,47 @@ int HttpStatus::PrintMachineInfo( QTextStream &os, QDomElement info )
                 os << "<br />\r\n    DataDirect Status: " << sMsg;
         }
     }
+
+    // EIT cache ---------------------
+
+    node = info.namedItem( "EITCache" );
+
+    if (!node.isNull())
+    {
+        QDomElement e = node.toElement();
+
+        if (!e.isNull() && e.attribute( "accesses", "0" ).toUInt())
+        {
+            uint   nEntries  = e.attribute( "entries" , "0" ).toUInt();
+            double dHitRatio = e.attribute( "hitRatio", "0" ).toDouble();
+            qulonglong nBytes = e.attribute( "bytes"  , "0" ).toULongLong();
+
+            os << "<br />\r\n    The EIT cache holds " << nEntries
+               << " events in " << (nBytes >> 10) << " kB, "
+               << QString::number(dHitRatio * 100.0, 'f', 1)
+               << "% of EIT events were already known.";
+        }
+    }
+
+    node = info.namedItem( "EITWriter" );
+
+    if (!node.isNull())
+    {
+        QDomElement e = node.toElement();
+
+        if (!e.isNull() && e.attribute( "written", "0" ).toULongLong())
+        {
+            qulonglong nWritten = e.attribute( "written", "0" ).toULongLong();
+            uint   nQueued = e.attribute( "queued", "0" ).toUInt();
+            double dRate   = e.attribute( "eventsPerSecond", "0" ).toDouble();
+
+            os << "<br />\r\n    " << nWritten << " EIT events have been "
+               << "written at " << QString::number(dRate, 'f', 1)
+               << " events per second, " << nQueued
+               << " are waiting to be written.";
+        }
+    }
+
     os << "\r\n  </div>\r\n";
 
     return( 1 );
@@ -24,6 +24,7 @@
 #include <QMap>
 
 #include "tv_rec.h"
+#include "cardutil.h"
 #include "scheduledrecording.h"
 #include "mythsocketthread.h"
 #include "autoexpire.h"
@@ -118,6 +119,9 @@ bool setupTVs(bool ismaster, bool &error)
         }
     }
 
+    // Follow channel scans on cards whose recorder count is automatic
+    CardUtil::UpdateAutoMultirecCounts(localhostname);
+
     if (!query.exec(
             "SELECT cardid, hostname "
             "FROM capturecard "
@@ -39,6 +39,7 @@ using namespace std;
 #include <QNetworkProxy>
 
 #include "previewgeneratorqueue.h"
+#include "trickplaygenerator.h"
 #include "exitcodes.h"
 #include "mythcontext.h"
 #include "mythversion.h"
@@ -221,8 +222,11 @@ MainServer::MainServer(bool master, int port,
     autoexpireUpdateTimer(NULL), m_exitCode(GENERIC_EXIT_OK),
     m_stopped(false)
 {
+    uint previewMode = PreviewGenerator::kLocalAndRemote;
+    if (gCoreContext->GetNumSetting("PreviewGeneratorInProcess", 0))
+        previewMode |= PreviewGenerator::kInProcess;
     PreviewGeneratorQueue::CreatePreviewGeneratorQueue(
-        PreviewGenerator::kLocalAndRemote, ~0, 0);
+        (PreviewGenerator::Mode) previewMode, ~0, 0);
     PreviewGeneratorQueue::AddListener(this);
 
     threadPool.setMaxThreadCount(PRT_STARTUP_THREAD_COUNT);
@@ -1995,6 +1999,12 @@ void MainServer::DoDeleteThread(DeleteStruct *ds)
         delete_file_immediately( sFileName, followLinks, true);
     }
 
+    /* Delete the trickplay index. */
+
+    QString trickplayFile = TrickplayGenerator::GetFilename(ds->m_filename);
+    if (QFile::exists(trickplayFile))
+        delete_file_immediately(trickplayFile, followLinks, true);
+
     DeleteRecordedFiles(ds);
 
     DoDeleteInDB(ds);
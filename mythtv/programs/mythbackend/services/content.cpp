@@ -31,6 +31,7 @@
 #include "storagegroup.h"
 #include "programinfo.h"
 #include "previewgenerator.h"
+#include "trickplaygenerator.h"
 #include "backendutil.h"
 #include "httprequest.h"
 #include "serviceUtil.h"
@@ -620,6 +621,50 @@ QFileInfo Content::GetRecording( int              nChanId,
     return QFileInfo();
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Returns the trickplay index built by the JOB_TRICKPLAY job, see
+// TrickplayGenerator for the file layout.
+/////////////////////////////////////////////////////////////////////////////
+
+QFileInfo Content::GetTrickplayIndex( int              nChanId,
+                                      const QDateTime &dtStartTime )
+{
+    if (!dtStartTime.isValid())
+        throw( "StartTime is invalid" );
+
+    ProgramInfo pginfo( (uint)nChanId, dtStartTime );
+
+    if (!pginfo.GetChanID())
+    {
+        LOG( VB_UPNP, LOG_ERR, QString("GetTrickplayIndex - for %1, %2 failed")
+                                    .arg( nChanId )
+                                    .arg( dtStartTime.toString() ));
+        return QFileInfo();
+    }
+
+    if ( pginfo.GetHostname().toLower() != gCoreContext->GetHostName().toLower())
+    {
+        // We only handle requests for local resources
+
+        QString sMsg =
+            QString("GetTrickplayIndex: Wrong Host '%1' request from '%2'.")
+                          .arg( gCoreContext->GetHostName())
+                          .arg( pginfo.GetHostname() );
+
+        LOG(VB_UPNP, LOG_ERR, sMsg);
+
+        throw HttpRedirectException( pginfo.GetHostname() );
+    }
+
+    QString sFileName =
+        TrickplayGenerator::GetFilename( GetPlaybackURL(&pginfo) );
+
+    if (QFile::exists( sFileName ))
+        return QFileInfo( sFileName );
+
+    return QFileInfo();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -72,6 +72,9 @@ class Content : public ContentServices
         QFileInfo           GetRecording        ( int              ChanId,
                                                   const QDateTime &StartTime );
 
+        QFileInfo           GetTrickplayIndex   ( int              ChanId,
+                                                  const QDateTime &StartTime );
+
         QFileInfo           GetMusic            ( int Id );
         QFileInfo           GetVideo            ( int Id );
 
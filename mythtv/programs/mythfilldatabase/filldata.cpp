@@ -13,6 +13,7 @@ using namespace std;
 #include <QTextStream>
 #include <QDateTime>
 #include <QFile>
+#include <QTime>
 #include <QList>
 #include <QMap>
 #include <QDir>
@@ -37,6 +38,9 @@ using namespace std;
 #define LOC_WARN QString("FillData, Warning: ")
 #define LOC_ERR QString("FillData, Error: ")
 
+/// Programmes read from an XMLTV file before they are put in the database.
+static const uint kXMLTVBatchSize = 5000;
+
 bool updateLastRunEnd(MSqlQuery &query)
 {
     QDateTime qdtNow = QDateTime::currentDateTime();
@@ -328,21 +332,69 @@ bool FillData::GrabDataFromFile(int id, QString &filename)
 {
     QList<ChanInfo> chanlist;
     QMap<QString, QList<ProgInfo> > proglist;
+    ProgramUpdateStats stats;
+    uint programs = 0;
+    int  parse_ms = 0, channel_ms = 0, program_ms = 0;
+    bool first = true;
 
-    if (!xmltv_parser.parseFile(filename, &chanlist, &proglist))
+    if (!xmltv_parser.openFile(filename))
         return false;
 
-    chan_data.handleChannels(id, &chanlist);
-    icon_data.UpdateSourceIcons(id);
-    if (proglist.count() == 0)
+    QTime timer;
+    timer.start();
+
+    while (xmltv_parser.parseBatch(&chanlist, &proglist, kXMLTVBatchSize))
+    {
+        parse_ms += timer.restart();
+
+        if (first || !chanlist.empty())
+        {
+            chan_data.handleChannels(id, &chanlist);
+            icon_data.UpdateSourceIcons(id);
+            chanlist.clear();
+            channel_ms += timer.restart();
+            first = false;
+        }
+
+        if (proglist.empty())
+            continue;
+
+        QMap<QString, QList<ProgInfo> >::const_iterator it = proglist.begin();
+        for (; it != proglist.end(); ++it)
+            programs += (*it).size();
+
+        prog_data.HandlePrograms(id, proglist, stats);
+        proglist.clear();
+        program_ms += timer.restart();
+    }
+
+    if (!programs)
     {
         LOG(VB_GENERAL, LOG_INFO, "No programs found in data.");
         endofdata = true;
     }
     else
     {
-        prog_data.HandlePrograms(id, proglist);
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Updated programs: %1 Unchanged programs: %2 "
+                    "Removed programs: %3 Rows touched: %4")
+                    .arg(stats.updated).arg(stats.unchanged)
+                    .arg(stats.removed).arg(stats.updated + stats.removed));
+    }
+
+    if (stats.changedFrom.isValid())
+    {
+        LOG(VB_GENERAL, LOG_INFO, QString("Programs changed from %1 to %2")
+            .arg(stats.changedFrom.toString(Qt::ISODate))
+            .arg(stats.changedTo.toString(Qt::ISODate)));
     }
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Read %1 programs in %2 seconds, channel updates took %3 "
+                "seconds, program updates took %4 seconds")
+            .arg(programs).arg(parse_ms * 0.001)
+            .arg(channel_ms * 0.001).arg(program_ms * 0.001));
+
     return true;
 }
 
@@ -4,8 +4,8 @@
 #include <QFile>
 #include <QStringList>
 #include <QDateTime>
-#include <QDomDocument>
 #include <QUrl>
+#include <QtAlgorithms>
 
 // C++ headers
 #include <iostream>
@@ -25,7 +25,11 @@
 #include "channeldata.h"
 #include "fillutil.h"
 
-XMLTVParser::XMLTVParser() : isJapan(false), current_year(0)
+/// Most programmes kept back per channel between batches.
+static const int kMaxKeptBack = 16;
+
+XMLTVParser::XMLTVParser() :
+    isJapan(false), current_year(0), tz_offset(841)
 {
     current_year = QDate::currentDate().toString("yyyy").toUInt();
 }
@@ -48,65 +52,61 @@ static unsigned int ELFHash(const char *s)
     return (int)h;
 }
 
-static QString getFirstText(QDomElement element)
+/// Returns the text of the current element and moves past its end.
+static QString getText(QXmlStreamReader &xml)
 {
-    for (QDomNode dname = element.firstChild(); !dname.isNull();
-         dname = dname.nextSibling())
-    {
-        QDomText t = dname.toText();
-        if (!t.isNull())
-            return t.data();
-    }
-    return QString();
+    return xml.readElementText(QXmlStreamReader::SkipChildElements);
 }
 
-ChanInfo *XMLTVParser::parseChannel(QDomElement &element, QUrl &baseUrl)
+ChanInfo *XMLTVParser::parseChannel(QXmlStreamReader &xml, QUrl &baseUrl)
 {
     ChanInfo *chaninfo = new ChanInfo;
 
-    QString xmltvid = element.attribute("id", "");
-    QStringList split = xmltvid.simplified().split(" ");
+    QString xmltvid = xml.attributes().value("id").toString();
 
     chaninfo->xmltvid = xmltvid;
     chaninfo->tvformat = "Default";
 
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        QString tag = xml.name().toString();
+        if (tag == "icon")
         {
-            if (info.tagName() == "icon")
+            QString path = xml.attributes().value("src").toString();
+            if (!path.isEmpty() && !path.contains("://"))
             {
-                QString path = info.attribute("src", "");
-                if (!path.isEmpty() && !path.contains("://"))
-                {
-                    QString base = baseUrl.toString(QUrl::StripTrailingSlash);
-                    chaninfo->iconpath = base +
-                        ((path.left(1) == "/") ? path : QString("/") + path);
-                }
-                else if (!path.isEmpty())
-                {
-                    QUrl url(path);
-                    if (url.isValid())
-                        chaninfo->iconpath = url.toString();
-                }
+                QString base = baseUrl.toString(QUrl::StripTrailingSlash);
+                chaninfo->iconpath = base +
+                    ((path.left(1) == "/") ? path : QString("/") + path);
             }
-            else if (info.tagName() == "display-name")
+            else if (!path.isEmpty())
             {
-                if (chaninfo->name.isEmpty())
-                {
-                    chaninfo->name = info.text();
-                }
-                else if (isJapan && chaninfo->callsign.isEmpty())
-                {
-                    chaninfo->callsign = info.text();
-                }
-                else if (chaninfo->chanstr.isEmpty())
-                {
-                    chaninfo->chanstr = info.text();
-                }
+                QUrl url(path);
+                if (url.isValid())
+                    chaninfo->iconpath = url.toString();
             }
+            xml.skipCurrentElement();
+        }
+        else if (tag == "display-name")
+        {
+            QString text =
+                xml.readElementText(QXmlStreamReader::IncludeChildElements);
+            if (chaninfo->name.isEmpty())
+            {
+                chaninfo->name = text;
+            }
+            else if (isJapan && chaninfo->callsign.isEmpty())
+            {
+                chaninfo->callsign = text;
+            }
+            else if (chaninfo->chanstr.isEmpty())
+            {
+                chaninfo->chanstr = text;
+            }
+        }
+        else
+        {
+            xml.skipCurrentElement();
         }
     }
 
@@ -216,92 +216,113 @@ static void fromXMLTVDate(QString &timestr, QDateTime &dt, int localTimezoneOffs
     timestr = dt.toString("yyyyMMddhhmmss");
 }
 
-static void parseCredits(QDomElement &element, ProgInfo *pginfo)
+static void parseCredits(QXmlStreamReader &xml, ProgInfo *pginfo)
+{
+    while (xml.readNextStartElement())
+    {
+        QString role = xml.name().toString();
+        pginfo->AddPerson(role, getText(xml));
+    }
+}
+
+static void parseVideo(QXmlStreamReader &xml, ProgInfo *pginfo)
 {
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
-            pginfo->AddPerson(info.tagName(), getFirstText(info));
+        if (xml.name() == QLatin1String("quality"))
+        {
+            if (getText(xml) == "HDTV")
+                pginfo->videoProps |= VID_HDTV;
+        }
+        else if (xml.name() == QLatin1String("aspect"))
+        {
+            if (getText(xml) == "16:9")
+                pginfo->videoProps |= VID_WIDESCREEN;
+        }
+        else
+        {
+            xml.skipCurrentElement();
+        }
     }
 }
 
-static void parseVideo(QDomElement &element, ProgInfo *pginfo)
+static void parseAudio(QXmlStreamReader &xml, ProgInfo *pginfo)
 {
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        if (xml.name() == QLatin1String("stereo"))
         {
-            if (info.tagName() == "quality")
+            QString text = getText(xml);
+            if (text == "mono")
+            {
+                pginfo->audioProps |= AUD_MONO;
+            }
+            else if (text == "stereo")
             {
-                if (getFirstText(info) == "HDTV")
-                    pginfo->videoProps |= VID_HDTV;
+                pginfo->audioProps |= AUD_STEREO;
             }
-            else if (info.tagName() == "aspect")
+            else if (text == "dolby" || text == "dolby digital")
             {
-                if (getFirstText(info) == "16:9")
-                    pginfo->videoProps |= VID_WIDESCREEN;
+                pginfo->audioProps |= AUD_DOLBY;
+            }
+            else if (text == "surround")
+            {
+                pginfo->audioProps |= AUD_SURROUND;
             }
         }
+        else
+        {
+            xml.skipCurrentElement();
+        }
     }
 }
 
-static void parseAudio(QDomElement &element, ProgInfo *pginfo)
+/// Returns the text of the first \<value\> child and moves past the end
+/// of the current element.
+static QString getFirstValue(QXmlStreamReader &xml)
 {
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    QString value;
+    bool found = false;
+
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        if (!found && xml.name() == QLatin1String("value"))
         {
-            if (info.tagName() == "stereo")
-            {
-                if (getFirstText(info) == "mono")
-                {
-                    pginfo->audioProps |= AUD_MONO;
-                }
-                else if (getFirstText(info) == "stereo")
-                {
-                    pginfo->audioProps |= AUD_STEREO;
-                }
-                else if (getFirstText(info) == "dolby" ||
-                        getFirstText(info) == "dolby digital")
-                {
-                    pginfo->audioProps |= AUD_DOLBY;
-                }
-                else if (getFirstText(info) == "surround")
-                {
-                    pginfo->audioProps |= AUD_SURROUND;
-                }
-            }
+            value = getText(xml);
+            found = true;
+        }
+        else
+        {
+            xml.skipCurrentElement();
         }
     }
+
+    return value;
 }
 
 ProgInfo *XMLTVParser::parseProgram(
-    QDomElement &element, int localTimezoneOffset)
+    QXmlStreamReader &xml, int localTimezoneOffset)
 {
     QString uniqueid, season, episode;
     int dd_progid_done = 0;
     ProgInfo *pginfo = new ProgInfo();
 
-    QString text = element.attribute("start", "");
+    QXmlStreamAttributes attrs = xml.attributes();
+
+    QString text = attrs.value("start").toString();
     fromXMLTVDate(text, pginfo->starttime, localTimezoneOffset);
     pginfo->startts = text;
 
-    text = element.attribute("stop", "");
+    text = attrs.value("stop").toString();
     fromXMLTVDate(text, pginfo->endtime, localTimezoneOffset);
     pginfo->endts = text;
 
-    text = element.attribute("channel", "");
+    text = attrs.value("channel").toString();
     QStringList split = text.split(" ");
 
     pginfo->channel = split[0];
 
-    text = element.attribute("clumpidx", "");
+    text = attrs.value("clumpidx").toString();
     if (!text.isEmpty())
     {
         split = text.split('/');
@@ -309,205 +330,210 @@ ProgInfo *XMLTVParser::parseProgram(
         pginfo->clumpmax = split[1];
     }
 
-    for (QDomNode child = element.firstChild(); !child.isNull();
-         child = child.nextSibling())
+    while (xml.readNextStartElement())
     {
-        QDomElement info = child.toElement();
-        if (!info.isNull())
+        QString tag = xml.name().toString();
+        QXmlStreamAttributes info = xml.attributes();
+
+        if (tag == "title")
         {
-            if (info.tagName() == "title")
+            if (isJapan)
             {
-                if (isJapan)
+                if (info.value("lang") == QLatin1String("ja_JP"))
                 {
-                    if (info.attribute("lang") == "ja_JP")
-                    {
-                        pginfo->title = getFirstText(info);
-                    }
-                    else if (info.attribute("lang") == "ja_JP@kana")
-                    {
-                        pginfo->title_pronounce = getFirstText(info);
-                    }
+                    pginfo->title = getText(xml);
                 }
-                else if (pginfo->title.isEmpty())
+                else if (info.value("lang") == QLatin1String("ja_JP@kana"))
                 {
-                    pginfo->title = getFirstText(info);
+                    pginfo->title_pronounce = getText(xml);
                 }
-            }
-            else if (info.tagName() == "sub-title" &&
-                     pginfo->subtitle.isEmpty())
-            {
-                pginfo->subtitle = getFirstText(info);
-            }
-            else if (info.tagName() == "desc" && pginfo->description.isEmpty())
-            {
-                pginfo->description = getFirstText(info);
-            }
-            else if (info.tagName() == "category")
-            {
-                const QString cat = getFirstText(info).toLower();
-
-                if (kCategoryNone == pginfo->categoryType &&
-                    string_to_myth_category_type(cat) != kCategoryNone)
-                {
-                    pginfo->categoryType = string_to_myth_category_type(cat);
-                }
-                else if (pginfo->category.isEmpty())
-                {
-                    pginfo->category = cat;
-                }
-
-                if (cat == "film")
+                else
                 {
-                    // Hack for tv_grab_uk_rt
-                    pginfo->categoryType = kCategoryMovie;
+                    xml.skipCurrentElement();
                 }
             }
-            else if (info.tagName() == "date" && !pginfo->airdate)
+            else if (pginfo->title.isEmpty())
             {
-                // Movie production year
-                QString date = getFirstText(info);
-                pginfo->airdate = date.left(4).toUInt();
+                pginfo->title = getText(xml);
             }
-            else if (info.tagName() == "star-rating" && pginfo->stars.isEmpty())
+            else
             {
-                QDomNodeList values = info.elementsByTagName("value");
-                QDomElement item;
-                QString stars, num, den;
-                float rating = 0.0;
-
-                // Use the first rating to appear in the xml, this should be
-                // the most important one.
-                //
-                // Averaging is not a good idea here, any subsequent ratings
-                // are likely to represent that days recommended programmes
-                // which on a bad night could given to an average programme.
-                // In the case of uk_rt it's not unknown for a recommendation
-                // to be given to programmes which are 'so bad, you have to
-                // watch!'
-                item = values.item(0).toElement();
-                if (!item.isNull())
-                {
-                    stars = getFirstText(item);
-                    num = stars.section('/', 0, 0);
-                    den = stars.section('/', 1, 1);
-                    if (0.0 < den.toFloat())
-                        rating = num.toFloat()/den.toFloat();
-                }
-
-                pginfo->stars.setNum(rating);
+                xml.skipCurrentElement();
             }
-            else if (info.tagName() == "rating")
+        }
+        else if (tag == "sub-title" && pginfo->subtitle.isEmpty())
+        {
+            pginfo->subtitle = getText(xml);
+        }
+        else if (tag == "desc" && pginfo->description.isEmpty())
+        {
+            pginfo->description = getText(xml);
+        }
+        else if (tag == "category")
+        {
+            const QString cat = getText(xml).toLower();
+
+            if (kCategoryNone == pginfo->categoryType &&
+                string_to_myth_category_type(cat) != kCategoryNone)
             {
-                // again, the structure of ratings seems poorly represented
-                // in the XML.  no idea what we'd do with multiple values.
-                QDomNodeList values = info.elementsByTagName("value");
-                QDomElement item = values.item(0).toElement();
-                if (item.isNull())
-                    continue;
-                EventRating rating;
-                rating.system = info.attribute("system", "");
-                rating.rating = getFirstText(item);
-                pginfo->ratings.append(rating);
+                pginfo->categoryType = string_to_myth_category_type(cat);
             }
-            else if (info.tagName() == "previously-shown")
+            else if (pginfo->category.isEmpty())
             {
-                pginfo->previouslyshown = true;
-
-                QString prevdate = info.attribute("start");
-                if (!prevdate.isEmpty())
-                {
-                    QDateTime date;
-                    fromXMLTVDate(prevdate, date,
-                                localTimezoneOffset);
-                    pginfo->originalairdate = date.date();
-                }
+                pginfo->category = cat;
             }
-            else if (info.tagName() == "credits")
+
+            if (cat == "film")
             {
-                parseCredits(info, pginfo);
+                // Hack for tv_grab_uk_rt
+                pginfo->categoryType = kCategoryMovie;
             }
-            else if (info.tagName() == "subtitles")
+        }
+        else if (tag == "date" && !pginfo->airdate)
+        {
+            // Movie production year
+            QString date = getText(xml);
+            pginfo->airdate = date.left(4).toUInt();
+        }
+        else if (tag == "star-rating" && pginfo->stars.isEmpty())
+        {
+            QString stars, num, den;
+            float rating = 0.0;
+
+            // Use the first rating to appear in the xml, this should be
+            // the most important one.
+            //
+            // Averaging is not a good idea here, any subsequent ratings
+            // are likely to represent that days recommended programmes
+            // which on a bad night could given to an average programme.
+            // In the case of uk_rt it's not unknown for a recommendation
+            // to be given to programmes which are 'so bad, you have to
+            // watch!'
+            stars = getFirstValue(xml);
+            if (!stars.isEmpty())
             {
-                if (info.attribute("type") == "teletext")
-                    pginfo->subtitleType |= SUB_NORMAL;
-                else if (info.attribute("type") == "onscreen")
-                    pginfo->subtitleType |= SUB_ONSCREEN;
-                else if (info.attribute("type") == "deaf-signed")
-                    pginfo->subtitleType |= SUB_SIGNED;
+                num = stars.section('/', 0, 0);
+                den = stars.section('/', 1, 1);
+                if (0.0 < den.toFloat())
+                    rating = num.toFloat()/den.toFloat();
             }
-            else if (info.tagName() == "audio")
+
+            pginfo->stars.setNum(rating);
+        }
+        else if (tag == "rating")
+        {
+            // again, the structure of ratings seems poorly represented
+            // in the XML.  no idea what we'd do with multiple values.
+            EventRating rating;
+            rating.system = info.value("system").toString();
+            rating.rating = getFirstValue(xml);
+            if (!rating.rating.isEmpty())
+                pginfo->ratings.append(rating);
+        }
+        else if (tag == "previously-shown")
+        {
+            pginfo->previouslyshown = true;
+
+            QString prevdate = info.value("start").toString();
+            if (!prevdate.isEmpty())
             {
-                parseAudio(info, pginfo);
+                QDateTime date;
+                fromXMLTVDate(prevdate, date,
+                            localTimezoneOffset);
+                pginfo->originalairdate = date.date();
             }
-            else if (info.tagName() == "video")
+            xml.skipCurrentElement();
+        }
+        else if (tag == "credits")
+        {
+            parseCredits(xml, pginfo);
+        }
+        else if (tag == "subtitles")
+        {
+            if (info.value("type") == QLatin1String("teletext"))
+                pginfo->subtitleType |= SUB_NORMAL;
+            else if (info.value("type") == QLatin1String("onscreen"))
+                pginfo->subtitleType |= SUB_ONSCREEN;
+            else if (info.value("type") == QLatin1String("deaf-signed"))
+                pginfo->subtitleType |= SUB_SIGNED;
+            xml.skipCurrentElement();
+        }
+        else if (tag == "audio")
+        {
+            parseAudio(xml, pginfo);
+        }
+        else if (tag == "video")
+        {
+            parseVideo(xml, pginfo);
+        }
+        else if (tag == "episode-num")
+        {
+            QString system = info.value("system").toString();
+            QString episodenum(getText(xml));
+
+            if (system == "dd_progid")
             {
-                parseVideo(info, pginfo);
+                // if this field includes a dot, strip it out
+                int idx = episodenum.indexOf('.');
+                if (idx != -1)
+                    episodenum.remove(idx, 1);
+                pginfo->programId = episodenum;
+                dd_progid_done = 1;
             }
-            else if (info.tagName() == "episode-num")
+            else if (system == "xmltv_ns")
             {
-                if (info.attribute("system") == "dd_progid")
+                int tmp;
+                episode = episodenum.section('.',1,1);
+                episode = episode.section('/',0,0).trimmed();
+                season = episodenum.section('.',0,0).trimmed();
+                QString part(episodenum.section('.',2,2));
+                QString partnumber(part.section('/',0,0).trimmed());
+                QString parttotal(part.section('/',1,1).trimmed());
+
+                pginfo->categoryType = kCategorySeries;
+
+                if (!episode.isEmpty())
                 {
-                    QString episodenum(getFirstText(info));
-                    // if this field includes a dot, strip it out
-                    int idx = episodenum.indexOf('.');
-                    if (idx != -1)
-                        episodenum.remove(idx, 1);
-                    pginfo->programId = episodenum;
-                    dd_progid_done = 1;
+                    tmp = episode.toInt() + 1;
+                    episode = QString::number(tmp);
+                    pginfo->syndicatedepisodenumber = QString('E' + episode);
                 }
-                else if (info.attribute("system") == "xmltv_ns")
-                {
-                    int tmp;
-                    QString episodenum(getFirstText(info));
-                    episode = episodenum.section('.',1,1);
-                    episode = episode.section('/',0,0).trimmed();
-                    season = episodenum.section('.',0,0).trimmed();
-                    QString part(episodenum.section('.',2,2));
-                    QString partnumber(part.section('/',0,0).trimmed());
-                    QString parttotal(part.section('/',1,1).trimmed());
-
-                    pginfo->categoryType = kCategorySeries;
-
-                    if (!episode.isEmpty())
-                    {
-                        tmp = episode.toInt() + 1;
-                        episode = QString::number(tmp);
-                        pginfo->syndicatedepisodenumber = QString('E' + episode);
-                    }
 
-                    if (!season.isEmpty())
-                    {
-                        tmp = season.toInt() + 1;
-                        season = QString::number(tmp);
-                        pginfo->syndicatedepisodenumber.append(QString('S' + season));
-                    }
+                if (!season.isEmpty())
+                {
+                    tmp = season.toInt() + 1;
+                    season = QString::number(tmp);
+                    pginfo->syndicatedepisodenumber.append(QString('S' + season));
+                }
 
-                    uint partno = 0;
-                    if (!partnumber.isEmpty())
-                    {
-                        bool ok;
-                        partno = partnumber.toUInt(&ok) + 1;
-                        partno = (ok) ? partno : 0;
-                    }
+                uint partno = 0;
+                if (!partnumber.isEmpty())
+                {
+                    bool ok;
+                    partno = partnumber.toUInt(&ok) + 1;
+                    partno = (ok) ? partno : 0;
+                }
 
-                    if (!parttotal.isEmpty() && partno > 0)
+                if (!parttotal.isEmpty() && partno > 0)
+                {
+                    bool ok;
+                    uint partto = parttotal.toUInt(&ok) + 1;
+                    if (ok && partnumber <= parttotal)
                     {
-                        bool ok;
-                        uint partto = parttotal.toUInt(&ok) + 1;
-                        if (ok && partnumber <= parttotal)
-                        {
-                            pginfo->parttotal  = partto;
-                            pginfo->partnumber = partno;
-                        }
+                        pginfo->parttotal  = partto;
+                        pginfo->partnumber = partno;
                     }
                 }
-                else if (info.attribute("system") == "onscreen" &&
-                        pginfo->subtitle.isEmpty())
-                {
-                    pginfo->categoryType = kCategorySeries;
-                    pginfo->subtitle = getFirstText(info);
-                }
             }
+            else if (system == "onscreen" && pginfo->subtitle.isEmpty())
+            {
+                pginfo->categoryType = kCategorySeries;
+                pginfo->subtitle = episodenum;
+            }
+        }
+        else
+        {
+            xml.skipCurrentElement();
         }
     }
 
@@ -577,154 +603,245 @@ ProgInfo *XMLTVParser::parseProgram(
     return pginfo;
 }
 
-bool XMLTVParser::parseFile(
-    QString filename, QList<ChanInfo> *chanlist,
-    QMap<QString, QList<ProgInfo> > *proglist)
+bool XMLTVParser::openFile(const QString &filename)
 {
-    QDomDocument doc;
-    QFile f;
+    closeFile();
 
-    if (!dash_open(f, filename, QIODevice::ReadOnly))
+    if (!dash_open(xml_file, filename, QIODevice::ReadOnly))
     {
         LOG(VB_GENERAL, LOG_ERR,
             QString("Error unable to open '%1' for reading.") .arg(filename));
         return false;
     }
 
-    QString errorMsg = "unknown";
-    int errorLine = 0;
-    int errorColumn = 0;
-
-    if (!doc.setContent(&f, &errorMsg, &errorLine, &errorColumn))
-    {
-        LOG(VB_GENERAL, LOG_ERR, QString("Error in %1:%2: %3")
-            .arg(errorLine).arg(errorColumn).arg(errorMsg));
-
-        f.close();
-        return true;
-    }
-
-    f.close();
+    xml_reader.setDevice(&xml_file);
 
     // now we calculate the localTimezoneOffset, so that we can fix
     // the programdata if needed
     QString config_offset = gCoreContext->GetSetting("TimeOffset", "None");
     // we disable this feature by setting it invalid (> 840min = 14hr)
-    int localTimezoneOffset = 841;
+    tz_offset = 841;
 
     if (config_offset == "Auto")
     {
         // we mark auto with the -ve of the disable magic number
-        localTimezoneOffset = -841;
+        tz_offset = -841;
     }
     else if (config_offset != "None")
     {
-        localTimezoneOffset = TimezoneToInt(config_offset);
-        if (abs(localTimezoneOffset) > 840)
+        tz_offset = TimezoneToInt(config_offset);
+        if (abs(tz_offset) > 840)
         {
             LOG(VB_XMLTV, LOG_ERR, QString("Ignoring invalid TimeOffset %1")
                 .arg(config_offset));
-            localTimezoneOffset = 841;
+            tz_offset = 841;
         }
     }
 
-    QDomElement docElem = doc.documentElement();
+    return true;
+}
 
-    QUrl baseUrl(docElem.attribute("source-data-url", ""));
+void XMLTVParser::closeFile(void)
+{
+    xml_reader.clear();
+    if (xml_file.isOpen())
+        xml_file.close();
+
+    base_url.clear();
+    aggregatedTitle.clear();
+    aggregatedDesc.clear();
+    groupingTitle.clear();
+    groupingDesc.clear();
+    kept_back.clear();
+}
 
-    QUrl sourceUrl(docElem.attribute("source-info-url", ""));
-    if (sourceUrl.toString() == "http://labs.zap2it.com/")
+/** \brief Reads channels and programmes until the proglist holds at least
+ *         maxPrograms programmes or the end of the file is reached.
+ *
+ *  The programmes kept back by the previous call are put in front of the
+ *  new ones. A broken file is logged and ends the parse, keeping whatever
+ *  was read up to the error.
+ *
+ *  \return false once the whole file has been returned.
+ */
+bool XMLTVParser::parseBatch(
+    QList<ChanInfo> *chanlist, QMap<QString, QList<ProgInfo> > *proglist,
+    uint maxPrograms)
+{
+    if (!xml_file.isOpen())
+        return false;
+
+    // Only new programmes count, so every call makes progress.
+    uint count = 0;
+    QMap<QString, QList<ProgInfo> >::iterator kit = kept_back.begin();
+    for (; kit != kept_back.end(); ++kit)
+        (*proglist)[kit.key()] += *kit;
+    kept_back.clear();
+
+    while (count < maxPrograms &&
+           !xml_reader.atEnd() && !xml_reader.hasError())
     {
-        LOG(VB_GENERAL, LOG_ERR, "Don't use tv_grab_na_dd, use the"
-                                 "internal datadirect grabber.");
-        exit(GENERIC_EXIT_SETUP_ERROR);
+        if (xml_reader.readNext() != QXmlStreamReader::StartElement)
+            continue;
+
+        QString tag = xml_reader.name().toString();
+        if (tag == "tv")
+        {
+            QXmlStreamAttributes attrs = xml_reader.attributes();
+            base_url = QUrl(attrs.value("source-data-url").toString());
+
+            QUrl sourceUrl(attrs.value("source-info-url").toString());
+            if (sourceUrl.toString() == "http://labs.zap2it.com/")
+            {
+                LOG(VB_GENERAL, LOG_ERR, "Don't use tv_grab_na_dd, use the"
+                                         "internal datadirect grabber.");
+                exit(GENERIC_EXIT_SETUP_ERROR);
+            }
+        }
+        else if (tag == "channel")
+        {
+            ChanInfo *chinfo = parseChannel(xml_reader, base_url);
+            chanlist->push_back(*chinfo);
+            delete chinfo;
+        }
+        else if (tag == "programme")
+        {
+            ProgInfo *pginfo = parseProgram(xml_reader, tz_offset);
+            if (addProgram(pginfo, proglist))
+                count++;
+            delete pginfo;
+        }
+        else
+        {
+            xml_reader.skipCurrentElement();
+        }
     }
 
-    QString aggregatedTitle;
-    QString aggregatedDesc;
-    QString groupingTitle;
-    QString groupingDesc;
+    if (xml_reader.hasError())
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Error in %1:%2: %3")
+            .arg(xml_reader.lineNumber()).arg(xml_reader.columnNumber())
+            .arg(xml_reader.errorString()));
+    }
+
+    if (xml_reader.atEnd() || xml_reader.hasError())
+        closeFile();
+    else
+        keepBack(proglist);
+
+    return true;
+}
 
-    QDomNode n = docElem.firstChild();
-    while (!n.isNull())
+/** \brief Handles the grouping markers and clumps, then adds the programme.
+ *  \return true if a programme was added to the proglist.
+ */
+bool XMLTVParser::addProgram(
+    ProgInfo *pginfo, QMap<QString, QList<ProgInfo> > *proglist)
+{
+    if (pginfo->startts == pginfo->endts)
     {
-        QDomElement e = n.toElement();
-        if (!e.isNull())
+        /* Not a real program : just a grouping marker */
+        if (!pginfo->title.isEmpty())
+            groupingTitle = pginfo->title + " : ";
+
+        if (!pginfo->description.isEmpty())
+            groupingDesc = pginfo->description + " : ";
+    }
+    else
+    {
+        if (pginfo->clumpidx.isEmpty())
         {
-            if (e.tagName() == "channel")
+            if (!groupingTitle.isEmpty())
             {
-                ChanInfo *chinfo = parseChannel(e, baseUrl);
-                chanlist->push_back(*chinfo);
-                delete chinfo;
+                pginfo->title.prepend(groupingTitle);
+                groupingTitle.clear();
             }
-            else if (e.tagName() == "programme")
+
+            if (!groupingDesc.isEmpty())
             {
-                ProgInfo *pginfo = parseProgram(e, localTimezoneOffset);
+                pginfo->description.prepend(groupingDesc);
+                groupingDesc.clear();
+            }
 
-                if (pginfo->startts == pginfo->endts)
-                {
-                    /* Not a real program : just a grouping marker */
-                    if (!pginfo->title.isEmpty())
-                        groupingTitle = pginfo->title + " : ";
+            (*proglist)[pginfo->channel].push_back(*pginfo);
+            return true;
+        }
+        else
+        {
+            /* append all titles/descriptions from one clump */
+            if (pginfo->clumpidx.toInt() == 0)
+            {
+                aggregatedTitle.clear();
+                aggregatedDesc.clear();
+            }
 
-                    if (!pginfo->description.isEmpty())
-                        groupingDesc = pginfo->description + " : ";
-                }
-                else
-                {
-                    if (pginfo->clumpidx.isEmpty())
-                    {
-                        if (!groupingTitle.isEmpty())
-                        {
-                            pginfo->title.prepend(groupingTitle);
-                            groupingTitle.clear();
-                        }
-
-                        if (!groupingDesc.isEmpty())
-                        {
-                            pginfo->description.prepend(groupingDesc);
-                            groupingDesc.clear();
-                        }
-
-                        (*proglist)[pginfo->channel].push_back(*pginfo);
-                    }
-                    else
-                    {
-                        /* append all titles/descriptions from one clump */
-                        if (pginfo->clumpidx.toInt() == 0)
-                        {
-                            aggregatedTitle.clear();
-                            aggregatedDesc.clear();
-                        }
-
-                        if (!pginfo->title.isEmpty())
-                        {
-                            if (!aggregatedTitle.isEmpty())
-                                aggregatedTitle.append(" | ");
-                            aggregatedTitle.append(pginfo->title);
-                        }
-
-                        if (!pginfo->description.isEmpty())
-                        {
-                            if (!aggregatedDesc.isEmpty())
-                                aggregatedDesc.append(" | ");
-                            aggregatedDesc.append(pginfo->description);
-                        }
-                        if (pginfo->clumpidx.toInt() ==
-                            pginfo->clumpmax.toInt() - 1)
-                        {
-                            pginfo->title = aggregatedTitle;
-                            pginfo->description = aggregatedDesc;
-                            (*proglist)[pginfo->channel].push_back(*pginfo);
-                        }
-                    }
-                }
-                delete pginfo;
+            if (!pginfo->title.isEmpty())
+            {
+                if (!aggregatedTitle.isEmpty())
+                    aggregatedTitle.append(" | ");
+                aggregatedTitle.append(pginfo->title);
+            }
+
+            if (!pginfo->description.isEmpty())
+            {
+                if (!aggregatedDesc.isEmpty())
+                    aggregatedDesc.append(" | ");
+                aggregatedDesc.append(pginfo->description);
+            }
+            if (pginfo->clumpidx.toInt() ==
+                pginfo->clumpmax.toInt() - 1)
+            {
+                pginfo->title = aggregatedTitle;
+                pginfo->description = aggregatedDesc;
+                (*proglist)[pginfo->channel].push_back(*pginfo);
+                return true;
             }
         }
-        n = n.nextSibling();
     }
 
-    return true;
+    return false;
+}
+
+static bool start_time_less_than(const ProgInfo &a, const ProgInfo &b)
+{
+    return (a.starttime < b.starttime);
 }
 
+/** \brief Moves the tail of each channel's programmes into kept_back.
+ *
+ *  ProgramData::FixProgramList() takes a missing stop time from the next
+ *  programme and removes overlapping programmes. So the last programme is
+ *  kept back, the one before it gets its stop time filled in here, and any
+ *  it overlaps are kept back as well, up to kMaxKeptBack per channel.
+ */
+void XMLTVParser::keepBack(QMap<QString, QList<ProgInfo> > *proglist)
+{
+    QMap<QString, QList<ProgInfo> >::iterator it = proglist->begin();
+    while (it != proglist->end())
+    {
+        QList<ProgInfo> &list = *it;
+        qStableSort(list.begin(), list.end(), start_time_less_than);
+
+        QList<ProgInfo> &kept = kept_back[it.key()];
+        kept.push_front(list.takeLast());
+
+        while (!list.empty() && kept.size() < kMaxKeptBack)
+        {
+            ProgInfo &prev = list.last();
+            const ProgInfo &next = kept.first();
+            if (prev.endts.isEmpty() || prev.startts > prev.endts)
+            {
+                prev.endts   = next.startts;
+                prev.endtime = next.starttime;
+            }
+            if (!prev.HasTimeConflict(next))
+                break;
+            kept.push_front(list.takeLast());
+        }
+
+        if (list.empty())
+            it = proglist->erase(it);
+        else
+            ++it;
+    }
+}
@@ -2,32 +2,63 @@
 #define _XMLTVPARSER_H_
 
 // Qt headers
+#include <QXmlStreamReader>
+#include <QFile>
 #include <QMap>
 #include <QList>
 #include <QString>
+#include <QUrl>
+
+// libmythtv headers
+#include "programdata.h"
 
-class ProgInfo;
 class ChanInfo;
-class QUrl;
-class QDomElement;
 
+/** \class XMLTVParser
+ *  \brief Reads an XMLTV file a batch of programmes at a time.
+ *
+ *  The file is read with a QXmlStreamReader, so only the current batch is
+ *  ever held in memory. The channels come before the programmes in XMLTV,
+ *  so they are all returned with the first batch. The last programmes of
+ *  each channel are kept back for the next batch, so that missing stop
+ *  times and overlaps can still be fixed against the following programme.
+ */
 class XMLTVParser
 {
   public:
     XMLTVParser();
 
-    ChanInfo *parseChannel(QDomElement &element, QUrl &baseUrl);
-    ProgInfo *parseProgram(QDomElement &element, int localTimezoneOffset);
-    bool parseFile(
-        QString filename, QList<ChanInfo> *chanlist,
-        QMap<QString, QList<ProgInfo> > *proglist);
+    bool openFile(const QString &filename);
+    bool parseBatch(QList<ChanInfo> *chanlist,
+                    QMap<QString, QList<ProgInfo> > *proglist,
+                    uint maxPrograms);
+    void closeFile(void);
+
+    ChanInfo *parseChannel(QXmlStreamReader &xml, QUrl &baseUrl);
+    ProgInfo *parseProgram(QXmlStreamReader &xml, int localTimezoneOffset);
 
+  private:
+    bool addProgram(ProgInfo *pginfo,
+                    QMap<QString, QList<ProgInfo> > *proglist);
+    void keepBack(QMap<QString, QList<ProgInfo> > *proglist);
 
   public:
     bool isJapan;
 
   private:
     unsigned int current_year;
+
+    QFile            xml_file;
+    QXmlStreamReader xml_reader;
+    QUrl             base_url;
+    int              tz_offset;
+
+    QString aggregatedTitle;
+    QString aggregatedDesc;
+    QString groupingTitle;
+    QString groupingDesc;
+
+    QMap<QString, QList<ProgInfo> > kept_back;
 };
 
 #endif // _XMLTVPARSER_H_
@@ -1485,6 +1485,19 @@ static HostCheckBox *PersistentBrowseMode()
     return gc;
 }
 
+static HostCheckBox *ShowChannelChangeTimes()
+{
+    HostCheckBox *gc = new HostCheckBox("ShowChannelChangeTimes");
+    gc->setLabel(QObject::tr("Show channel change times"));
+    gc->setValue(false);
+    gc->setHelpText(
+        QObject::tr(
+            "If enabled, the time taken by each step of a Live TV "
+            "channel change is shown in the OSD once the new channel "
+            "is playing."));
+    return gc;
+}
+
 static HostCheckBox *BrowseAllTuners()
 {
     HostCheckBox *gc = new HostCheckBox("BrowseAllTuners");
@@ -3431,6 +3444,7 @@ OSDSettings::OSDSettings()
     osd->addChild(EnableMHEG());
     osd->addChild(PersistentBrowseMode());
     osd->addChild(BrowseAllTuners());
+    osd->addChild(ShowChannelChangeTimes());
     osd->addChild(CCBackground());
     osd->addChild(DefaultCCMode());
     osd->addChild(PreferCC708());
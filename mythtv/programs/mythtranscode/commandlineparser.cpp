@@ -39,6 +39,12 @@ void MythTranscodeCommandLineParser::LoadArguments(void)
     add(QStringList( QStringList() << "-e" << "--ostream" ), "ostream", "",
             "Output stream type: dvd, ps", "")
         ->SetGroup("Encoding");
+    add("--replexbuffer", "replexbuffer", 0,
+            "Size in KB of the lossless transcoder's video multiplex buffer.",
+            "Size in KB of the video buffer used by the lossless "
+            "transcoder's multiplexer. Audio buffers are a fifth of this. "
+            "The default is ten frames' worth of uncompressed video.")
+        ->SetGroup("Encoding");
 //    add("--avf", "avf", false, "Generate libavformat output file.", "")
 //        ->SetGroup("Encoding");
     add("--hls", "hls", false, "Generate HTTP Live Stream output.", "")
@@ -68,6 +74,15 @@ void MythTranscodeCommandLineParser::LoadArguments(void)
     add("--inversecut", "inversecut", false,
             "Inverses the cutlist, leaving only the marked off sections.", "")
         ->SetGroup("Cutlist");
+    add("--gopcut", "gopcut", false,
+            "Apply the cutlist to an MPEG-TS recording by copying whole GOPs.",
+            "Apply the cutlist to an MPEG-TS recording without re-encoding, "
+            "by copying whole GOPs found through the seektable. Works for "
+            "any codec the recorder indexed, including H.264. Cuts are not "
+            "frame accurate: cut points are moved out to the nearest "
+            "keyframes, so up to one GOP of the cut material can remain "
+            "at each cut.")
+        ->SetGroup("Cutlist");
 
     add("--showprogress", "showprogress", false,
             "Display status info in stdout", "")
@@ -0,0 +1,478 @@
+// C headers
+#include <cstring>
+
+// C++ headers
+#include <algorithm>
+using namespace std;
+
+// MythTV headers
+#include "gopcut.h"
+#include "programinfo.h"
+#include "tspacket.h"
+#include "mythlogging.h"
+
+#define LOC QString("GOPCutter: ")
+
+// PCR, PTS and DTS are 33 bit counters at 90kHz
+static const int64_t kTimestampMask = 0x1FFFFFFFFLL;
+// Read this many TS packets at a time
+static const int kPacketsPerRead = 1024;
+// Don't look further than this for the first PCR after a splice
+static const int64_t kMaxPCRSearch = 4 * 1024 * 1024;
+// Frame number used for "until the end of the file"
+static const uint64_t kEndOfFile = ~0ULL;
+
+static inline int64_t align_to_packet(int64_t offset)
+{
+    return offset - (offset % TSPacket::kSize);
+}
+
+static bool get_pcr(const unsigned char *pkt, int64_t &pcr)
+{
+    if (!(pkt[3] & 0x20) || pkt[4] < 7 || !(pkt[5] & 0x10))
+        return false;
+
+    pcr = ((int64_t)pkt[6] << 25) | ((int64_t)pkt[7] << 17) |
+          ((int64_t)pkt[8] << 9)  | ((int64_t)pkt[9] << 1)  |
+          (pkt[10] >> 7);
+    return true;
+}
+
+static void set_pcr(unsigned char *pkt, int64_t pcr)
+{
+    pkt[6]  = (pcr >> 25) & 0xFF;
+    pkt[7]  = (pcr >> 17) & 0xFF;
+    pkt[8]  = (pcr >> 9)  & 0xFF;
+    pkt[9]  = (pcr >> 1)  & 0xFF;
+    pkt[10] = (pkt[10] & 0x7F) | ((pcr & 1) << 7);
+}
+
+static int64_t get_pes_timestamp(const unsigned char *p)
+{
+    return ((int64_t)((p[0] >> 1) & 0x07) << 30) |
+           ((int64_t)p[1] << 22) | ((int64_t)(p[2] >> 1) << 15) |
+           ((int64_t)p[3] << 7)  | (p[4] >> 1);
+}
+
+static void set_pes_timestamp(unsigned char *p, int64_t ts)
+{
+    p[0] = (p[0] & 0xF1) | ((ts >> 29) & 0x0E);
+    p[1] = (ts >> 22) & 0xFF;
+    p[2] = (p[2] & 0x01) | ((ts >> 14) & 0xFE);
+    p[3] = (ts >> 7) & 0xFF;
+    p[4] = (p[4] & 0x01) | ((ts << 1) & 0xFE);
+}
+
+GOPCutter::GOPCutter(const QString &inf, const QString &outf,
+                     frm_dir_map_t *deleteMap, ProgramInfo *pginfo,
+                     bool showprog, void (*update_func)(float),
+                     int (*check_func)()) :
+    m_infile(inf),              m_outfile(outf),
+    m_deleteMap(deleteMap),     m_pginfo(pginfo),
+    m_fileSize(0),
+    m_tsOffset(0),              m_lastPCR(-1),
+    m_pcrInterval(0),           m_pcrPID(0x1FFF),
+    m_showprogress(showprog),   m_updateStatus(update_func),
+    m_checkAbort(check_func),
+    m_bytesWritten(0),          m_bytesTotal(0)
+{
+}
+
+/** \fn GOPCutter::BuildSegments(void)
+ *  \brief Turns the cutlist into a list of keyframe aligned byte ranges.
+ *
+ *  The cutlist passed to the constructor is rewritten to match the
+ *  cuts that will actually be made, so that bookmarks and other marks
+ *  can be translated to the new file.
+ */
+bool GOPCutter::BuildSegments(void)
+{
+    m_pginfo->QueryPositionMap(m_posMap, MARK_GOP_BYFRAME);
+    if (m_posMap.isEmpty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "No position map for this recording, "
+            "rebuild the seektable with 'mythcommflag --rebuild' first.");
+        return false;
+    }
+
+    // Work out which frames to keep
+    QList<GOPCutSegment> keep;
+    GOPCutSegment seg;
+    seg.startFrame = 0;
+    seg.startOffset = seg.endOffset = 0;
+
+    bool inCut = (!m_deleteMap->isEmpty() &&
+                  m_deleteMap->begin().value() == MARK_CUT_END);
+
+    frm_dir_map_t::const_iterator it = m_deleteMap->begin();
+    for (; it != m_deleteMap->end(); ++it)
+    {
+        if (*it == MARK_CUT_START && !inCut)
+        {
+            if (it.key() > seg.startFrame)
+            {
+                seg.endFrame = it.key();
+                keep.push_back(seg);
+            }
+            inCut = true;
+        }
+        else if (*it == MARK_CUT_END && inCut)
+        {
+            seg.startFrame = it.key();
+            inCut = false;
+        }
+    }
+    if (!inCut)
+    {
+        seg.endFrame = kEndOfFile;
+        keep.push_back(seg);
+    }
+
+    // Widen each kept range to whole GOPs and merge any that now overlap
+    m_segments.clear();
+    QList<GOPCutSegment>::iterator kit = keep.begin();
+    for (; kit != keep.end(); ++kit)
+    {
+        frm_pos_map_t::const_iterator pit =
+            m_posMap.upperBound((*kit).startFrame);
+        if (pit != m_posMap.begin())
+            --pit;
+        (*kit).startFrame  = pit.key();
+        (*kit).startOffset = align_to_packet(*pit);
+
+        pit = m_posMap.end();
+        if ((*kit).endFrame != kEndOfFile)
+            pit = m_posMap.lowerBound((*kit).endFrame);
+        if (pit == m_posMap.end())
+        {
+            (*kit).endFrame  = kEndOfFile;
+            (*kit).endOffset = m_fileSize;
+        }
+        else
+        {
+            (*kit).endFrame  = pit.key();
+            (*kit).endOffset = align_to_packet(*pit);
+        }
+
+        if (!m_segments.isEmpty() &&
+            (*kit).startFrame <= m_segments.back().endFrame)
+        {
+            m_segments.back().endFrame =
+                max(m_segments.back().endFrame, (*kit).endFrame);
+            m_segments.back().endOffset =
+                max(m_segments.back().endOffset, (*kit).endOffset);
+        }
+        else if ((*kit).endOffset > (*kit).startOffset)
+        {
+            m_segments.push_back(*kit);
+        }
+    }
+
+    if (m_segments.isEmpty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "The cutlist removes everything.");
+        return false;
+    }
+
+    // Record the cuts as they will be made
+    frm_dir_map_t requested = *m_deleteMap;
+    m_deleteMap->clear();
+    uint64_t lastEnd = 0;
+    QList<GOPCutSegment>::const_iterator sit = m_segments.begin();
+    for (; sit != m_segments.end(); ++sit)
+    {
+        if ((*sit).startFrame > lastEnd)
+        {
+            (*m_deleteMap)[lastEnd] = MARK_CUT_START;
+            (*m_deleteMap)[(*sit).startFrame] = MARK_CUT_END;
+            LOG(VB_GENERAL, LOG_INFO, LOC +
+                QString("Cutting frames %1 to %2")
+                    .arg(lastEnd).arg((*sit).startFrame));
+        }
+        lastEnd = (*sit).endFrame;
+        m_bytesTotal += (*sit).endOffset - (*sit).startOffset;
+    }
+    if (lastEnd != kEndOfFile)
+    {
+        (*m_deleteMap)[lastEnd] = MARK_CUT_START;
+        LOG(VB_GENERAL, LOG_INFO, LOC +
+            QString("Cutting from frame %1 to the end").arg(lastEnd));
+    }
+
+    if (requested != *m_deleteMap)
+    {
+        LOG(VB_GENERAL, LOG_NOTICE, LOC + "Cut points were moved out to "
+            "keyframes, so some of the cut material is kept. Transcode "
+            "without --gopcut for frame accurate cuts.");
+    }
+
+    return true;
+}
+
+int GOPCutter::Start(void)
+{
+    if (!m_pginfo || !m_deleteMap)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "No recording or cutlist given.");
+        return REENCODE_ERROR;
+    }
+
+    m_in.setFileName(m_infile);
+    if (!m_in.open(QIODevice::ReadOnly))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Could not open '%1' for reading.").arg(m_infile));
+        return REENCODE_ERROR;
+    }
+    m_fileSize = align_to_packet(m_in.size());
+
+    unsigned char sync[TSPacket::kSize + 1];
+    if (m_in.read((char *)sync, sizeof(sync)) != sizeof(sync) ||
+        sync[0] != SYNC_BYTE || sync[TSPacket::kSize] != SYNC_BYTE)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("'%1' is not an MPEG transport stream.").arg(m_infile));
+        return REENCODE_ERROR;
+    }
+
+    if (!BuildSegments())
+        return REENCODE_ERROR;
+
+    m_out.setFileName(m_outfile);
+    if (!m_out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Could not open '%1' for writing.").arg(m_outfile));
+        return REENCODE_ERROR;
+    }
+
+    if (m_showprogress || m_updateStatus)
+        m_statustime = QDateTime::currentDateTime().addSecs(5);
+
+    uint64_t outFrame = 0;
+    for (int i = 0; i < m_segments.size(); ++i)
+    {
+        const GOPCutSegment &seg = m_segments[i];
+
+        frm_pos_map_t::const_iterator it = m_posMap.lowerBound(seg.startFrame);
+        for (; it != m_posMap.end() && it.key() < seg.endFrame; ++it)
+        {
+            m_newPosMap[outFrame + it.key() - seg.startFrame] =
+                m_bytesWritten + (*it - seg.startOffset);
+        }
+        if (seg.endFrame != kEndOfFile)
+            outFrame += seg.endFrame - seg.startFrame;
+
+        int ret = CopySegment(seg, i > 0);
+        if (ret != REENCODE_OK)
+        {
+            m_out.close();
+            m_out.remove();
+            return ret;
+        }
+    }
+
+    m_out.close();
+
+    LOG(VB_GENERAL, LOG_NOTICE, LOC +
+        QString("Copied %1 segments, %2 of %3 MB kept")
+            .arg(m_segments.size())
+            .arg(m_bytesWritten / (1024 * 1024))
+            .arg(m_fileSize / (1024 * 1024)));
+
+    return REENCODE_OK;
+}
+
+int GOPCutter::CopySegment(const GOPCutSegment &seg, bool splice)
+{
+    m_pidStarted.clear();
+
+    if (splice)
+    {
+        // Shift the timestamps of this segment so its first PCR follows
+        // on from the last PCR written, at the usual PCR spacing.
+        int64_t pcr;
+        if (m_lastPCR >= 0 &&
+            FindFirstPCR(seg.startOffset, seg.endOffset, pcr))
+        {
+            m_tsOffset = (pcr - m_lastPCR - m_pcrInterval) & kTimestampMask;
+        }
+        m_lastPCR = -1;
+    }
+
+    if (!m_in.seek(seg.startOffset))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Seek to %1 failed.").arg(seg.startOffset));
+        return REENCODE_ERROR;
+    }
+
+    unsigned char *buf = new unsigned char[kPacketsPerRead * TSPacket::kSize];
+    int64_t pos = seg.startOffset;
+
+    while (pos < seg.endOffset)
+    {
+        int64_t want = min((int64_t)kPacketsPerRead * TSPacket::kSize,
+                           seg.endOffset - pos);
+        int64_t got = align_to_packet(m_in.read((char *)buf, want));
+        if (got <= 0)
+            break;
+
+        for (int64_t i = 0; i < got; i += TSPacket::kSize)
+            ProcessPacket(buf + i);
+
+        if (m_out.write((char *)buf, got) != got)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Write to '%1' failed.").arg(m_outfile));
+            delete [] buf;
+            return REENCODE_ERROR;
+        }
+
+        pos += got;
+        m_bytesWritten += got;
+
+        if ((m_showprogress || m_updateStatus) &&
+            QDateTime::currentDateTime() > m_statustime)
+        {
+            float percent_done = 100.0 * m_bytesWritten / m_bytesTotal;
+            if (m_updateStatus)
+                m_updateStatus(percent_done);
+            if (m_showprogress)
+                LOG(VB_GENERAL, LOG_INFO, QString("%1% complete")
+                        .arg(percent_done, 0, 'f', 1));
+            if (m_checkAbort && m_checkAbort())
+            {
+                delete [] buf;
+                return REENCODE_STOPPED;
+            }
+            m_statustime = QDateTime::currentDateTime().addSecs(5);
+        }
+    }
+
+    delete [] buf;
+    return REENCODE_OK;
+}
+
+bool GOPCutter::FindFirstPCR(int64_t start, int64_t end, int64_t &pcr)
+{
+    if (!m_in.seek(start))
+        return false;
+
+    end = min(end, start + kMaxPCRSearch);
+
+    unsigned char pkt[TSPacket::kSize];
+    for (int64_t pos = start; pos < end; pos += TSPacket::kSize)
+    {
+        if (m_in.read((char *)pkt, TSPacket::kSize) != TSPacket::kSize)
+            return false;
+
+        const TSPacket *tspacket = reinterpret_cast<const TSPacket*>(pkt);
+        if (!tspacket->HasSync())
+            continue;
+        if (m_pcrPID != 0x1FFF && tspacket->PID() != m_pcrPID)
+            continue;
+        if (get_pcr(pkt, pcr))
+            return true;
+    }
+
+    return false;
+}
+
+void GOPCutter::ProcessPacket(unsigned char *pkt)
+{
+    TSPacket *tspacket = reinterpret_cast<TSPacket*>(pkt);
+    if (!tspacket->HasSync())
+        return;
+
+    uint pid = tspacket->PID();
+    if (pid == 0x1FFF)
+        return;
+
+    if (tspacket->HasPayload() && !m_pidStarted.value(pid))
+    {
+        // Drop the tail of any PES packet or section that began before
+        // the splice point, replacing it with a null packet so that the
+        // byte offsets in the new position map stay valid.
+        if (!tspacket->PayloadStart())
+        {
+            memcpy(pkt, TSPacket::kNullPacket, TSPacket::kSize);
+            return;
+        }
+
+        m_pidStarted[pid] = true;
+
+        uint cc = tspacket->ContinuityCounter();
+        if (m_lastCC.contains(pid))
+            m_ccDelta[pid] = (m_lastCC[pid] + 1 - cc) & 0xF;
+        else
+            m_ccDelta[pid] = 0;
+    }
+
+    if (tspacket->HasPayload())
+    {
+        uint cc = (tspacket->ContinuityCounter() + m_ccDelta.value(pid)) & 0xF;
+        tspacket->SetContinuityCounter(cc);
+        m_lastCC[pid] = cc;
+    }
+
+    AdjustTimestamps(pkt);
+}
+
+void GOPCutter::AdjustTimestamps(unsigned char *pkt)
+{
+    const TSPacket *tspacket = reinterpret_cast<const TSPacket*>(pkt);
+
+    int64_t pcr;
+    if (get_pcr(pkt, pcr))
+    {
+        if (m_pcrPID == 0x1FFF)
+            m_pcrPID = tspacket->PID();
+
+        if (tspacket->PID() == m_pcrPID)
+        {
+            pcr = (pcr - m_tsOffset) & kTimestampMask;
+            set_pcr(pkt, pcr);
+
+            if (m_lastPCR >= 0)
+            {
+                int64_t interval = (pcr - m_lastPCR) & kTimestampMask;
+                if (interval < 90000)
+                    m_pcrInterval = interval;
+            }
+            m_lastPCR = pcr;
+        }
+    }
+
+    if (!m_tsOffset || !tspacket->PayloadStart() || !tspacket->HasPayload())
+        return;
+
+    uint offset = tspacket->AFCOffset();
+    if (offset + 19 > TSPacket::kSize)
+        return;
+
+    unsigned char *pes = pkt + offset;
+    if (pes[0] != 0x00 || pes[1] != 0x00 || pes[2] != 0x01)
+        return;
+
+    // Stream types without the optional PES header
+    uint stream_id = pes[3];
+    if (stream_id == 0xBC || stream_id == 0xBE || stream_id == 0xBF ||
+        stream_id == 0xF0 || stream_id == 0xF1 || stream_id == 0xF2 ||
+        stream_id == 0xF8 || stream_id == 0xFF)
+        return;
+
+    uint pts_dts_flags = pes[7] >> 6;
+    if (pts_dts_flags & 0x2)
+    {
+        int64_t pts = get_pes_timestamp(pes + 9);
+        set_pes_timestamp(pes + 9, (pts - m_tsOffset) & kTimestampMask);
+    }
+    if (pts_dts_flags == 0x3)
+    {
+        int64_t dts = get_pes_timestamp(pes + 14);
+        set_pes_timestamp(pes + 14, (dts - m_tsOffset) & kTimestampMask);
+    }
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
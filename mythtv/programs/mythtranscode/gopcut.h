@@ -0,0 +1,97 @@
+#ifndef GOPCUT_H_
+#define GOPCUT_H_
+
+// Qt
+#include <QMap>
+#include <QList>
+#include <QFile>
+#include <QString>
+#include <QDateTime>
+
+// MythTV
+#include "transcodedefs.h"
+#include "programtypes.h"
+
+class ProgramInfo;
+
+typedef struct gopcutsegment
+{
+    uint64_t startFrame;    ///< first kept frame, always a keyframe
+    uint64_t endFrame;      ///< first frame after the segment
+    int64_t  startOffset;   ///< byte offset of startFrame, packet aligned
+    int64_t  endOffset;     ///< byte offset of endFrame, packet aligned
+} GOPCutSegment;
+
+/** \class GOPCutter
+ *  \brief Applies a cutlist to an MPEG-TS recording at keyframe accuracy,
+ *         without re-encoding.
+ *
+ *  The kept parts of the recording are copied packet by packet, starting
+ *  and ending at keyframes taken from the recordedseek position map, so
+ *  any codec the recorder indexed (MPEG-2 or H.264) can be cut this way.
+ *  Cut points inside a GOP are moved outwards to the enclosing keyframes,
+ *  so up to one GOP of unwanted material is kept around each cut. The
+ *  partial GOPs are not re-encoded, so this is only used when asked for
+ *  with --gopcut; the transcoder is the frame accurate cutlist remover.
+ *
+ *  Across each splice the continuity counters are kept contiguous, PCR,
+ *  PTS and DTS are shifted to close the gap, and each PID only resumes at
+ *  its next PES or section start, so no partial audio frames are emitted.
+ *  The position map for the new file is built during the same pass.
+ */
+class GOPCutter
+{
+  public:
+    GOPCutter(const QString &inf, const QString &outf,
+              frm_dir_map_t *deleteMap, ProgramInfo *pginfo,
+              bool showprog, void (*update_func)(float) = NULL,
+              int (*check_func)() = NULL);
+
+    int Start(void);
+
+    /// Position map of the output file, valid after Start() succeeds.
+    const frm_pos_map_t &GetPositionMap(void) const { return m_newPosMap; }
+
+  private:
+    bool BuildSegments(void);
+    int  CopySegment(const GOPCutSegment &seg, bool splice);
+    bool FindFirstPCR(int64_t start, int64_t end, int64_t &pcr);
+    void ProcessPacket(unsigned char *pkt);
+    void AdjustTimestamps(unsigned char *pkt);
+
+  private:
+    QString                 m_infile;
+    QString                 m_outfile;
+    frm_dir_map_t          *m_deleteMap;
+    ProgramInfo            *m_pginfo;
+    QFile                   m_in;
+    QFile                   m_out;
+    int64_t                 m_fileSize;
+
+    frm_pos_map_t           m_posMap;
+    frm_pos_map_t           m_newPosMap;
+    QList<GOPCutSegment>    m_segments;
+
+    // Per PID splice state
+    QMap<uint, uint>        m_lastCC;
+    QMap<uint, uint>        m_ccDelta;
+    QMap<uint, bool>        m_pidStarted;
+
+    // Timestamp adjustment, in 90kHz units
+    int64_t                 m_tsOffset;
+    int64_t                 m_lastPCR;
+    int64_t                 m_pcrInterval;
+    uint                    m_pcrPID;
+
+    // Progress reporting
+    bool                    m_showprogress;
+    void                  (*m_updateStatus)(float);
+    int                   (*m_checkAbort)();
+    QDateTime               m_statustime;
+    int64_t                 m_bytesWritten;
+    int64_t                 m_bytesTotal;
+};
+
+#endif
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -21,6 +21,7 @@ using namespace std;
 #include "util.h"
 #include "transcode.h"
 #include "mpeg2fix.h"
+#include "gopcut.h"
 #include "remotefile.h"
 #include "mythtranslation.h"
 #include "mythlogging.h"
@@ -158,9 +159,11 @@ int main(int argc, char *argv[])
     int jobID = -1;
     int jobType = JOB_NONE;
     int otype = REPLEX_MPEG2;
+    uint32_t replexBufferSize = 0;
     bool useCutlist = false, keyframesonly = false;
     bool build_index = false, fifosync = false;
     bool mpeg2 = false;
+    bool gopcut = false;
     bool fifo_info = false;
     bool cleanCut = false;
     QMap<QString, QString> settingsOverride;
@@ -312,6 +315,8 @@ int main(int argc, char *argv[])
         recorderOptions = cmdline.toString("recopt");
     if (cmdline.toBool("mpeg2"))
         mpeg2 = true;
+    if (cmdline.toBool("gopcut"))
+        gopcut = true;
     if (cmdline.toBool("ostream"))
     {
         if (cmdline.toString("ostream") == "dvd")
@@ -326,6 +331,8 @@ int main(int argc, char *argv[])
             return GENERIC_EXIT_INVALID_CMDLINE;
         }
     }
+    if (cmdline.toBool("replexbuffer"))
+        replexBufferSize = cmdline.toUInt("replexbuffer") * 1024;
     if (cmdline.toBool("audiotrack"))
         AudioTrackNo = cmdline.toInt("audiotrack");
     if (cmdline.toBool("passthru"))
@@ -407,6 +414,18 @@ int main(int argc, char *argv[])
         cerr << "--cleancut is pointless without --honorcutlist" << endl;
         return GENERIC_EXIT_INVALID_CMDLINE;
     }
+    if (gopcut && !useCutlist)
+    {
+        cerr << "--gopcut is pointless without --honorcutlist" << endl;
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
+    if (gopcut && (mpeg2 || build_index || !fifodir.isEmpty() ||
+                   cmdline.toBool("hls")))
+    {
+        cerr << "--gopcut cannot be combined with --mpeg2, --buildindex, "
+             << "--fifodir or --hls" << endl;
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
 
     if (fifo_info)
     {
@@ -544,7 +563,7 @@ int main(int argc, char *argv[])
     if (!recorderOptions.isEmpty())
         transcode->SetRecorderOptions(recorderOptions);
     int result = 0;
-    if ((!mpeg2 && !build_index) || cmdline.toBool("hls"))
+    if ((!mpeg2 && !build_index && !gopcut) || cmdline.toBool("hls"))
     {
         result = transcode->TranscodeFile(infile, outfile,
                                           profilename, useCutlist,
@@ -562,7 +581,36 @@ int main(int argc, char *argv[])
     }
 
     int exitcode = GENERIC_EXIT_OK;
-    if ((result == REENCODE_MPEG2TRANS) || mpeg2 || build_index)
+    if (gopcut)
+    {
+        void (*update_func)(float) = NULL;
+        int (*check_func)() = NULL;
+        if (useCutlist && !found_infile)
+            pginfo->QueryCutList(deleteMap);
+        if (jobID >= 0)
+        {
+           glbl_jobID = jobID;
+           update_func = &UpdateJobQueue;
+           check_func = &CheckJobQueue;
+        }
+
+        GOPCutter *cutter = new GOPCutter(infile, outfile, &deleteMap, pginfo,
+                                          showprogress, update_func,
+                                          check_func);
+
+        result = cutter->Start();
+        if (result == REENCODE_OK)
+        {
+            frm_pos_map_t newPosMap = cutter->GetPositionMap();
+            if (update_index)
+                UpdatePositionMap(newPosMap, NULL, pginfo);
+            else
+                UpdatePositionMap(newPosMap, outfile + QString(".map"),
+                                  pginfo);
+        }
+        delete cutter;
+    }
+    else if ((result == REENCODE_MPEG2TRANS) || mpeg2 || build_index)
     {
         void (*update_func)(float) = NULL;
         int (*check_func)() = NULL;
@@ -579,6 +627,7 @@ int main(int argc, char *argv[])
                                          &deleteMap, NULL, false, false, 20,
                                          showprogress, otype, update_func,
                                          check_func);
+        m2f->SetReplexBufferSize(replexBufferSize);
 
         if (build_index)
         {
@@ -209,6 +209,7 @@ MPEG2fixup::MPEG2fixup(const QString &inf, const QString &outf,
     no_repeat = norp;
     fix_PTS = fixPTS;
     maxframes = maxf;
+    replex_bufsize = 0;
     rx.otype = otype;
 
     real_file_end = file_end = false;
@@ -438,7 +439,8 @@ static int fill_buffers(void *r, int finish)
 
 MPEG2replex::MPEG2replex() :
     done(0),      otype(0),
-    ext_count(0), mplex(0)
+    ext_count(0), full_waits(0),
+    mplex(0)
 {
     memset(&vrbuf, 0, sizeof(vrbuf));
     memset(extrbuf, 0, sizeof(extrbuf));
@@ -563,6 +565,11 @@ void MPEG2fixup::InitReplex()
     //this should support > 100 frames
     uint32_t memsize = vFrame.first()->mpeg2_seq.width *
                        vFrame.first()->mpeg2_seq.height * 10;
+    if (replex_bufsize)
+        memsize = replex_bufsize;
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Replex video buffer %1 KB, audio buffers %2 KB")
+            .arg(memsize / 1024).arg(memsize / 5 / 1024));
     ring_init(&rx.vrbuf, memsize);
     ring_init(&rx.index_vrbuf, INDEX_BUF);
 
@@ -604,6 +611,38 @@ void MPEG2fixup::InitReplex()
     rx.ext_count = ext_count;
 }
 
+void MPEG2fixup::ReplexBufferReport()
+{
+    if (!rx.vrbuf.size)
+        return;
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Replex video buffer: %1 KB, peak fill %2%, grown %3 times, "
+                "%4 MB written")
+            .arg(rx.vrbuf.size / 1024)
+            .arg((uint)((uint64_t)rx.vrbuf.max_fill * 100 / rx.vrbuf.size))
+            .arg(rx.vrbuf.grow_count)
+            .arg(rx.vrbuf.bytes_in / (1024 * 1024)));
+
+    for (int i = 0; i < ext_count; i++)
+    {
+        if (!rx.extrbuf[i].size)
+            continue;
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Replex audio buffer %1: %2 KB, peak fill %3%, "
+                    "grown %4 times, %5 MB written")
+                .arg(i).arg(rx.extrbuf[i].size / 1024)
+                .arg((uint)((uint64_t)rx.extrbuf[i].max_fill * 100 /
+                            rx.extrbuf[i].size))
+                .arg(rx.extrbuf[i].grow_count)
+                .arg(rx.extrbuf[i].bytes_in / (1024 * 1024)));
+    }
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Replex buffers were full %1 times waiting for the "
+                "multiplexer").arg(rx.full_waits));
+}
+
 void MPEG2fixup::FrameInfo(MPEG2frame *f)
 {
     QString msg = QString("Id:%1 %2 V:%3").arg(f->pkt.stream_index)
@@ -698,6 +737,7 @@ int MPEG2fixup::AddFrame(MPEG2frame *f)
             return 1;
         }
 
+        rx.full_waits++;
         pthread_cond_signal(&rx.cond);
         pthread_cond_wait(&rx.cond, &rx.mutex);
 
@@ -2484,6 +2524,8 @@ int MPEG2fixup::Start()
     pthread_mutex_unlock( &rx.mutex );
     pthread_join(thread, NULL);
 
+    ReplexBufferReport();
+
     av_close_input_file(inputFC);
     inputFC = NULL;
     return REENCODE_OK;
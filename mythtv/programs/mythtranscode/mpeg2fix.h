@@ -120,6 +120,7 @@ class MPEG2replex
     int ext_count;
     int exttype[N_AUDIO];
     int exttypcnt[N_AUDIO];
+    int full_waits;
 
     pthread_mutex_t mutex;
     pthread_cond_t cond;
@@ -146,6 +147,7 @@ class MPEG2fixup
     void AddRangeList(QStringList cutlist, int type);
     void ShowRangeMap(frm_dir_map_t *mapPtr, QString msg);
     int BuildKeyframeIndex(QString &file, frm_pos_map_t &posMap);
+    void SetReplexBufferSize(uint32_t size) { replex_bufsize = size; }
 
 
     static void dec2x33(int64_t *pts1, int64_t pts2);
@@ -162,6 +164,7 @@ class MPEG2fixup
   private:
     int FindMPEG2Header(uint8_t *buf, int size, uint8_t code);
     void InitReplex();
+    void ReplexBufferReport();
     void FrameInfo(MPEG2frame *f);
     int AddFrame(MPEG2frame *f);
     bool InitAV(QString inputfile, const char *type, int64_t offset);
@@ -252,6 +255,7 @@ class MPEG2fixup
     int discard;
     //control options
     int no_repeat, fix_PTS, maxframes;
+    uint32_t replex_bufsize;
     QString infile;
     const char *format;
 
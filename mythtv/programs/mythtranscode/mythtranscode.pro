@@ -13,11 +13,11 @@ QMAKE_CLEAN += $(TARGET)
 QMAKE_CFLAGS += -w
 
 # Input
-SOURCES += main.cpp transcode.cpp mpeg2fix.cpp helper.c
+SOURCES += main.cpp transcode.cpp mpeg2fix.cpp gopcut.cpp helper.c
 SOURCES += commandlineparser.cpp
 SOURCES += replex/element.c replex/mpg_common.c replex/multiplex.c \
            replex/pes.c     replex/ringbuffer.c replex/ts.c
-HEADERS += mpeg2fix.h transcodedefs.h commandlineparser.h
+HEADERS += mpeg2fix.h gopcut.h transcodedefs.h commandlineparser.h
 HEADERS += replex/element.h replex/mpg_common.h replex/multiplex.h \
            replex/pes.h     replex/ringbuffer.h replex/ts.h
 
@@ -49,6 +49,9 @@ int ring_init (ringbuffer *rbuf, int size)
 	}
 	rbuf->read_pos = 0;	
 	rbuf->write_pos = 0;
+	rbuf->max_fill = 0;
+	rbuf->grow_count = 0;
+	rbuf->bytes_in = 0;
 	return 0;
 }
 
@@ -69,6 +72,7 @@ int ring_reinit (ringbuffer *rbuf, int size)
 			rbuf->read_pos += delta;
 		}
 		rbuf->size = size;
+		rbuf->grow_count++;
 	}
 	return 0;
 }
@@ -113,6 +117,7 @@ int ring_write(ringbuffer *rbuf, uint8_t *data, int count)
 		memcpy (rbuf->buffer+pos, data, count);
 		rbuf->write_pos += count;
 	}
+	ring_update_stats(rbuf, count);
 
 	if (DEBUG>1)
 		LOG(VB_GENERAL, LOG_ERR, "Buffer empty %.2f%%",
@@ -283,6 +288,8 @@ int ring_write_file(ringbuffer *rbuf, int fd, int count)
 		if (rr >=0)
 			rbuf->write_pos += rr;
 	}
+	if (rr > 0)
+		ring_update_stats(rbuf, rr);
 
 	if (DEBUG>1)
 		LOG(VB_GENERAL, LOG_ERR, "Buffer empty %.2f%%",
@@ -42,6 +42,11 @@ extern "C" {
 		int write_pos;
 		uint32_t size;
 		uint8_t *buffer;
+
+		/* usage statistics, for callers sizing the buffer */
+		uint32_t max_fill;
+		uint32_t grow_count;
+		uint64_t bytes_in;
 	} ringbuffer;
 
 
@@ -113,6 +118,14 @@ extern "C" {
 
 
 
+	static inline void ring_update_stats(ringbuffer *rbuf, int count)
+	{
+		unsigned int fill = ring_avail(rbuf);
+		if (fill > rbuf->max_fill)
+			rbuf->max_fill = fill;
+		rbuf->bytes_in += count;
+	}
+
 	static inline uint32_t dummy_space(dummy_buffer *dbuf)
 	{
 		return (dbuf->size - dbuf->fill);
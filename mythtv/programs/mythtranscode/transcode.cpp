@@ -7,6 +7,7 @@
 #include <QRegExp>
 #include <QList>
 #include <QWaitCondition>
+#include <QAtomicInt>
 
 #include "mythconfig.h"
 
@@ -18,6 +19,7 @@
 #include "exitcodes.h"
 #include "mthreadpool.h"
 #include "deletemap.h"
+#include "mythtimer.h"
 
 #include "NuppelVideoRecorder.h"
 #include "mythplayer.h"
@@ -506,6 +508,13 @@ class Cutter
     }
 };
 
+static void TranscodeWriteText(void *ptr, unsigned char *buf, int len,
+                               int timecode, int pagenr)
+{
+    NuppelVideoRecorder *nvr = (NuppelVideoRecorder *)ptr;
+    nvr->WriteText(buf, len, timecode, pagenr);
+}
+
 typedef struct transcodeFrameInfo
 {
     VideoFrame *frame;
@@ -521,7 +530,10 @@ class TranscodeFrameQueue : public QRunnable
       : m_player(player),         m_videoOutput(videoout),
         m_honorCutlist(cutlist),
         m_eof(false),             m_maxFrames(size),
-        m_runThread(true),        m_isRunning(false)
+        m_runThread(true),        m_isRunning(false),
+        m_framesQueued(0),        m_depthTotal(0),
+        m_maxDepth(0),            m_decodeTime(0),
+        m_fullWaitTime(0),        m_emptyWaitTime(0)
     {
 
     }
@@ -550,6 +562,9 @@ class TranscodeFrameQueue : public QRunnable
 
         frm_dir_map_t::iterator dm_iter;
 
+        MythTimer timer;
+        timer.start();
+
         m_isRunning = true;
         while (m_runThread)
         {
@@ -560,13 +575,18 @@ class TranscodeFrameQueue : public QRunnable
                 tfInfo.didFF = 0;
                 tfInfo.isKey = false;
 
+                timer.restart();
                 if (m_player->TranscodeGetNextFrame(dm_iter, tfInfo.didFF,
                     tfInfo.isKey, m_honorCutlist))
                 {
+                    m_decodeTime += timer.elapsed();
                     tfInfo.frame = m_videoOutput->GetLastDecodedFrame();
 
                     QMutexLocker locker(&m_queueLock);
                     m_frameList.append(tfInfo);
+                    m_framesQueued++;
+                    m_depthTotal += m_frameList.size();
+                    m_maxDepth = max(m_maxDepth, m_frameList.size());
                 }
                 else
                 {
@@ -577,11 +597,26 @@ class TranscodeFrameQueue : public QRunnable
             }
             else
             {
+                timer.restart();
                 m_frameWaitLock.lock();
                 m_frameWaitCond.wait(&m_frameWaitLock);
                 m_frameWaitLock.unlock();
+                m_fullWaitTime += timer.elapsed();
             }
         }
+
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Decode stage: %1 frames in %2 s (%3 fps), "
+                    "queue depth avg %4 max %5 of %6, "
+                    "stalled on full queue %7 s, consumer waited %8 s")
+                .arg(m_framesQueued).arg(m_decodeTime / 1000.0)
+                .arg(m_decodeTime ? m_framesQueued * 1000.0 / m_decodeTime : 0)
+                .arg(m_framesQueued ?
+                     (double)m_depthTotal / m_framesQueued : 0, 0, 'f', 1)
+                .arg(m_maxDepth).arg(m_maxFrames)
+                .arg(m_fullWaitTime / 1000.0)
+                .arg(m_emptyWaitTime / 1000.0));
+
         m_isRunning = false;
 
         threadDeregister();
@@ -598,9 +633,12 @@ class TranscodeFrameQueue : public QRunnable
         {
             m_queueLock.unlock();
 
+            MythTimer timer;
+            timer.start();
             m_frameWaitLock.lock();
             m_frameWaitCond.wait(&m_frameWaitLock);
             m_frameWaitLock.unlock();
+            m_emptyWaitTime += timer.elapsed();
 
             if (m_frameList.isEmpty())
                 return NULL;
@@ -630,6 +668,368 @@ class TranscodeFrameQueue : public QRunnable
     QList<TranscodeFrameInfo> m_frameList;
     QWaitCondition            m_frameWaitCond;
     QMutex                    m_frameWaitLock;
+
+    // Statistics, reported when the thread exits
+    long                      m_framesQueued;
+    long long                 m_depthTotal;
+    int                       m_maxDepth;
+    long long                 m_decodeTime;
+    long long                 m_fullWaitTime;
+    long long                 m_emptyWaitTime;
+};
+
+typedef enum
+{
+    kTranscodeWriteVideo = 0,
+    kTranscodeWriteAudio,
+    kTranscodeWriteText,
+} TranscodeWriteType;
+
+typedef struct transcodeWriteItem
+{
+    TranscodeWriteType  type;
+    unsigned char      *buf;
+    int                 len;
+    int                 frameNumber;
+    long long           timecode;
+    VideoFrame         *shared;   ///< decoded frame buf points into, or NULL
+} TranscodeWriteItem;
+
+// The write queue moves encoding and muxing off the main transcode loop.
+// Audio and video are queued in the order they would have been written,
+// so the output interleaving is the same as when writing synchronously.
+class TranscodeWriteQueue : public QRunnable
+{
+  public:
+    TranscodeWriteQueue(MythPlayer *player, VideoFrame *frameTemplate,
+                        AVFormatWriter *avfw, AVFormatWriter *avfw2,
+                        NuppelVideoRecorder *nvr, HTTPLiveStream *hls,
+                        int hlsSegmentSize, bool forceKeyFrames,
+                        int size = 8)
+      : m_player(player),         m_avfw(avfw),
+        m_avfw2(avfw2),           m_nvr(nvr),
+        m_hls(hls),               m_hlsSegmentSize(hlsSegmentSize),
+        m_hlsSegmentFrames(0),    m_forceKeyFrames(forceKeyFrames),
+        m_maxItems(size),         m_finish(false),
+        m_abort(false),           m_busy(false),
+        m_isRunning(true),        m_errored(0),
+        m_videoFrames(0),         m_audioFrames(0),
+        m_sharedFrames(0),        m_depthTotal(0),          m_maxDepth(0),
+        m_writeTime(0),           m_fullWaitTime(0)
+    {
+        m_frame = *frameTemplate;
+        m_frame.buf = NULL;
+    }
+
+    ~TranscodeWriteQueue()
+    {
+        while (!m_freeBuffers.isEmpty())
+            delete [] m_freeBuffers.takeFirst();
+    }
+
+    /// Waits until everything queued so far has been written.
+    void Flush(void)
+    {
+        QMutexLocker locker(&m_queueLock);
+        while (m_isRunning && (m_busy || !m_itemList.isEmpty()))
+            m_queueWaitCond.wait(&m_queueLock);
+    }
+
+    /// Writes out everything queued and stops the thread.
+    void stop(void)
+    {
+        m_queueLock.lock();
+        m_finish = true;
+        m_queueWaitCond.wakeAll();
+        m_queueLock.unlock();
+
+        while (m_isRunning)
+            usleep(50000);
+    }
+
+    /// Stops the thread, throwing away anything not yet written.
+    void abort(void)
+    {
+        m_queueLock.lock();
+        m_abort = true;
+        m_queueWaitCond.wakeAll();
+        m_queueLock.unlock();
+
+        while (m_isRunning)
+            usleep(50000);
+    }
+
+    bool IsErrored(void) { return m_errored.fetchAndAddAcquire(0); }
+
+    /// Queues a video frame. If frame->buf is the buffer of the decoded
+    /// frame and the player lets us share it, it is written from there
+    /// instead of being copied.
+    void AddVideo(const VideoFrame *frame, VideoFrame *decoded = NULL)
+    {
+        TranscodeWriteItem item;
+        item.type        = kTranscodeWriteVideo;
+        item.len         = frame->size;
+        item.frameNumber = frame->frameNumber;
+        item.timecode    = frame->timecode;
+        item.shared      = NULL;
+
+        if (decoded && (decoded->buf == frame->buf) &&
+            m_player->ShareVideoFrame(decoded))
+        {
+            item.buf    = frame->buf;
+            item.shared = decoded;
+        }
+        else
+        {
+            item.buf = GetBuffer(item.len);
+            memcpy(item.buf, frame->buf, item.len);
+            m_player->GetVideoOutput()->CountFrameCopy(item.len);
+        }
+        Enqueue(item);
+    }
+
+    void AddAudio(const unsigned char *buf, int len, int fnum,
+                  long long timecode)
+    {
+        TranscodeWriteItem item;
+        item.type        = kTranscodeWriteAudio;
+        item.len         = len;
+        item.buf         = new unsigned char[len];
+        item.frameNumber = fnum;
+        item.timecode    = timecode;
+        item.shared      = NULL;
+        memcpy(item.buf, buf, len);
+        Enqueue(item);
+    }
+
+    void AddText(void)
+    {
+        TranscodeWriteItem item;
+        item.type        = kTranscodeWriteText;
+        item.len         = 0;
+        item.buf         = NULL;
+        item.frameNumber = 0;
+        item.timecode    = 0;
+        item.shared      = NULL;
+        Enqueue(item);
+    }
+
+    void run()
+    {
+        threadRegister("TranscodeWriteQueue");
+
+        MythTimer timer;
+        timer.start();
+
+        while (true)
+        {
+            m_queueLock.lock();
+            m_busy = false;
+            m_queueWaitCond.wakeAll();
+            while (m_itemList.isEmpty() && !m_finish && !m_abort)
+                m_queueWaitCond.wait(&m_queueLock);
+
+            if (m_abort || m_itemList.isEmpty())
+            {
+                m_queueLock.unlock();
+                break;
+            }
+
+            TranscodeWriteItem item = m_itemList.takeFirst();
+            m_busy = true;
+            m_queueWaitCond.wakeAll();
+            m_queueLock.unlock();
+
+            timer.restart();
+            if (!m_errored.fetchAndAddAcquire(0))
+                Write(item);
+            m_writeTime += timer.elapsed();
+
+            ReleaseItem(item);
+        }
+
+        while (!m_itemList.isEmpty())
+            ReleaseItem(m_itemList.takeFirst());
+
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Encode stage: %1 video (%2 without a copy) and %3 audio "
+                    "frames in %4 s (%5 fps), queue depth avg %6 max %7 of %8, "
+                    "producer stalled on full queue %9 s")
+                .arg(m_videoFrames).arg(m_sharedFrames).arg(m_audioFrames)
+                .arg(m_writeTime / 1000.0)
+                .arg(m_writeTime ? m_videoFrames * 1000.0 / m_writeTime : 0)
+                .arg((m_videoFrames + m_audioFrames) ?
+                     (double)m_depthTotal / (m_videoFrames + m_audioFrames) :
+                     0, 0, 'f', 1)
+                .arg(m_maxDepth).arg(m_maxItems)
+                .arg(m_fullWaitTime / 1000.0));
+
+        m_queueLock.lock();
+        m_isRunning = false;
+        m_queueWaitCond.wakeAll();
+        m_queueLock.unlock();
+
+        threadDeregister();
+    }
+
+  private:
+    unsigned char *GetBuffer(int len)
+    {
+        QMutexLocker locker(&m_queueLock);
+        if (!m_freeBuffers.isEmpty())
+            return m_freeBuffers.takeFirst();
+        return new unsigned char[len];
+    }
+
+    void ReleaseItem(const TranscodeWriteItem &item)
+    {
+        if (item.shared)
+        {
+            m_player->UnshareVideoFrame(item.shared);
+        }
+        else if (item.type == kTranscodeWriteVideo)
+        {
+            QMutexLocker locker(&m_queueLock);
+            m_freeBuffers.append(item.buf);
+        }
+        else
+            delete [] item.buf;
+    }
+
+    void Enqueue(const TranscodeWriteItem &item)
+    {
+        QMutexLocker locker(&m_queueLock);
+
+        if (m_itemList.size() >= m_maxItems)
+        {
+            MythTimer timer;
+            timer.start();
+            while (m_isRunning && !m_abort &&
+                   m_itemList.size() >= m_maxItems)
+                m_queueWaitCond.wait(&m_queueLock);
+            m_fullWaitTime += timer.elapsed();
+        }
+
+        m_itemList.append(item);
+        m_depthTotal += m_itemList.size();
+        m_maxDepth = max(m_maxDepth, m_itemList.size());
+        m_queueWaitCond.wakeAll();
+    }
+
+    void Write(TranscodeWriteItem &item)
+    {
+        if (item.type == kTranscodeWriteText)
+        {
+            if (m_nvr)
+                m_player->GetCC608Reader()->
+                    TranscodeWriteText(&TranscodeWriteText, (void *)(m_nvr));
+            return;
+        }
+
+        if (item.type == kTranscodeWriteAudio)
+        {
+            m_audioFrames++;
+
+            if (m_avfw)
+            {
+                m_avfw->WriteAudioFrame(item.buf, item.frameNumber,
+                                        item.timecode);
+
+                if (m_avfw2)
+                {
+                    if ((m_avfw2->GetTimecodeOffset() == -1) &&
+                        (m_avfw->GetTimecodeOffset() != -1))
+                    {
+                        m_avfw2->SetTimecodeOffset(
+                            m_avfw->GetTimecodeOffset());
+                    }
+
+                    m_avfw2->WriteAudioFrame(item.buf, item.frameNumber,
+                                             item.timecode);
+                }
+            }
+            else
+            {
+                m_nvr->SetOption("audioframesize", item.len);
+                m_nvr->WriteAudio(item.buf, item.frameNumber, item.timecode);
+                if (m_nvr->IsErrored())
+                {
+                    LOG(VB_GENERAL, LOG_ERR,
+                        "Transcode: Encountered irrecoverable error in "
+                        "NVR::WriteAudio");
+                    m_errored.fetchAndStoreRelease(1);
+                }
+            }
+            return;
+        }
+
+        m_videoFrames++;
+        if (item.shared)
+            m_sharedFrames++;
+
+        m_frame.buf         = item.buf;
+        m_frame.size        = item.len;
+        m_frame.frameNumber = item.frameNumber;
+        m_frame.timecode    = item.timecode;
+
+        if (m_avfw)
+        {
+            if ((m_hls) &&
+                (m_avfw->GetFramesWritten()) &&
+                (m_hlsSegmentFrames > m_hlsSegmentSize) &&
+                (m_avfw->NextFrameIsKeyFrame()))
+            {
+                m_hls->AddSegment();
+                m_avfw->ReOpen(m_hls->GetCurrentFilename());
+
+                if (m_avfw2)
+                    m_avfw2->ReOpen(m_hls->GetCurrentFilename(true));
+
+                m_hlsSegmentFrames = 0;
+            }
+
+            m_avfw->WriteVideoFrame(&m_frame);
+            ++m_hlsSegmentFrames;
+        }
+        else
+        {
+            if (m_forceKeyFrames)
+                m_nvr->WriteVideo(&m_frame, true, true);
+            else
+                m_nvr->WriteVideo(&m_frame);
+        }
+
+        m_frame.buf = NULL;
+    }
+
+    MythPlayer                *m_player;
+    AVFormatWriter            *m_avfw;
+    AVFormatWriter            *m_avfw2;
+    NuppelVideoRecorder       *m_nvr;
+    HTTPLiveStream            *m_hls;
+    int                        m_hlsSegmentSize;
+    int                        m_hlsSegmentFrames;
+    bool                       m_forceKeyFrames;
+    VideoFrame                 m_frame;
+    int                        m_maxItems;
+    bool                       m_finish;
+    bool                       m_abort;
+    bool                       m_busy;
+    bool                       m_isRunning;
+    QAtomicInt                 m_errored;
+    QMutex                     m_queueLock;
+    QWaitCondition             m_queueWaitCond;
+    QList<TranscodeWriteItem>  m_itemList;
+    QList<unsigned char*>      m_freeBuffers;
+
+    // Statistics, reported when the thread exits
+    long                       m_videoFrames;
+    long                       m_audioFrames;
+    long                       m_sharedFrames;
+    long long                  m_depthTotal;
+    int                        m_maxDepth;
+    long long                  m_writeTime;
+    long long                  m_fullWaitTime;
 };
 
 Transcode::Transcode(ProgramInfo *pginfo) :
@@ -776,13 +1176,6 @@ static int get_int_option(RecordingProfile &profile, const QString &name)
     return ret_int;
 }
 
-static void TranscodeWriteText(void *ptr, unsigned char *buf, int len,
-                               int timecode, int pagenr)
-{
-    NuppelVideoRecorder *nvr = (NuppelVideoRecorder *)ptr;
-    nvr->WriteText(buf, len, timecode, pagenr);
-}
-
 int Transcode::TranscodeFile(const QString &inputname,
                              const QString &outputname,
                              const QString &profileName,
@@ -801,7 +1194,6 @@ int Transcode::TranscodeFile(const QString &inputname,
     AVFormatWriter *avfw2 = NULL;
     HTTPLiveStream *hls = NULL;
     int hlsSegmentSize = 0;
-    int hlsSegmentFrames = 0;
 
     if (jobID >= 0)
         JobQueue::ChangeJobComment(jobID, "0% " + QObject::tr("Completed"));
@@ -1531,9 +1923,16 @@ int Transcode::TranscodeFile(const QString &inputname,
         new TranscodeFrameQueue(player, videoOutput, honorCutList);
     MThreadPool::globalInstance()->start(frameQueue, "TranscodeFrameQueue");
 
+    // Created on the first re-encoded frame, see below.
+    TranscodeWriteQueue *writeQueue = NULL;
+
     QTime flagTime;
     flagTime.start();
 
+    MythTimer stageTimer;
+    long long processTime = 0;
+    long processFrames = 0;
+
     if (cleanCut)
         cutter.Activate(vidFrameTime * rateTimeConv, total_frame_count);
 
@@ -1552,6 +1951,8 @@ int Transcode::TranscodeFile(const QString &inputname,
             first_loop = false;
         }
 
+        stageTimer.start();
+
         float new_aspect = lastDecode->aspect;
 
         cutter.NewFrame(lastDecode->frameNumber);
@@ -1775,6 +2176,29 @@ int Transcode::TranscodeFile(const QString &inputname,
         }
         else
         {
+            if (!writeQueue)
+            {
+                writeQueue = new TranscodeWriteQueue(
+                    player, &frame, avfw, avfw2, nvr, hls, hlsSegmentSize,
+                    forceKeyFrames);
+                writeQueue->setAutoDelete(false);
+                MThreadPool::globalInstance()->start(writeQueue,
+                                                     "TranscodeWriteQueue");
+            }
+
+            if (writeQueue->IsErrored())
+            {
+                unlink(outputname.toLocal8Bit().constData());
+                delete [] newFrame;
+                writeQueue->abort();
+                delete writeQueue;
+                if (player_ctx)
+                    delete player_ctx;
+                if (frameQueue)
+                    frameQueue->stop();
+                return REENCODE_ERROR;
+            }
+
             if (did_ff == 1)
             {
                 did_ff = 2;
@@ -1786,7 +2210,10 @@ int Transcode::TranscodeFile(const QString &inputname,
             {
                 video_aspect = new_aspect;
                 if (nvr)
+                {
+                    writeQueue->Flush();
                     nvr->SetNewVideoParams(video_aspect);
+                }
             }
 
 
@@ -1838,52 +2265,12 @@ int Transcode::TranscodeFile(const QString &inputname,
                     if (arb->ab[loop].time > frame.timecode)
                         break;
 
-                    if (avfMode)
-                    {
-                        if (did_ff != 1)
-                        {
-                            avfw->WriteAudioFrame(
-                                arb->audiobuffer + arb->ab[loop].offset,
-                                audioFrame,
-                                arb->ab[loop].time - timecodeOffset);
-
-                            if (avfw2)
-                            {
-                                if ((avfw2->GetTimecodeOffset() == -1) &&
-                                    (avfw->GetTimecodeOffset() != -1))
-                                {
-                                    avfw2->SetTimecodeOffset(
-                                        avfw->GetTimecodeOffset());
-                                }
-
-                                avfw2->WriteAudioFrame(
-                                    arb->audiobuffer + arb->ab[loop].offset,
-                                    audioFrame,
-                                    arb->ab[loop].time - timecodeOffset);
-                            }
-
-                            ++audioFrame;
-                        }
-                    }
-                    else
+                    if (!avfMode || did_ff != 1)
                     {
-                        nvr->SetOption("audioframesize", arb->ab[loop].len);
-                        nvr->WriteAudio(arb->audiobuffer + arb->ab[loop].offset,
-                                        audioFrame++,
-                                        arb->ab[loop].time - timecodeOffset);
-                        if (nvr->IsErrored())
-                        {
-                            LOG(VB_GENERAL, LOG_ERR,
-                                "Transcode: Encountered irrecoverable error in "
-                                "NVR::WriteAudio");
-
-                            delete [] newFrame;
-                            if (player_ctx)
-                                delete player_ctx;
-                            if (frameQueue)
-                                frameQueue->stop();
-                            return REENCODE_ERROR;
-                        }
+                        writeQueue->AddAudio(
+                            arb->audiobuffer + arb->ab[loop].offset,
+                            arb->ab[loop].len, audioFrame++,
+                            arb->ab[loop].time - timecodeOffset);
                     }
 
                     ++buffersConsumed;
@@ -1917,8 +2304,7 @@ int Transcode::TranscodeFile(const QString &inputname,
             }
 
             if (!avfMode)
-                player->GetCC608Reader()->
-                    TranscodeWriteText(&TranscodeWriteText, (void *)(nvr));
+                writeQueue->AddText();
             lasttimecode = frame.timecode;
             frame.timecode -= timecodeOffset;
 
@@ -1931,33 +2317,18 @@ int Transcode::TranscodeFile(const QString &inputname,
                 else
                 {
                     skippedLastFrame = false;
-
-                    if ((hls) &&
-                        (avfw->GetFramesWritten()) &&
-                        (hlsSegmentFrames > hlsSegmentSize) &&
-                        (avfw->NextFrameIsKeyFrame()))
-                    {
-                        hls->AddSegment();
-                        avfw->ReOpen(hls->GetCurrentFilename());
-
-                        if (avfw2)
-                            avfw2->ReOpen(hls->GetCurrentFilename(true));
-
-                        hlsSegmentFrames = 0;
-                    }
-
-                    avfw->WriteVideoFrame(&frame);
-                    ++hlsSegmentFrames;
+                    writeQueue->AddVideo(&frame, lastDecode);
                 }
             }
             else
             {
-                if (forceKeyFrames)
-                    nvr->WriteVideo(&frame, true, true);
-                else
-                    nvr->WriteVideo(&frame);
+                writeQueue->AddVideo(&frame, lastDecode);
             }
         }
+
+        processTime += stageTimer.elapsed();
+        processFrames++;
+
         if (QDateTime::currentDateTime() > statustime)
         {
             if (showprogress)
@@ -1987,6 +2358,11 @@ int Transcode::TranscodeFile(const QString &inputname,
 
                 unlink(outputname.toLocal8Bit().constData());
                 delete [] newFrame;
+                if (writeQueue)
+                {
+                    writeQueue->abort();
+                    delete writeQueue;
+                }
                 if (player_ctx)
                     delete player_ctx;
                 if (frameQueue)
@@ -2003,6 +2379,11 @@ int Transcode::TranscodeFile(const QString &inputname,
 
                     unlink(outputname.toLocal8Bit().constData());
                     delete [] newFrame;
+                    if (writeQueue)
+                    {
+                        writeQueue->abort();
+                        delete writeQueue;
+                    }
                     if (player_ctx)
                         delete player_ctx;
                     if (frameQueue)
@@ -2042,6 +2423,36 @@ int Transcode::TranscodeFile(const QString &inputname,
 
     sws_freeContext(scontext);
 
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Process stage: %1 frames in %2 s (%3 fps)")
+            .arg(processFrames).arg(processTime / 1000.0)
+            .arg(processTime ? processFrames * 1000.0 / processTime : 0));
+
+    bool writeErrored = false;
+    if (writeQueue)
+    {
+        writeQueue->stop();
+        writeErrored = writeQueue->IsErrored();
+        delete writeQueue;
+    }
+
+    if (writeErrored)
+    {
+        unlink(outputname.toLocal8Bit().constData());
+        delete [] newFrame;
+        if (avfw)
+            delete avfw;
+        if (avfw2)
+            delete avfw2;
+        if (hls)
+            delete hls;
+        if (player_ctx)
+            delete player_ctx;
+        if (frameQueue)
+            frameQueue->stop();
+        return REENCODE_ERROR;
+    }
+
     if (! fifow)
     {
         if (avfw)
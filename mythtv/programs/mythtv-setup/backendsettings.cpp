@@ -227,6 +227,21 @@ static HostCheckBox *DisableFirewireReset()
     return hc;
 }
 
+static HostCheckBox *PreviewGeneratorInProcess()
+{
+    HostCheckBox *hc = new HostCheckBox("PreviewGeneratorInProcess");
+    hc->setLabel(QObject::tr("Generate previews in the backend process"));
+    hc->setHelpText(
+        QObject::tr(
+            "If enabled, preview images are decoded by the backend "
+            "itself instead of by starting mythpreviewgen for each "
+            "preview. This is much faster when many previews are "
+            "needed at once, but a damaged recording that crashes the "
+            "decoder will then take the backend down with it."));
+    hc->setValue(false);
+    return hc;
+}
+
 static HostLineEdit *MiscStatusScript()
 {
     HostLineEdit *he = new HostLineEdit("MiscStatusScript");
@@ -626,6 +641,29 @@ static GlobalCheckBox *AutoCommflagWhileRecording()
     return gc;
 };
 
+static GlobalCheckBox *AutoTrickplayIndex()
+{
+    GlobalCheckBox *gc = new GlobalCheckBox("AutoTrickplayIndex");
+    gc->setLabel(QObject::tr("Build trickplay indexes after recording"));
+    gc->setValue(false);
+    gc->setHelpText(QObject::tr("If enabled, a job will be queued at the end "
+                                "of each recording to save small images of "
+                                "it every few seconds, so that frontends can "
+                                "show previews while seeking without "
+                                "decoding the recording."));
+    return gc;
+};
+
+static GlobalSpinBox *TrickplayInterval()
+{
+    GlobalSpinBox *gs = new GlobalSpinBox("TrickplayInterval", 1, 60, 1);
+    gs->setLabel(QObject::tr("Trickplay image interval (seconds)"));
+    gs->setValue(10);
+    gs->setHelpText(QObject::tr("The number of seconds between the images "
+                                "saved in a trickplay index."));
+    return gs;
+};
+
 static GlobalLineEdit *UserJob(uint job_num)
 {
     GlobalLineEdit *gc = new GlobalLineEdit(QString("UserJob%1").arg(job_num));
@@ -666,6 +704,16 @@ static HostCheckBox *JobAllowCommFlag()
     return gc;
 };
 
+static HostCheckBox *JobAllowTrickplay()
+{
+    HostCheckBox *gc = new HostCheckBox("JobAllowTrickplay");
+    gc->setLabel(QObject::tr("Allow trickplay index jobs"));
+    gc->setValue(true);
+    gc->setHelpText(QObject::tr("If enabled, allow jobs of this type to "
+                                "run on this backend."));
+    return gc;
+};
+
 static HostCheckBox *JobAllowTranscode()
 {
     HostCheckBox *gc = new HostCheckBox("JobAllowTranscode");
@@ -905,6 +953,7 @@ BackendSettings::BackendSettings() {
     group2->addChild(MiscStatusScript());
     group2->addChild(DisableAutomaticBackup());
     group2->addChild(DisableFirewireReset());
+    group2->addChild(PreviewGeneratorInProcess());
     addChild(group2);
 
     VerticalConfigurationGroup* group2a1 = new VerticalConfigurationGroup(false);
@@ -965,6 +1014,7 @@ BackendSettings::BackendSettings() {
     group5a1->addChild(JobAllowMetadata());
     group5a1->addChild(JobAllowCommFlag());
     group5a1->addChild(JobAllowTranscode());
+    group5a1->addChild(JobAllowTrickplay());
     group5a->addChild(group5a1);
 
     VerticalConfigurationGroup* group5a2 =
@@ -985,6 +1035,8 @@ BackendSettings::BackendSettings() {
     group6->addChild(JobQueueTranscodeCommand());
     group6->addChild(AutoTranscodeBeforeAutoCommflag());
     group6->addChild(SaveTranscoding());
+    group6->addChild(AutoTrickplayIndex());
+    group6->addChild(TrickplayInterval());
     addChild(group6);
 
     VerticalConfigurationGroup* group7 = new VerticalConfigurationGroup(false);
@@ -437,6 +437,7 @@ int main(int argc, char *argv[])
                 /* follow_nit */            true,
                 /* test decryption */       true,
                 scanFTAOnly,
+                /* use all inputs */        false,
                 scanServiceRequirements,
                 // stuff needed for particular scans
                 /* mplexid   */ 0,
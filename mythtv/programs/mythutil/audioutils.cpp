@@ -0,0 +1,199 @@
+// POSIX headers
+#include <sys/time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include <unistd.h>
+
+// C++ headers
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+// libmyth* headers
+#include "exitcodes.h"
+#include "mythlogging.h"
+#include "mythtimer.h"
+#include "audiooutput.h"
+#include "audiooutpututil.h"
+
+// local headers
+#include "audioutils.h"
+
+static const int kBenchRate   = 48000;
+/// Frames handed to AddData() at a time, 1/10th of a second.
+static const int kBenchChunk  = kBenchRate / 10;
+
+static int64_t cpu_usecs(void)
+{
+#ifndef _WIN32
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (int64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+           ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#else
+    return 0;
+#endif
+}
+
+/// Times the sample conversion and volume kernels on one chunk.
+static void BenchKernels(int channels, int passes)
+{
+    int samples = kBenchChunk * channels;
+    // The SSE toFloat kernels need 16 byte aligned buffers
+    char  *floatbuf = new char[samples * 4 + 16];
+    char  *shortbuf = new char[samples * 2 + 16];
+    float *floats   = (float*)(((intptr_t)floatbuf + 15) & ~(intptr_t)15);
+    short *shorts   = (short*)(((intptr_t)shortbuf + 15) & ~(intptr_t)15);
+    for (int i = 0; i < samples; i++)
+        shorts[i] = (short)((rand() & 0xffff) - 0x8000);
+
+    MythTimer timer;
+    int to_ms = 0, from_ms = 0, vol_ms = 0;
+
+    timer.start();
+    for (int p = 0; p < passes; p++)
+        AudioOutputUtil::toFloat(FORMAT_S16, floats, shorts, samples * 2);
+    to_ms = timer.restart();
+    for (int p = 0; p < passes; p++)
+        AudioOutputUtil::fromFloat(FORMAT_S16, shorts, floats, samples * 4);
+    from_ms = timer.restart();
+    for (int p = 0; p < passes; p++)
+        AudioOutputUtil::AdjustVolume(floats, samples * 4, 80, false, false);
+    vol_ms = timer.elapsed();
+
+    double secs = (double)passes * kBenchChunk / kBenchRate;
+    cout << QString("%1 channel kernels, ms per second of audio: "
+                    "S16->float %2, float->S16 %3, volume %4")
+                .arg(channels)
+                .arg(to_ms / secs, 0, 'f', 3)
+                .arg(from_ms / secs, 0, 'f', 3)
+                .arg(vol_ms / secs, 0, 'f', 3)
+                .toLocal8Bit().constData() << endl;
+
+    delete[] floatbuf;
+    delete[] shortbuf;
+}
+
+/** \brief Plays generated S16 audio through AudioOutputNULL and prints
+ *         how much CPU the output pipeline used.
+ *
+ *   The NULL output buffers what it plays, and the benchmark reads it
+ *   back as fast as it can, so the whole decoder side to output thread
+ *   path runs, with down or upmixing, timestretch, volume and float
+ *   conversion as configured, but without a sound card setting the
+ *   pace.
+ */
+static int AudioBench(const MythUtilCommandLineParser &cmdline)
+{
+    int    channels    = cmdline.toInt("channels");
+    int    outchannels = cmdline.toInt("outchannels");
+    int    seconds     = max(cmdline.toInt("seconds"), 1);
+    double stretch     = cmdline.toDouble("stretch");
+
+    if ((channels < 1) || (channels > 8) ||
+        (outchannels < 1) || (outchannels > 8))
+    {
+        LOG(VB_GENERAL, LOG_ERR, "--channels and --outchannels must be "
+                                 "between 1 and 8");
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
+    if ((stretch < 0.5) || (stretch > 2.0))
+    {
+        LOG(VB_GENERAL, LOG_ERR, "--stretch must be between 0.5 and 2.0");
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
+
+    BenchKernels(channels, 10 * seconds);
+
+    // A "sound card" with only the channels asked for, so that the
+    // source is down or upmixed to them.
+    AudioOutputSettings *custom = new AudioOutputSettings();
+    custom->AddSupportedRate(kBenchRate);
+    custom->AddSupportedFormat(FORMAT_S16);
+    custom->AddSupportedChannels(outchannels);
+    custom->setPassthrough(-1);
+
+    AudioSettings settings("NULL", "", FORMAT_S16, channels, 0, kBenchRate,
+                           AUDIOOUTPUT_VIDEO, false, false, 0, custom);
+    settings.init = false;
+
+    AudioOutput *audio = AudioOutput::OpenAudio(settings, false);
+    if (!audio)
+    {
+        LOG(VB_GENERAL, LOG_ERR, "Could not create the NULL audio output");
+        delete custom;
+        return GENERIC_EXIT_NOT_OK;
+    }
+    audio->bufferOutputData(true);
+    audio->Reconfigure(settings);
+    if (!audio->GetError().isEmpty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Could not open the NULL audio "
+                                         "output: %1").arg(audio->GetError()));
+        delete audio;
+        delete custom;
+        return GENERIC_EXIT_NOT_OK;
+    }
+    if (cmdline.toBool("upmix") && !audio->IsUpmixing() && audio->CanUpmix())
+        audio->ToggleUpmix();
+    if (stretch != 1.0)
+        audio->SetStretchFactor(stretch);
+
+    int chunk_bytes = kBenchChunk * channels * 2;
+    short *chunk = new short[kBenchChunk * channels];
+    for (int i = 0; i < kBenchChunk * channels; i++)
+        chunk[i] = (short)((rand() & 0x3fff) - 0x2000);
+    unsigned char *out = new unsigned char[65536];
+
+    int64_t  total  = (int64_t)seconds * kBenchRate;
+    int64_t  added  = 0;
+    uint64_t played = 0;
+    int64_t  cpu    = cpu_usecs();
+    MythTimer timer;
+    timer.start();
+
+    while (added < total)
+    {
+        int64_t timecode = added * 1000 / kBenchRate;
+        if (audio->AddData(chunk, chunk_bytes, timecode, kBenchChunk))
+            added += kBenchChunk;
+
+        int len;
+        while ((len = audio->readOutputData(out, 65536)) > 0)
+            played += len;
+        if (!len)
+            usleep(500);
+    }
+
+    int wall_ms = max(timer.elapsed(), 1);
+    cpu = cpu_usecs() - cpu;
+
+    cout << QString("%1 seconds of %2 channel audio to %3 channels%4%5: "
+                    "%6 ms, %7x realtime, %8% CPU at realtime, "
+                    "%9 bytes played")
+                .arg(seconds).arg(channels).arg(outchannels)
+                .arg(audio->IsUpmixing() ? ", upmixed" : "")
+                .arg((stretch != 1.0) ?
+                     QString(", stretch %1").arg(stretch) : QString())
+                .arg(wall_ms)
+                .arg(seconds * 1000.0 / wall_ms, 0, 'f', 1)
+                .arg(cpu / (seconds * 10000.0), 0, 'f', 2)
+                .arg(played)
+                .toLocal8Bit().constData() << endl;
+
+    delete audio;
+    delete custom;
+    delete[] chunk;
+    delete[] out;
+
+    return GENERIC_EXIT_OK;
+}
+
+void registerAudioUtils(UtilMap &utilMap)
+{
+    utilMap["audiobench"]              = &AudioBench;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -107,6 +107,48 @@ void MythUtilCommandLineParser::LoadArguments(void)
                 ->SetRequires("chanid")
                 ->SetRequires("starttime")
 
+        // audioutils.cpp
+        << add("--audiobench", "audiobench", false,
+                "Time the audio output pipeline.",
+                "Plays generated audio through the NULL audio output, "
+                "with down or upmixing and timestretch as asked for, and "
+                "prints the time the sample conversion kernels and the "
+                "whole pipeline take.")
+                ->SetGroup("Audio")
+
+        // eitutils.cpp
+        << add("--eitfixupbench", "eitfixupbench", false,
+                "Time the EIT fixups and check their output.",
+                "Replays EIT events dumped by a backend run with "
+                "MYTHTV_EIT_DUMP=<file> through the fixups, and prints "
+                "the time each fixup profile takes. The fixed up events "
+                "can be saved with --outfile and compared against an "
+                "earlier --outfile with --reffile.")
+                ->SetGroup("EIT")
+                ->SetRequiredChild("infile")
+
+        // videoutils.cpp
+        << add("--filterbench", "filterbench", "",
+                "Time a video filter chain at one to N threads.",
+                "Runs the given filter chain (ie, yadifdeint) over raw "
+                "YV12 frames read from --infile, once at each thread "
+                "count from one to --threads, and prints the frame rate "
+                "of each run. Both fields of each frame are filtered.")
+                ->SetGroup("Video")
+                ->SetRequiredChild("infile")
+        << add("--osdbench", "osdbench", false,
+                "Time blending the OSD onto video frames.",
+                "Blends a progress bar and subtitles onto YV12 frames "
+                "the way software playback does and prints the time "
+                "per frame.")
+                ->SetGroup("Video")
+        << add("--imgconvbench", "imgconvbench", false,
+                "Time pixel format conversions.",
+                "Converts between YV12, I420, RGB32 and NV12 at SD, 720p "
+                "and 1080p, on one thread and sliced across threads, and "
+                "prints the time per frame of each.")
+                ->SetGroup("Video")
+
         // messageutils.cpp
         << add("--message", "message", false,
                 "Display a message on a frontend", "")
@@ -135,6 +177,40 @@ void MythUtilCommandLineParser::LoadArguments(void)
     add("--bcastaddr", "bcastaddr", "127.0.0.1", "(optional) IP address to send to", "")
         ->SetChildOf("message");
 
+    // audioutils.cpp
+    add("--channels", "channels", 6, "Channels of the source audio", "")
+        ->SetChildOf("audiobench");
+    add("--outchannels", "outchannels", 2,
+            "Channels the output supports", "")
+        ->SetChildOf("audiobench");
+    add("--upmix", "upmix", false, "Upmix stereo sources", "")
+        ->SetChildOf("audiobench");
+    add("--stretch", "stretch", 1.0, "Timestretch factor", "")
+        ->SetChildOf("audiobench");
+    add("--seconds", "seconds", 60, "Seconds of audio to play", "")
+        ->SetChildOf("audiobench");
+
+    // videoutils.cpp
+    add("--width", "width", 1920, "Width of the video frames", "")
+        ->SetChildOf(QStringList() << "filterbench" << "osdbench");
+    add("--height", "height", 1080, "Height of the video frames", "")
+        ->SetChildOf(QStringList() << "filterbench" << "osdbench");
+    add("--threads", "threads", 0,
+            "Most threads to test, defaults to the number of CPUs", "")
+        ->SetChildOf("filterbench");
+    add("--passes", "passes", 1,
+            "Number of times to run over the frames", "")
+        ->SetChildOf(QStringList() << "filterbench" << "osdbench"
+                                   << "imgconvbench" << "eitfixupbench");
+    add("--compare", "compare", false,
+            "Compare the output of the C and SIMD filter kernels", "")
+        ->SetChildOf("filterbench");
+
+    // eitutils.cpp
+    add("--reffile", "reffile", "",
+            "Earlier --outfile to compare the fixed up events with", "")
+        ->SetChildOf("eitfixupbench");
+
     // Generic Options used by more than one utility
     addRecording();
     addInFile(true);
@@ -0,0 +1,248 @@
+// POSIX headers
+#include <sys/time.h>
+
+// C++ headers
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+// Qt headers
+#include <QDataStream>
+#include <QTextStream>
+#include <QStringList>
+#include <QFile>
+#include <QMap>
+
+// libmyth* headers
+#include "exitcodes.h"
+#include "mythlogging.h"
+#include "programdata.h"
+#include "eitfixup.h"
+
+// local headers
+#include "eitutils.h"
+
+/// Most differences from the reference file that are printed.
+static const int kMaxDiffsShown = 10;
+
+static const struct
+{
+    uint        flag;
+    const char *name;
+} kFixupNames[] =
+{
+    { EITFixUp::kFixGenericDVB, "GenericDVB" },
+    { EITFixUp::kFixBell,       "Bell"       },
+    { EITFixUp::kFixUK,         "UK"         },
+    { EITFixUp::kFixPBS,        "PBS"        },
+    { EITFixUp::kFixComHem,     "ComHem"     },
+    { EITFixUp::kFixSubtitle,   "Subtitle"   },
+    { EITFixUp::kFixAUStar,     "AUStar"     },
+    { EITFixUp::kFixMCA,        "MCA"        },
+    { EITFixUp::kFixRTL,        "RTL"        },
+    { EITFixUp::kFixFI,         "FI"         },
+    { EITFixUp::kFixPremiere,   "Premiere"   },
+    { EITFixUp::kFixHDTV,       "HDTV"       },
+    { EITFixUp::kFixNL,         "NL"         },
+    { EITFixUp::kFixCategory,   "Category"   },
+    { EITFixUp::kFixNO,         "NO"         },
+    { EITFixUp::kFixNRK_DVBT,   "NRK_DVBT"   },
+    { EITFixUp::kFixDish,       "Dish"       },
+};
+
+typedef struct fixupprofile
+{
+    fixupprofile() : events(0), usecs(0) { }
+    uint    events;
+    int64_t usecs;
+} FixupProfile;
+
+static int64_t now_usecs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static QString fixup_name(uint fixup)
+{
+    QStringList names;
+    for (uint i = 0; i < sizeof(kFixupNames) / sizeof(kFixupNames[0]); i++)
+    {
+        if (fixup & kFixupNames[i].flag)
+            names.push_back(kFixupNames[i].name);
+    }
+    return (names.empty()) ? QString("None") : names.join("|");
+}
+
+static QString escape(QString str)
+{
+    return str.replace("\\", "\\\\").replace("\n", "\\n").replace("\t", "\\t");
+}
+
+/// One line with every field a fixup can change, for comparing runs.
+static QString format_event(const DBEventEIT &event)
+{
+    QStringList credits;
+    if (event.credits)
+    {
+        DBCredits::const_iterator it = event.credits->begin();
+        for (; it != event.credits->end(); ++it)
+            credits.push_back((*it).GetRole() + ":" + (*it).GetName());
+    }
+
+    QStringList fields;
+    fields << QString::number(event.chanid)
+           << event.starttime.toString(Qt::ISODate)
+           << escape(event.title) << escape(event.subtitle)
+           << escape(event.description) << escape(event.category)
+           << QString::number(event.categoryType)
+           << QString::number(event.airdate)
+           << event.originalairdate.toString(Qt::ISODate)
+           << QString::number(event.partnumber)
+           << QString::number(event.parttotal)
+           << escape(event.syndicatedepisodenumber)
+           << QString::number(event.subtitleType)
+           << QString::number(event.audioProps)
+           << QString::number(event.videoProps)
+           << QString::number(event.previouslyshown)
+           << escape(event.seriesId) << escape(event.programId)
+           << escape(credits.join(","));
+
+    return fields.join("\t");
+}
+
+/** \brief Replays EIT events dumped with MYTHTV_EIT_DUMP through the
+ *         fixups and prints the time taken by each fixup profile.
+ *
+ *   Each event is fixed up with the fixups it was received with. The
+ *   fixed up events can be written to --outfile, and compared against
+ *   an earlier --outfile given as --reffile, so that a change to the
+ *   fixups can be checked against a real capture.
+ */
+static int EITFixupBench(const MythUtilCommandLineParser &cmdline)
+{
+    QString infile  = cmdline.toString("infile");
+    QString outfile = cmdline.toString("outfile");
+    QString reffile = cmdline.toString("reffile");
+    int     passes  = max(cmdline.toInt("passes"), 1);
+
+    QFile file(infile);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Could not open '%1'").arg(infile));
+        return GENERIC_EXIT_NOT_OK;
+    }
+    QByteArray dump = file.readAll();
+    file.close();
+
+    EITFixUp fixup;
+    QMap<uint, FixupProfile> profiles;
+    QStringList results;
+
+    for (int p = 0; p < passes; p++)
+    {
+        QDataStream in(dump);
+        in.setVersion(QDataStream::Qt_4_6);
+
+        DBEventEIT *event;
+        while ((event = EITFixUp::ReadEvent(in)))
+        {
+            FixupProfile &profile = profiles[event->fixup];
+
+            int64_t start = now_usecs();
+            fixup.Fix(*event);
+            profile.usecs += now_usecs() - start;
+            profile.events++;
+
+            if (!p)
+                results.push_back(format_event(*event));
+            delete event;
+        }
+    }
+
+    if (results.empty())
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            QString("No EIT events could be read from '%1'").arg(infile));
+        return GENERIC_EXIT_NOT_OK;
+    }
+
+    int64_t total = 0;
+    QMap<uint, FixupProfile>::const_iterator it = profiles.begin();
+    for (; it != profiles.end(); ++it)
+    {
+        total += (*it).usecs;
+        cout << QString("%1: %2 events, %3 us per event")
+                    .arg(fixup_name(it.key())).arg((*it).events / passes)
+                    .arg((double)(*it).usecs / max((*it).events, 1U),
+                         0, 'f', 2)
+                    .toLocal8Bit().constData() << endl;
+    }
+    cout << QString("All: %1 events, %2 ms per pass")
+                .arg(results.size())
+                .arg(total / (passes * 1000.0), 0, 'f', 1)
+                .toLocal8Bit().constData() << endl;
+
+    if (!outfile.isEmpty())
+    {
+        QFile out(outfile);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            LOG(VB_GENERAL, LOG_ERR,
+                QString("Could not create '%1'").arg(outfile));
+            return GENERIC_EXIT_NOT_OK;
+        }
+        QTextStream os(&out);
+        os.setCodec("UTF-8");
+        for (int i = 0; i < results.size(); i++)
+            os << results[i] << "\n";
+    }
+
+    if (reffile.isEmpty())
+        return GENERIC_EXIT_OK;
+
+    QFile ref(reffile);
+    if (!ref.open(QIODevice::ReadOnly))
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Could not open '%1'").arg(reffile));
+        return GENERIC_EXIT_NOT_OK;
+    }
+    QTextStream is(&ref);
+    is.setCodec("UTF-8");
+    QStringList expected = is.readAll().split("\n", QString::SkipEmptyParts);
+
+    int diffs = abs(expected.size() - results.size());
+    int count = min(expected.size(), results.size());
+    for (int i = 0; i < count; i++)
+    {
+        if (expected[i] == results[i])
+            continue;
+        if (diffs++ < kMaxDiffsShown)
+        {
+            cout << QString("Event %1 differs\n  was: %2\n  now: %3")
+                        .arg(QString::number(i), expected[i], results[i])
+                        .toLocal8Bit().constData() << endl;
+        }
+    }
+
+    if (expected.size() != results.size())
+    {
+        cout << QString("%1 events in the reference file, %2 replayed")
+                    .arg(expected.size()).arg(results.size())
+                    .toLocal8Bit().constData() << endl;
+    }
+
+    cout << QString("%1 events differ from the reference file").arg(diffs)
+                .toLocal8Bit().constData() << endl;
+
+    return (diffs) ? GENERIC_EXIT_NOT_OK : GENERIC_EXIT_OK;
+}
+
+void registerEITUtils(UtilMap &utilMap)
+{
+    utilMap["eitfixupbench"]           = &EITFixupBench;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
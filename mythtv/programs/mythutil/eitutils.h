@@ -0,0 +1,3 @@
+#include "mythutil.h"
+
+void registerEITUtils(UtilMap &utilMap);
@@ -14,12 +14,15 @@
 // Local includes
 #include "mythutil.h"
 #include "commandlineparser.h"
+#include "audioutils.h"
 #include "backendutils.h"
+#include "eitutils.h"
 #include "fileutils.h"
 #include "mpegutils.h"
 #include "jobutils.h"
 #include "markuputils.h"
 #include "messageutils.h"
+#include "videoutils.h"
 
 
 int main(int argc, char *argv[])
@@ -86,12 +89,15 @@ int main(int argc, char *argv[])
 
     UtilMap utilMap;
 
+    registerAudioUtils(utilMap);
     registerBackendUtils(utilMap);
+    registerEITUtils(utilMap);
     registerFileUtils(utilMap);
     registerMPEGUtils(utilMap);
     registerJobUtils(utilMap);
     registerMarkupUtils(utilMap);
     registerMessageUtils(utilMap);
+    registerVideoUtils(utilMap);
 
     bool cmdFound = false;
     int cmdResult = GENERIC_EXIT_OK;
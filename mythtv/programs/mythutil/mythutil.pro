@@ -17,10 +17,12 @@ QMAKE_CLEAN += $(TARGET)
 
 # Input
 HEADERS += mythutil.h commandlineparser.h
-HEADERS += backendutils.h fileutils.h jobutils.h markuputils.h
-HEADERS += messageutils.h mpegutils.h
+HEADERS += audioutils.h backendutils.h eitutils.h fileutils.h jobutils.h
+HEADERS += markuputils.h
+HEADERS += messageutils.h mpegutils.h videoutils.h
 SOURCES += main.cpp mythutil.cpp commandlineparser.cpp
-SOURCES += backendutils.cpp fileutils.cpp jobutils.cpp markuputils.cpp
-SOURCES += messageutils.cpp mpegutils.cpp
+SOURCES += audioutils.cpp backendutils.cpp eitutils.cpp fileutils.cpp
+SOURCES += jobutils.cpp markuputils.cpp
+SOURCES += messageutils.cpp mpegutils.cpp videoutils.cpp
 
 mingw: LIBS += -lwinmm -lws2_32
@@ -0,0 +1,444 @@
+// C++ headers
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+using namespace std;
+
+// Qt headers
+#include <QPainter>
+#include <QThread>
+#include <QVector>
+#include <QImage>
+#include <QFile>
+
+// libmyth* headers
+#include "exitcodes.h"
+#include "mythlogging.h"
+#include "mythtimer.h"
+#include "filtermanager.h"
+#include "mythpainter_yuva.h"
+#include "util-osd.h"
+#include "myth_imgconvert.h"
+
+// local headers
+#include "videoutils.h"
+
+/// Most frames loaded into memory for a benchmark run.
+static const int kMaxBenchFrames = 100;
+
+static FilterChain *LoadBenchChain(FilterManager &manager,
+                                   const QString &filters,
+                                   int width, int height, int threads)
+{
+    VideoFrameType inpixfmt  = FMT_YV12;
+    VideoFrameType outpixfmt = FMT_YV12;
+    int bufsize = 0;
+
+    FilterChain *chain = manager.LoadFilters(
+        filters, inpixfmt, outpixfmt, width, height, bufsize, threads);
+    if (!chain)
+        LOG(VB_GENERAL, LOG_ERR, QString("Could not load filters '%1'")
+                .arg(filters));
+    return chain;
+}
+
+/** \brief Runs the frames through the filters once with the C kernels
+ *         and once with the SIMD kernels and prints how much they differ.
+ *
+ *   The C kernels are forced by setting NO_FILTER_SIMD while the first
+ *   chain is loaded, see filters/mm_arch.h.
+ */
+static int CompareFilterKernels(const QString &filters,
+                                const QList<QByteArray> &frames,
+                                int width, int height, int frame_size)
+{
+    FilterManager manager;
+
+    qputenv("NO_FILTER_SIMD", "1");
+    FilterChain *ref = LoadBenchChain(manager, filters, width, height, 1);
+    qputenv("NO_FILTER_SIMD", "");
+    FilterChain *simd = LoadBenchChain(manager, filters, width, height, 1);
+
+    if (!ref || !simd)
+    {
+        delete ref;
+        delete simd;
+        return GENERIC_EXIT_NOT_OK;
+    }
+
+    unsigned char *refbuf  = new unsigned char[frame_size + 64];
+    unsigned char *simdbuf = new unsigned char[frame_size + 64];
+    VideoFrame refframe, simdframe;
+    init(&refframe,  FMT_YV12, refbuf,  width, height, frame_size);
+    init(&simdframe, FMT_YV12, simdbuf, width, height, frame_size);
+
+    uint64_t differ  = 0;
+    int      maxdiff = 0;
+    int      frames_differ = 0;
+
+    for (int i = 0; i < frames.size(); i++)
+    {
+        memcpy(refbuf,  frames[i].constData(), frame_size);
+        memcpy(simdbuf, frames[i].constData(), frame_size);
+        refframe.frameNumber = simdframe.frameNumber = i;
+
+        ref->ProcessFrame(&refframe, kScan_Interlaced);
+        simd->ProcessFrame(&simdframe, kScan_Interlaced);
+
+        uint64_t before = differ;
+        for (int j = 0; j < frame_size; j++)
+        {
+            int diff = abs((int)refbuf[j] - (int)simdbuf[j]);
+            if (diff)
+            {
+                differ++;
+                maxdiff = max(maxdiff, diff);
+            }
+        }
+        if (differ != before)
+            frames_differ++;
+    }
+
+    cout << QString("C and SIMD kernels: %1 of %2 frames differ, "
+                    "%3 bytes differ, largest difference %4")
+                .arg(frames_differ).arg(frames.size())
+                .arg(differ).arg(maxdiff)
+                .toLocal8Bit().constData() << endl;
+
+    delete ref;
+    delete simd;
+    delete[] refbuf;
+    delete[] simdbuf;
+
+    return GENERIC_EXIT_OK;
+}
+
+/** \brief Runs a video filter chain over raw YV12 frames at one to N
+ *         threads and prints the frame rate at each thread count.
+ *
+ *   The input can be captured with something like
+ *   "ffmpeg -i rec.ts -vframes 100 -pix_fmt yuv420p -f rawvideo out.yuv".
+ *   With --compare the output of the C and SIMD filter kernels is
+ *   compared first.
+ */
+static int FilterBench(const MythUtilCommandLineParser &cmdline)
+{
+    QString filters = cmdline.toString("filterbench");
+    QString infile  = cmdline.toString("infile");
+    int width   = cmdline.toInt("width");
+    int height  = cmdline.toInt("height");
+    int threads = cmdline.toInt("threads");
+    int passes  = max(cmdline.toInt("passes"), 1);
+
+    if (infile.isEmpty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, "Missing --infile option");
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
+
+    if ((width <= 0) || (height <= 0) || (width & 1) || (height & 1))
+    {
+        LOG(VB_GENERAL, LOG_ERR, "Invalid frame size, --width and --height "
+                                 "must be positive and even");
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
+
+    if (threads <= 0)
+        threads = max(QThread::idealThreadCount(), 1);
+
+    QFile file(infile);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("Could not open '%1'").arg(infile));
+        return GENERIC_EXIT_NOT_OK;
+    }
+
+    int frame_size = width * height * 3 / 2;
+    QList<QByteArray> frames;
+    while (frames.size() < kMaxBenchFrames)
+    {
+        QByteArray frame = file.read(frame_size);
+        if (frame.size() < frame_size)
+            break;
+        frames.push_back(frame);
+    }
+    file.close();
+
+    if (frames.empty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("'%1' does not contain a whole "
+                                         "%2x%3 YV12 frame")
+                .arg(infile).arg(width).arg(height));
+        return GENERIC_EXIT_NOT_OK;
+    }
+
+    cout << "Filters: " << filters.toLocal8Bit().constData()
+         << ", " << frames.size() << " frames of "
+         << width << "x" << height << endl;
+
+    int result = GENERIC_EXIT_OK;
+    if (cmdline.toBool("compare"))
+    {
+        result = CompareFilterKernels(filters, frames, width, height,
+                                      frame_size);
+        if (result != GENERIC_EXIT_OK)
+            return result;
+    }
+
+    unsigned char *buf = new unsigned char[frame_size + 64];
+    FilterManager manager;
+
+    for (int t = 1; t <= threads; t++)
+    {
+        FilterChain *chain = LoadBenchChain(manager, filters,
+                                            width, height, t);
+        if (!chain)
+        {
+            result = GENERIC_EXIT_NOT_OK;
+            break;
+        }
+
+        VideoFrame frame;
+        init(&frame, FMT_YV12, buf, width, height, frame_size);
+
+        MythTimer timer;
+        uint64_t count = 0;
+        int elapsed = 0;
+
+        timer.start();
+        for (int p = 0; p < passes; p++)
+        {
+            for (int i = 0; i < frames.size(); i++)
+            {
+                // Copying the frame in is part of every run, so it
+                // doesn't change the comparison between thread counts.
+                memcpy(buf, frames[i].constData(), frame_size);
+                frame.frameNumber = count;
+                chain->ProcessFrame(&frame, kScan_Interlaced);
+                chain->ProcessFrame(&frame, kScan_Intr2ndField);
+                count++;
+            }
+        }
+        elapsed = max(timer.elapsed(), 1);
+
+        cout << QString("%1 thread(s): %2 frames in %3 ms, "
+                        "%4 ms per frame, %5 fps")
+                    .arg(t, 2).arg(count).arg(elapsed)
+                    .arg((double)elapsed / count, 0, 'f', 2)
+                    .arg(count * 1000.0 / elapsed, 0, 'f', 1)
+                    .toLocal8Bit().constData() << endl;
+
+        delete chain;
+    }
+
+    delete[] buf;
+
+    return result;
+}
+
+static int TimeOSDBlend(VideoFrame *frame, MythImage *osd,
+                        const QVector<QRect> &rects, int count)
+{
+    MythTimer timer;
+    timer.start();
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < rects.size(); j++)
+        {
+            yuv888_to_yv12(frame, osd, rects[j].left(), rects[j].top(),
+                           rects[j].left() + rects[j].width(),
+                           rects[j].top() + rects[j].height());
+        }
+    }
+    return max(timer.elapsed(), 1);
+}
+
+/** \brief Times blending a typical playback OSD onto YV12 frames.
+ *
+ *   The OSD is a translucent progress bar and a line of subtitles in a
+ *   full width subtitle area, drawn without text so that no fonts are
+ *   needed. It is blended once over the whole visible rectangles, as
+ *   VideoOutput::DisplayOSD() used to, and once over only the parts of
+ *   them with anything in, as it does now.
+ */
+static int OSDBench(const MythUtilCommandLineParser &cmdline)
+{
+    int width  = cmdline.toInt("width");
+    int height = cmdline.toInt("height");
+    int count  = max(cmdline.toInt("passes"), 1) * kMaxBenchFrames;
+
+    if ((width < 640) || (height < 360) || (width & 15) || (height & 1))
+    {
+        LOG(VB_GENERAL, LOG_ERR, "Invalid frame size, --width must be a "
+                                 "multiple of 16 of at least 640 and "
+                                 "--height even and at least 360");
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(0);
+
+    QRect progress(width / 12, height / 27, width * 5 / 6, height / 9);
+    QRect subtitles(0, height * 5 / 6, width, height / 8);
+    {
+        QPainter painter(&image);
+        painter.fillRect(progress.adjusted(8, 8, -8, -8),
+                         QColor(0, 0, 64, 160));
+        painter.fillRect(progress.adjusted(24, progress.height() / 2,
+                                           -width / 3, -12),
+                         QColor(255, 255, 255));
+        // Something like two lines of subtitles, a block per glyph
+        int line = subtitles.height() / 3;
+        for (int row = 0; row < 2; row++)
+        {
+            int y = subtitles.top() + line / 4 + row * (line + line / 4);
+            for (int x = width / 4; x < width * 3 / 4; x += line / 2)
+                painter.fillRect(x, y, line * 3 / 8, line, Qt::white);
+        }
+    }
+
+    MythYUVAPainter painter;
+    MythImage *osd = painter.GetFormatImage();
+    osd->Assign(image);
+    osd->ConvertToYUV();
+
+    QVector<QRect> full, opaque;
+    full << progress << subtitles;
+    for (int i = 0; i < full.size(); i++)
+    {
+        QRect rect = yuv888_opaque_rect(osd, full[i], ALIGN_X_MMX, ALIGN_C);
+        if (!rect.isEmpty())
+            opaque << rect;
+    }
+
+    int frame_size = width * height * 3 / 2;
+    unsigned char *buf = new unsigned char[frame_size + 64];
+    memset(buf, 128, frame_size);
+    VideoFrame frame;
+    init(&frame, FMT_YV12, buf, width, height, frame_size);
+
+    int full_ms   = TimeOSDBlend(&frame, osd, full, count);
+    int opaque_ms = TimeOSDBlend(&frame, osd, opaque, count);
+
+    cout << QString("OSD blend, %1x%2, %3 frames").arg(width).arg(height)
+                .arg(count).toLocal8Bit().constData() << endl;
+    cout << QString("whole rectangles:  %1 ms per frame")
+                .arg((double)full_ms / count, 0, 'f', 3)
+                .toLocal8Bit().constData() << endl;
+    cout << QString("opaque rectangles: %1 ms per frame")
+                .arg((double)opaque_ms / count, 0, 'f', 3)
+                .toLocal8Bit().constData() << endl;
+
+    osd->DownRef();
+    delete[] buf;
+
+    return GENERIC_EXIT_OK;
+}
+
+typedef struct imgconvbenchcase
+{
+    const char  *name;
+    PixelFormat  src;
+    PixelFormat  dst;
+} ImgConvBenchCase;
+
+/// The conversions the software video paths do. YV12 and I420 are the
+/// same planes in a different order, so converting between them is a
+/// YUV420P copy with the chroma planes swapped.
+static const ImgConvBenchCase kImgConvCases[] =
+{
+    { "YV12 -> I420  ", PIX_FMT_YUV420P, PIX_FMT_YUV420P },
+    { "I420 -> RGB32 ", PIX_FMT_YUV420P, PIX_FMT_RGB32   },
+    { "RGB32 -> I420 ", PIX_FMT_RGB32,   PIX_FMT_YUV420P },
+    { "I420 -> NV12  ", PIX_FMT_YUV420P, PIX_FMT_NV12    },
+    { "NV12 -> I420  ", PIX_FMT_NV12,    PIX_FMT_YUV420P },
+};
+
+static const int kImgConvSizes[][2] =
+{
+    { 720, 576 }, { 1280, 720 }, { 1920, 1080 },
+};
+
+static double TimeImgConv(AVPicture *dst, PixelFormat dst_fmt,
+                          AVPicture *src, PixelFormat src_fmt,
+                          int width, int height, int threads, int count)
+{
+    // The first conversion sets up the scaler contexts
+    myth_sws_img_scale(dst, dst_fmt, width, height,
+                       src, src_fmt, width, height, threads);
+
+    MythTimer timer;
+    timer.start();
+    for (int i = 0; i < count; i++)
+    {
+        myth_sws_img_scale(dst, dst_fmt, width, height,
+                           src, src_fmt, width, height, threads);
+    }
+    return (double)max(timer.elapsed(), 1) / count;
+}
+
+/** \brief Times the common pixel format conversions at SD, 720p and
+ *         1080p on one thread and on as many as myth_sws_img_scale()
+ *         uses.
+ */
+static int ImgConvBench(const MythUtilCommandLineParser &cmdline)
+{
+    int count = max(cmdline.toInt("passes"), 1) * kMaxBenchFrames;
+
+    cout << QString("Pixel format conversion, %1 frames, "
+                    "ms per frame on 1 / all threads").arg(count)
+                .toLocal8Bit().constData() << endl;
+
+    for (uint s = 0; s < sizeof(kImgConvSizes) / sizeof(kImgConvSizes[0]); s++)
+    {
+        int width  = kImgConvSizes[s][0];
+        int height = kImgConvSizes[s][1];
+
+        // Room for the largest format, RGB32
+        int size = width * height * 4;
+        unsigned char *srcbuf = new unsigned char[size + 64];
+        unsigned char *dstbuf = new unsigned char[size + 64];
+        memset(srcbuf, 128, size);
+        memset(dstbuf, 0, size);
+
+        for (uint c = 0; c < sizeof(kImgConvCases) / sizeof(ImgConvBenchCase);
+             c++)
+        {
+            const ImgConvBenchCase &conv = kImgConvCases[c];
+            AVPicture src, dst;
+            avpicture_fill(&src, srcbuf, conv.src, width, height);
+            avpicture_fill(&dst, dstbuf, conv.dst, width, height);
+            if (c == 0)
+            {
+                // I420 has U before V, YV12 V before U
+                swap(dst.data[1], dst.data[2]);
+                swap(dst.linesize[1], dst.linesize[2]);
+            }
+
+            double single = TimeImgConv(&dst, conv.dst, &src, conv.src,
+                                        width, height, 1, count);
+            double sliced = TimeImgConv(&dst, conv.dst, &src, conv.src,
+                                        width, height, 0, count);
+
+            cout << QString("%1x%2 %3 %4 / %5 ms")
+                        .arg(width, 4).arg(height, -4).arg(conv.name)
+                        .arg(single, 6, 'f', 3).arg(sliced, 6, 'f', 3)
+                        .toLocal8Bit().constData() << endl;
+        }
+
+        delete[] srcbuf;
+        delete[] dstbuf;
+    }
+
+    return GENERIC_EXIT_OK;
+}
+
+void registerVideoUtils(UtilMap &utilMap)
+{
+    utilMap["filterbench"]             = &FilterBench;
+    utilMap["osdbench"]                = &OSDBench;
+    utilMap["imgconvbench"]            = &ImgConvBench;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
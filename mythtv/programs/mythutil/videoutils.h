@@ -0,0 +1,4 @@
+#include "mythutil.h"
+
+void registerVideoUtils(UtilMap &utilMap);
+